@@ -1,4 +1,5 @@
 #include <glad/glad.h>
+#include <app_context.hpp>
 #include <GLFW/glfw3.h>
 #include <iostream>
 using namespace std;
@@ -18,51 +19,42 @@ void frameBufferSizeCallback(GLFWwindow* window, int width, int height)
 #if defined(WIN32)
 int WinMain(HINSTANCE /*hInst*/, HINSTANCE /*hPrevInst*/, LPSTR /*lpCmdLine*/, int /*nCmdShow*/)
 #else
-int main()
+int main(int argc, char** argv)
 #endif
+try
 {
-	glfwInit();
-
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 0);
-	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-
-	auto window = glfwCreateWindow(800, 600, "Hello Window", nullptr, nullptr);
-	
-	if (!window)
-	{
-		const char* error;
-		glfwGetError(&error);
-		cerr << "Unable to open the window: " << error << endl;
-		glfwTerminate();
-
-		return 1;
-	}
-
-	glfwSetFramebufferSizeCallback(window, frameBufferSizeCallback);
-	glfwSetKeyCallback(window, keyCallback);
+#if defined(WIN32)
+	glsl::CommandLine commandLine;
+	const auto argc = commandLine.argc();
+	const auto argv = commandLine.argv();
+#endif
 
-	glfwMakeContextCurrent(window);
+	glsl::AppContext context{ glsl::ContextOptions::fromCommandLine(argc, argv, { 800, 600, "Hello Window", 4, 0 }) };
+	auto window = context.window();
 
-	if (!gladLoadGLLoader(reinterpret_cast<GLADloadproc>(glfwGetProcAddress)))
+	if (window)
 	{
-		cerr << "Failed to initialize GLAD" << std::endl;
-		return -1;
+		glfwSetFramebufferSizeCallback(window, frameBufferSizeCallback);
+		glfwSetKeyCallback(window, keyCallback);
 	}
 
 	glClearColor(1.0f, 0.0f, 0.0f, 0.0f);
 
 
-	while (!glfwWindowShouldClose(window))
+	while (context.running())
 	{
-		glfwPollEvents();
+		context.pollEvents();
 
 		glClear(GL_COLOR_BUFFER_BIT);
 
-		glfwSwapBuffers(window);		
+		context.swapBuffers();		
 	}
 
-	glfwDestroyWindow(window);
-	glfwTerminate();
 	return 0;
+}
+catch (const exception& e)
+{
+	// the context has been destroyed by now; headless runs see a failed exit
+	cerr << e.what() << endl;
+	return 1;
 }
\ No newline at end of file
@@ -1,5 +1,7 @@
 #include <glsl.hpp>
 #include <glm/glm.hpp>
+#include <app_context.hpp>
+#include <gl_objects.hpp>
 #include <GLFW/glfw3.h>
 #include <iostream>
 #include <array>
@@ -19,36 +21,23 @@ void frameBufferSizeCallback(GLFWwindow* window, int width, int height)
 #if defined(WIN32)
 int WinMain(HINSTANCE /*hInst*/, HINSTANCE /*hPrevInst*/, LPSTR lpCmdLine, int nCmdShow)
 #else
-int main()
+int main(int argc, char** argv)
 #endif
+try
 {
-	glfwInit();
-
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 4);
-	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-
-	auto window = glfwCreateWindow(800, 600, "2.4.1 Hello Triangle", nullptr, nullptr);
-
-	if (!window)
-	{
-		const char* error;
-		glfwGetError(&error);
-		cerr << "Unable to open the window: " << error << endl;
-		glfwTerminate();
-
-		return 1;
-	}
-
-	glfwSetFramebufferSizeCallback(window, frameBufferSizeCallback);
-	glfwSetKeyCallback(window, keyCallback);
+#if defined(WIN32)
+	glsl::CommandLine commandLine;
+	const auto argc = commandLine.argc();
+	const auto argv = commandLine.argv();
+#endif
 
-	glfwMakeContextCurrent(window);
+	glsl::AppContext context{ glsl::ContextOptions::fromCommandLine(argc, argv, { 800, 600, "2.4.1 Hello Triangle", 4, 4 }) };
+	auto window = context.window();
 
-	if (!gladLoadGLLoader(reinterpret_cast<GLADloadproc>(glfwGetProcAddress)))
+	if (window)
 	{
-		cerr << "Failed to initialize GLAD" << std::endl;
-		return -1;
+		glfwSetFramebufferSizeCallback(window, frameBufferSizeCallback);
+		glfwSetKeyCallback(window, keyCallback);
 	}
 
 	glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
@@ -59,17 +48,12 @@ int main()
 		glm::vec3{ 0.0f,  0.5f, 0.0f}
 	};
 
-	GLuint vbo;
-	glGenBuffers(1, &vbo);
-	glBindBuffer(GL_ARRAY_BUFFER, vbo);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices.data(), GL_STATIC_DRAW);
+	glsl::Buffer vbo{ vertices };
 
-	GLuint vao;
-	glGenVertexArrays(1, &vao);
-	glBindVertexArray(vao);
-	glBindBuffer(GL_ARRAY_BUFFER, vbo);
-	glVertexAttribPointer(0, 3, GL_FLOAT, false, 3 * sizeof(GLfloat), nullptr);
-	glEnableVertexAttribArray(0);
+	glsl::VertexArray vao;
+	vao.vertexBuffer(0, vbo, 0, sizeof(glm::vec3));
+	vao.attribute(0, 0, 3, GL_FLOAT);
+	vao.bind();
 
 	glsl::Program prog{
 		{ glsl::vertex_shader  , "resources/shaders/2.4.1_hello_triangle.vs"s },
@@ -78,18 +62,22 @@ int main()
 
 	prog.use();
 
-	while (!glfwWindowShouldClose(window))
+	while (context.running())
 	{
-		glfwPollEvents();
+		context.pollEvents();
 
 		glClear(GL_COLOR_BUFFER_BIT);
 
 		glDrawArrays(GL_TRIANGLES, 0, 3);
 
-		glfwSwapBuffers(window);		
+		context.swapBuffers();		
 	}
 
-	glfwDestroyWindow(window);
-	glfwTerminate();
 	return 0;
+}
+catch (const exception& e)
+{
+	// the context has been destroyed by now; headless runs see a failed exit
+	cerr << e.what() << endl;
+	return 1;
 }
\ No newline at end of file
@@ -1,5 +1,7 @@
 #include <glsl.hpp>
 #include <glm/glm.hpp>
+#include <app_context.hpp>
+#include <gl_objects.hpp>
 #include <GLFW/glfw3.h>
 #include <iostream>
 #include <array>
@@ -21,7 +23,7 @@ void keyCallback(GLFWwindow* window, int key, int, int action, int)
 
 		wireframe = !wireframe;
 
-		glPolygonMode(GL_FRONT_AND_BACK, wireframe ? GL_LINE : GL_FILL);
+		glsl::GLState::current().polygonMode(wireframe ? GL_LINE : GL_FILL);
 		
 	default:
 		break;
@@ -36,39 +38,25 @@ void frameBufferSizeCallback(GLFWwindow* window, int width, int height)
 #if defined(WIN32)
 int wWinMain(HINSTANCE /*hInst*/, HINSTANCE /*hPrevInst*/, LPWSTR /*lpCmdLine*/, int /*nCmdShow*/)
 #else
-int main()
+int main(int argc, char** argv)
 #endif
+try
 {
-	glfwInit();
-
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 4);
-	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-
-	auto window = glfwCreateWindow(800, 600, "2.4.2 Hello Triangle", nullptr, nullptr);
-
-	if (!window)
-	{
-		const char* error;
-		glfwGetError(&error);
-		cerr << "Unable to open the window: " << error << endl;
-		glfwTerminate();
-
-		return 1;
-	}
-
-	glfwSetFramebufferSizeCallback(window, frameBufferSizeCallback);
-	glfwSetKeyCallback(window, keyCallback);
+#if defined(WIN32)
+	glsl::CommandLine commandLine;
+	const auto argc = commandLine.argc();
+	const auto argv = commandLine.argv();
+#endif
 
-	glfwMakeContextCurrent(window);
+	glsl::AppContext context{ glsl::ContextOptions::fromCommandLine(argc, argv, { 800, 600, "2.4.2 Hello Triangle", 4, 4 }) };
+	auto window = context.window();
 
-	if (!gladLoadGLLoader(reinterpret_cast<GLADloadproc>(glfwGetProcAddress)))
+	if (window)
 	{
-		cerr << "Failed to initialize GLAD" << std::endl;
-		return -1;
+		glfwSetFramebufferSizeCallback(window, frameBufferSizeCallback);
+		glfwSetKeyCallback(window, keyCallback);
 	}
 
-	glfwSwapInterval(1);
 	glClearColor(0.2f, 0.3f, 3.0f, 0.0f);
 ;
 
@@ -84,50 +72,37 @@ int main()
 		glm::vec3{ 0.0f, 0.0f, 1.0f },  // blue
 	};
 
-	GLuint pos_vbo;
-	glGenBuffers(1, &pos_vbo);
-	glBindBuffer(GL_ARRAY_BUFFER, pos_vbo);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices.data(), GL_STATIC_DRAW);
-
-	GLuint col_vbo;
-	glGenBuffers(1, &col_vbo);
-	glBindBuffer(GL_ARRAY_BUFFER, col_vbo);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(colors), colors.data(), GL_STATIC_DRAW);
-
-	GLuint vao;
-	glGenVertexArrays(1, &vao);
-	glBindVertexArray(vao);
-
-	glBindBuffer(GL_ARRAY_BUFFER, pos_vbo);
-	glVertexAttribPointer(0, 3, GL_FLOAT, false, 3 * sizeof(GLfloat), nullptr);
-
-	glBindBuffer(GL_ARRAY_BUFFER, col_vbo);
-	glVertexAttribPointer(1, 3, GL_FLOAT, false, 3 * sizeof(GLfloat), nullptr);
-	
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-	
+	glsl::Buffer posVbo{ vertices };
+	glsl::Buffer colVbo{ colors };
+
+	glsl::VertexArray vao;
+	vao.vertexBuffer(0, posVbo, 0, sizeof(glm::vec3));
+	vao.vertexBuffer(1, colVbo, 0, sizeof(glm::vec3));
+	vao.attribute(0, 0, 3, GL_FLOAT);
+	vao.attribute(1, 1, 3, GL_FLOAT);
+	vao.bind();
+
 	glsl::Program prog{
 		{ glsl::vertex_shader  , "resources/shaders/2.4.2_hello_triangle.vs"s },
 		{ glsl::fragment_shader, "resources/shaders/2.4.2_hello_triangle.fs"s }
 	};
 	prog.use();
 
-	while (!glfwWindowShouldClose(window))
+	while (context.running())
 	{
-		glfwPollEvents();
+		context.pollEvents();
 
 		glClear(GL_COLOR_BUFFER_BIT);
 		glDrawArrays(GL_TRIANGLES, 0, (GLsizei)vertices.size());
 
-		glfwSwapBuffers(window);		
+		context.swapBuffers();		
 	}
 
-	glDeleteBuffers(1, &pos_vbo);
-	glDeleteBuffers(1, &col_vbo);
-	glDeleteVertexArrays(1, &vao);
-
-	glfwDestroyWindow(window);
-	glfwTerminate();
 	return 0;
+}
+catch (const exception& e)
+{
+	// the context has been destroyed by now; headless runs see a failed exit
+	cerr << e.what() << endl;
+	return 1;
 }
\ No newline at end of file
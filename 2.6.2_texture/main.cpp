@@ -1,6 +1,9 @@
 #include <stb_image.h>
 #include <glsl.hpp>
+#include <cpu_profiler.hpp>
 #include <glm/glm.hpp>
+#include <app_context.hpp>
+#include <gl_objects.hpp>
 #include <GLFW/glfw3.h>
 #include <iostream>
 #include <array>
@@ -22,7 +25,7 @@ void keyCallback(GLFWwindow* window, int key, int, int action, int)
 
 		wireframe = !wireframe;
 
-		glPolygonMode(GL_FRONT_AND_BACK, wireframe ? GL_LINE : GL_FILL);
+		glsl::GLState::current().polygonMode(wireframe ? GL_LINE : GL_FILL);
 		
 	default:
 		break;
@@ -37,39 +40,25 @@ void frameBufferSizeCallback(GLFWwindow* window, int width, int height)
 #if defined(WIN32)
 int wWinMain(HINSTANCE /*hInst*/, HINSTANCE /*hPrevInst*/, LPWSTR /*lpCmdLine*/, int /*nCmdShow*/)
 #else
-int main()
+int main(int argc, char** argv)
 #endif
+try
 {
-	glfwInit();
-
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 4);
-	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-
-	auto window = glfwCreateWindow(800, 600, "2.6.2 Texture", nullptr, nullptr);
-
-	if (!window)
-	{
-		const char* error;
-		glfwGetError(&error);
-		cerr << "Unable to open the window: " << error << endl;
-		glfwTerminate();
-
-		return 1;
-	}
-
-	glfwSetFramebufferSizeCallback(window, frameBufferSizeCallback);
-	glfwSetKeyCallback(window, keyCallback);
+#if defined(WIN32)
+	glsl::CommandLine commandLine;
+	const auto argc = commandLine.argc();
+	const auto argv = commandLine.argv();
+#endif
 
-	glfwMakeContextCurrent(window);
+	glsl::AppContext context{ glsl::ContextOptions::fromCommandLine(argc, argv, { 800, 600, "2.6.2 Texture", 4, 4 }) };
+	auto window = context.window();
 
-	if (!gladLoadGLLoader(reinterpret_cast<GLADloadproc>(glfwGetProcAddress)))
+	if (window)
 	{
-		cerr << "Failed to initialize GLAD" << std::endl;
-		return -1;
+		glfwSetFramebufferSizeCallback(window, frameBufferSizeCallback);
+		glfwSetKeyCallback(window, keyCallback);
 	}
 
-	glfwSwapInterval(1);
 	glClearColor(0.2f, 0.3f, 3.0f, 0.0f);
 ;
 	array<glm::vec3, 4> vertices = {
@@ -95,65 +84,39 @@ int main()
 
 	array<GLuint, 6> indexes{ 0, 1, 2, 2, 3, 0 };
 
-	GLuint idx_ebo;
-	glGenBuffers(1, &idx_ebo);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, idx_ebo);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indexes), indexes.data(), GL_STATIC_DRAW);
-
-	GLuint pos_vbo;
-	glGenBuffers(1, &pos_vbo);
-	glBindBuffer(GL_ARRAY_BUFFER, pos_vbo);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices.data(), GL_STATIC_DRAW);
-
-	GLuint col_vbo;
-	glGenBuffers(1, &col_vbo);
-	glBindBuffer(GL_ARRAY_BUFFER, col_vbo);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(colors), colors.data(), GL_STATIC_DRAW);
-
-	GLuint tex_vbo;
-	glGenBuffers(1, &tex_vbo);
-	glBindBuffer(GL_ARRAY_BUFFER, tex_vbo);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(texCoords), texCoords.data(), GL_STATIC_DRAW);
-
-	GLuint vao;
-	glGenVertexArrays(1, &vao);
-	glBindVertexArray(vao);
-
-	glBindBuffer(GL_ARRAY_BUFFER, pos_vbo);
-	glVertexAttribPointer(0, 3, GL_FLOAT, false, 3 * sizeof(GLfloat), nullptr);
-
-	glBindBuffer(GL_ARRAY_BUFFER, col_vbo);
-	glVertexAttribPointer(1, 3, GL_FLOAT, false, 3 * sizeof(GLfloat), nullptr);
-
-	glBindBuffer(GL_ARRAY_BUFFER, tex_vbo);
-	glVertexAttribPointer(2, 3, GL_FLOAT, false, 2 * sizeof(GLfloat), nullptr);
-
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, idx_ebo);
-
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-	glEnableVertexAttribArray(2);
+	glsl::Buffer ebo{ indexes };
+	glsl::Buffer posVbo{ vertices };
+	glsl::Buffer colVbo{ colors };
+	glsl::Buffer texVbo{ texCoords };
+
+	glsl::VertexArray vao;
+	vao.vertexBuffer(0, posVbo, 0, sizeof(glm::vec3));
+	vao.vertexBuffer(1, colVbo, 0, sizeof(glm::vec3));
+	vao.vertexBuffer(2, texVbo, 0, sizeof(glm::vec2));
+	vao.attribute(0, 0, 3, GL_FLOAT);
+	vao.attribute(1, 1, 3, GL_FLOAT);
+	vao.attribute(2, 2, 2, GL_FLOAT);
+	vao.elementBuffer(ebo);
+	vao.bind();
 
 	int width, height, channels;
-	auto imageData = stbi_load("resources/textures/wall.jpeg", &width, &height, &channels, 0);
-
-	GLuint texture;
-	glGenTextures(1, &texture);
-	glBindTexture(GL_TEXTURE_2D, texture);
-	glActiveTexture(GL_TEXTURE0);
+	auto imageData = COMMON_PROFILE_CALL("stbi_load", stbi_load("resources/textures/wall.jpeg", &width, &height, &channels, 0));
 
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glsl::Texture texture;
+	texture.parameter(GL_TEXTURE_WRAP_S, GL_REPEAT);
+	texture.parameter(GL_TEXTURE_WRAP_T, GL_REPEAT);
+	texture.parameter(GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	texture.parameter(GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
 	if (imageData)
 	{
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, imageData);
-		glGenerateMipmap(GL_TEXTURE_2D);
+		texture.storage2D(glsl::mipLevels(width, height), GL_RGB8, width, height);
+		texture.subImage2D(0, 0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, imageData);
+		texture.generateMipmap();
 	}
 
 	stbi_image_free(imageData);
+	texture.bind(0);
 	
 	glsl::Program prog{
 		{ glsl::vertex_shader  , "resources/shaders/2.6.2_texture.vs"s },
@@ -161,23 +124,23 @@ int main()
 	};
 	
 	prog.use();
-	prog.uniform("texSample"s, 0);
+	prog.uniform("texSample", 0);
 
-	while (!glfwWindowShouldClose(window))
+	while (context.running())
 	{
-		glfwPollEvents();
+		context.pollEvents();
 
 		glClear(GL_COLOR_BUFFER_BIT);
 		glDrawElements(GL_TRIANGLES, (GLuint)indexes.size(), GL_UNSIGNED_INT, nullptr);
 
-		glfwSwapBuffers(window);		
+		context.swapBuffers();		
 	}
 
-	glDeleteBuffers(1, &pos_vbo);
-	glDeleteBuffers(1, &col_vbo);
-	glDeleteVertexArrays(1, &vao);
-
-	glfwDestroyWindow(window);
-	glfwTerminate();
 	return 0;
+}
+catch (const exception& e)
+{
+	// the context has been destroyed by now; headless runs see a failed exit
+	cerr << e.what() << endl;
+	return 1;
 }
\ No newline at end of file
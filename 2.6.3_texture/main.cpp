@@ -1,6 +1,9 @@
 #include "stb_image.h"
 #include <glsl.hpp>
+#include <cpu_profiler.hpp>
 #include <glm/glm.hpp>
+#include <app_context.hpp>
+#include <gl_objects.hpp>
 #include <GLFW/glfw3.h>
 #include <iostream>
 #include <array>
@@ -22,7 +25,7 @@ void keyCallback(GLFWwindow* window, int key, int, int action, int)
 
 		wireframe = !wireframe;
 
-		glPolygonMode(GL_FRONT_AND_BACK, wireframe ? GL_LINE : GL_FILL);
+		glsl::GLState::current().polygonMode(wireframe ? GL_LINE : GL_FILL);
 		
 	default:
 		break;
@@ -37,39 +40,25 @@ void frameBufferSizeCallback(GLFWwindow* window, int width, int height)
 #if defined(WIN32)
 int wWinMain(HINSTANCE /*hInst*/, HINSTANCE /*hPrevInst*/, LPWSTR /*lpCmdLine*/, int /*nCmdShow*/)
 #else
-int main()
+int main(int argc, char** argv)
 #endif
+try
 {
-	glfwInit();
-
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 4);
-	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-
-	auto window = glfwCreateWindow(800, 600, "2.6.3 Texture", nullptr, nullptr);
-
-	if (!window)
-	{
-		const char* error;
-		glfwGetError(&error);
-		cerr << "Unable to open the window: " << error << endl;
-		glfwTerminate();
-
-		return 1;
-	}
-
-	glfwSetFramebufferSizeCallback(window, frameBufferSizeCallback);
-	glfwSetKeyCallback(window, keyCallback);
+#if defined(WIN32)
+	glsl::CommandLine commandLine;
+	const auto argc = commandLine.argc();
+	const auto argv = commandLine.argv();
+#endif
 
-	glfwMakeContextCurrent(window);
+	glsl::AppContext context{ glsl::ContextOptions::fromCommandLine(argc, argv, { 800, 600, "2.6.3 Texture", 4, 4 }) };
+	auto window = context.window();
 
-	if (!gladLoadGLLoader(reinterpret_cast<GLADloadproc>(glfwGetProcAddress)))
+	if (window)
 	{
-		cerr << "Failed to initialize GLAD" << std::endl;
-		return -1;
+		glfwSetFramebufferSizeCallback(window, frameBufferSizeCallback);
+		glfwSetKeyCallback(window, keyCallback);
 	}
 
-	glfwSwapInterval(1);
 	glClearColor(0.2f, 0.3f, 3.0f, 0.0f);
 ;
 	array<glm::vec3, 4> vertices = {
@@ -95,85 +84,58 @@ int main()
 
 	array<GLuint, 6> indexes{ 0, 1, 2, 2, 3, 0 };
 
-	GLuint idx_ebo;
-	glGenBuffers(1, &idx_ebo);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, idx_ebo);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indexes), indexes.data(), GL_STATIC_DRAW);
-
-	GLuint pos_vbo;
-	glGenBuffers(1, &pos_vbo);
-	glBindBuffer(GL_ARRAY_BUFFER, pos_vbo);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices.data(), GL_STATIC_DRAW);
-
-	GLuint col_vbo;
-	glGenBuffers(1, &col_vbo);
-	glBindBuffer(GL_ARRAY_BUFFER, col_vbo);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(colors), colors.data(), GL_STATIC_DRAW);
-
-	GLuint tex_vbo;
-	glGenBuffers(1, &tex_vbo);
-	glBindBuffer(GL_ARRAY_BUFFER, tex_vbo);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(texCoords), texCoords.data(), GL_STATIC_DRAW);
+	glsl::Buffer ebo{ indexes };
+	glsl::Buffer posVbo{ vertices };
+	glsl::Buffer colVbo{ colors };
+	glsl::Buffer texVbo{ texCoords };
+
+	glsl::VertexArray vao;
+	vao.vertexBuffer(0, posVbo, 0, sizeof(glm::vec3));
+	vao.vertexBuffer(1, colVbo, 0, sizeof(glm::vec3));
+	vao.vertexBuffer(2, texVbo, 0, sizeof(glm::vec2));
+	vao.attribute(0, 0, 3, GL_FLOAT);
+	vao.attribute(1, 1, 3, GL_FLOAT);
+	vao.attribute(2, 2, 2, GL_FLOAT);
+	vao.elementBuffer(ebo);
+	vao.bind();
 
-	GLuint vao;
-	glGenVertexArrays(1, &vao);
-	glBindVertexArray(vao);
-
-	glBindBuffer(GL_ARRAY_BUFFER, pos_vbo);
-	glVertexAttribPointer(0, 3, GL_FLOAT, false, 3 * sizeof(GLfloat), nullptr);
-
-	glBindBuffer(GL_ARRAY_BUFFER, col_vbo);
-	glVertexAttribPointer(1, 3, GL_FLOAT, false, 3 * sizeof(GLfloat), nullptr);
-
-	glBindBuffer(GL_ARRAY_BUFFER, tex_vbo);
-	glVertexAttribPointer(2, 3, GL_FLOAT, false, 2 * sizeof(GLfloat), nullptr);
-
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, idx_ebo);
-
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-	glEnableVertexAttribArray(2);
-	
-	array<GLuint, 2> textures;
-	glGenTextures((GLsizei)textures.size(), textures.data());
-	
 	int width, height, channels;
-	auto rawWallImageData = stbi_load("resources/textures/wall.jpeg", &width, &height, &channels, 0);
-
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_2D, textures[0]);
+	auto rawWallImageData = COMMON_PROFILE_CALL("stbi_load", stbi_load("resources/textures/wall.jpeg", &width, &height, &channels, 0));
 
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glsl::Texture wall;
+	wall.parameter(GL_TEXTURE_WRAP_S, GL_REPEAT);
+	wall.parameter(GL_TEXTURE_WRAP_T, GL_REPEAT);
+	wall.parameter(GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	wall.parameter(GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
 	if (rawWallImageData)
 	{
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, rawWallImageData);
-		glGenerateMipmap(GL_TEXTURE_2D);
+		wall.storage2D(glsl::mipLevels(width, height), GL_RGB8, width, height);
+		wall.subImage2D(0, 0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, rawWallImageData);
+		wall.generateMipmap();
 	}
 
 	stbi_image_free(rawWallImageData);
+	wall.bind(0);
 
 	stbi_set_flip_vertically_on_load(true);
-	auto rawSmileImageData = stbi_load("resources/textures/awesomeface.png", &width, &height, &channels, 0);
-
-	glActiveTexture(GL_TEXTURE1);
-	glBindTexture(GL_TEXTURE_2D, textures[1]);
+	auto rawSmileImageData = COMMON_PROFILE_CALL("stbi_load", stbi_load("resources/textures/awesomeface.png", &width, &height, &channels, 0));
 
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glsl::Texture smile;
+	smile.parameter(GL_TEXTURE_WRAP_S, GL_REPEAT);
+	smile.parameter(GL_TEXTURE_WRAP_T, GL_REPEAT);
+	smile.parameter(GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	smile.parameter(GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
 	if (rawSmileImageData)
 	{
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, rawSmileImageData);
-		glGenerateMipmap(GL_TEXTURE_2D);
+		smile.storage2D(glsl::mipLevels(width, height), GL_RGB8, width, height);
+		smile.subImage2D(0, 0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, rawSmileImageData);
+		smile.generateMipmap();
 	}
 
 	stbi_image_free(rawSmileImageData);
+	smile.bind(1);
 	
 	glsl::Program prog{
 		{ glsl::vertex_shader  , "resources/shaders/2.6.3_texture.vs"s },
@@ -181,24 +143,24 @@ int main()
 	};
 	
 	prog.use();
-	prog.uniform("text1"s, 0);
-	prog.uniform("text2"s, 1);
+	prog.uniform("text1", 0);
+	prog.uniform("text2", 1);
 
-	while (!glfwWindowShouldClose(window))
+	while (context.running())
 	{
-		glfwPollEvents();
+		context.pollEvents();
 
 		glClear(GL_COLOR_BUFFER_BIT);
 		glDrawElements(GL_TRIANGLES, (GLuint)indexes.size(), GL_UNSIGNED_INT, nullptr);
 
-		glfwSwapBuffers(window);		
+		context.swapBuffers();		
 	}
 
-	glDeleteBuffers(1, &pos_vbo);
-	glDeleteBuffers(1, &col_vbo);
-	glDeleteVertexArrays(1, &vao);
-
-	glfwDestroyWindow(window);
-	glfwTerminate();
 	return 0;
+}
+catch (const exception& e)
+{
+	// the context has been destroyed by now; headless runs see a failed exit
+	cerr << e.what() << endl;
+	return 1;
 }
\ No newline at end of file
@@ -2,14 +2,18 @@
 
 #include "stb_image.h"
 #include <glsl.hpp>
+#include <cpu_profiler.hpp>
+#include <camera.hpp>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
+#include <app_context.hpp>
+#include <gl_objects.hpp>
 #include <GLFW/glfw3.h>
 #include <iostream>
 #include <array>
 using namespace std;
 
-static int g_width = 800, g_height = 600;
+static const int g_width = 800, g_height = 600;
 
 void keyCallback(GLFWwindow* window, int key, int, int action, int)
 {
@@ -27,7 +31,7 @@ void keyCallback(GLFWwindow* window, int key, int, int action, int)
 
 		wireframe = !wireframe;
 
-		glPolygonMode(GL_FRONT_AND_BACK, wireframe ? GL_LINE : GL_FILL);
+		glsl::GLState::current().polygonMode(wireframe ? GL_LINE : GL_FILL);
 		
 	default:
 		break;
@@ -36,44 +40,35 @@ void keyCallback(GLFWwindow* window, int key, int, int action, int)
 
 void frameBufferSizeCallback(GLFWwindow* window, int width, int height)
 {
-	g_width = width;
-	g_height = height;
+	auto camera = static_cast<common::Camera*>(glfwGetWindowUserPointer(window));
+	camera->setViewport(width, height);
 	glViewport(0, 0, width, height);
 }
 
 #if defined(WIN32)
 int wWinMain(HINSTANCE /*hInst*/, HINSTANCE /*hPrevInst*/, LPWSTR /*lpCmdLine*/, int /*nCmdShow*/)
 #else
-int main()
+int main(int argc, char** argv)
 #endif
+try
 {
-	glfwInit();
-
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 4);
-	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-
-	auto window = glfwCreateWindow(g_width, g_height, "2.8.3 Transform", nullptr, nullptr);
-
-	if (!window)
-	{
-		const char* error;
-		glfwGetError(&error);
-		cerr << "Unable to open the window: " << error << endl;
-		glfwTerminate();
-
-		return 1;
-	}
+#if defined(WIN32)
+	glsl::CommandLine commandLine;
+	const auto argc = commandLine.argc();
+	const auto argv = commandLine.argv();
+#endif
 
-	glfwSetFramebufferSizeCallback(window, frameBufferSizeCallback);
-	glfwSetKeyCallback(window, keyCallback);
+	glsl::AppContext context{ glsl::ContextOptions::fromCommandLine(argc, argv, { g_width, g_height, "2.8.3 Transform", 4, 4 }) };
+	auto window = context.window();
 
-	glfwMakeContextCurrent(window);
+	common::Camera camera{ glm::radians(45.0f), g_width, g_height };
+	camera.setPosition(glm::vec3{ 0.0f, 0.0f, 3.0f });
 
-	if (!gladLoadGLLoader(reinterpret_cast<GLADloadproc>(glfwGetProcAddress)))
+	if (window)
 	{
-		cerr << "Failed to initialize GLAD" << std::endl;
-		return -1;
+		glfwSetWindowUserPointer(window, &camera);
+		glfwSetFramebufferSizeCallback(window, frameBufferSizeCallback);
+		glfwSetKeyCallback(window, keyCallback);
 	}
 
 	array<glm::vec3, 10> cubePositions{
@@ -89,8 +84,7 @@ int main()
 		glm::vec3{ -1.3f,  1.0f,  -1.5f}
 	};
 
-	glfwSwapInterval(1);
-	glEnable(GL_DEPTH_TEST);
+	glsl::GLState::current().enable(GL_DEPTH_TEST);
 	glClearColor(0.2f, 0.3f, 3.0f, 0.0f);
 
 	array<glm::vec2, 36> texCoords{
@@ -181,69 +175,53 @@ int main()
 		glm::vec4{ -0.5f,  0.5f, -0.5f, 1.0f},
 	};
 
-	GLuint pos_vbo;
-	glGenBuffers(1, &pos_vbo);
-	glBindBuffer(GL_ARRAY_BUFFER, pos_vbo);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices.data(), GL_STATIC_DRAW);
-
-	GLuint tex_vbo;
-	glGenBuffers(1, &tex_vbo);
-	glBindBuffer(GL_ARRAY_BUFFER, tex_vbo);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(texCoords), texCoords.data(), GL_STATIC_DRAW);
-
-	GLuint vao;
-	glGenVertexArrays(1, &vao);
-	glBindVertexArray(vao);
-
-	glBindBuffer(GL_ARRAY_BUFFER, pos_vbo);
-	glVertexAttribPointer(0, 4, GL_FLOAT, false, 4 * sizeof(GLfloat), nullptr);
+	glsl::Buffer posVbo{ vertices };
+	glsl::Buffer texVbo{ texCoords };
 
-	glBindBuffer(GL_ARRAY_BUFFER, tex_vbo);
-	glVertexAttribPointer(1, 2, GL_FLOAT, false, 2 * sizeof(GLfloat), nullptr);
+	glsl::VertexArray vao;
+	vao.vertexBuffer(0, posVbo, 0, sizeof(glm::vec4));
+	vao.vertexBuffer(1, texVbo, 0, sizeof(glm::vec2));
+	vao.attribute(0, 0, 4, GL_FLOAT);
+	vao.attribute(1, 1, 2, GL_FLOAT);
+	vao.bind();
 
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-	
-	array<GLuint, 2> textures;
-	glGenTextures((GLsizei)textures.size(), textures.data());
-	
 	int width, height, channels;
-	auto rawWallImageData = stbi_load("resources/textures/wall.jpeg", &width, &height, &channels, 0);
-
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_2D, textures[0]);
+	auto rawWallImageData = COMMON_PROFILE_CALL("stbi_load", stbi_load("resources/textures/wall.jpeg", &width, &height, &channels, 0));
 
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glsl::Texture wall;
+	wall.parameter(GL_TEXTURE_WRAP_S, GL_REPEAT);
+	wall.parameter(GL_TEXTURE_WRAP_T, GL_REPEAT);
+	wall.parameter(GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	wall.parameter(GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
 	if (rawWallImageData)
 	{
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, rawWallImageData);
-		glGenerateMipmap(GL_TEXTURE_2D);
+		wall.storage2D(glsl::mipLevels(width, height), GL_RGB8, width, height);
+		wall.subImage2D(0, 0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, rawWallImageData);
+		wall.generateMipmap();
 	}
 
 	stbi_image_free(rawWallImageData);
+	wall.bind(0);
 
 	stbi_set_flip_vertically_on_load(true);
-	auto rawSmileImageData = stbi_load("resources/textures/wall.png", &width, &height, &channels, 0);
+	auto rawSmileImageData = COMMON_PROFILE_CALL("stbi_load", stbi_load("resources/textures/wall.png", &width, &height, &channels, 0));
 
-	glActiveTexture(GL_TEXTURE1);
-	glBindTexture(GL_TEXTURE_2D, textures[1]);
-
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glsl::Texture smile;
+	smile.parameter(GL_TEXTURE_WRAP_S, GL_REPEAT);
+	smile.parameter(GL_TEXTURE_WRAP_T, GL_REPEAT);
+	smile.parameter(GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	smile.parameter(GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
 	if (rawSmileImageData)
 	{
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, rawSmileImageData);
-		glGenerateMipmap(GL_TEXTURE_2D);
+		smile.storage2D(glsl::mipLevels(width, height), GL_RGB8, width, height);
+		smile.subImage2D(0, 0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, rawSmileImageData);
+		smile.generateMipmap();
 	}
 
 	stbi_image_free(rawSmileImageData);
+	smile.bind(1);
 	
 	glsl::Program prog{
 		{ glsl::vertex_shader  , "resources/shaders/2.8.2_transform.vs"s },
@@ -251,38 +229,40 @@ int main()
 	};
 	
 	prog.use();
-	prog.uniform("text"s, 0);
+	prog.uniform("text", 0);
+
+	auto cameraVersion = ~std::uint64_t{ 0 };
 
-	while (!glfwWindowShouldClose(window))
+	while (context.running())
 	{
-		glfwPollEvents();
+		context.pollEvents();
 
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-		auto view = glm::mat4{ 1.0f };
-		view = glm::translate(view, glm::vec3{ 0.0f, 0.0f, -3.0f });
-
-		auto projection = glm::perspective(glm::radians(45.0f), static_cast<float>(g_width) / g_height, 0.1f, 100.0f);
-
-		prog.uniform("view"s, view);
-		prog.uniform("projection"s, projection);
+		if (camera.version() != cameraVersion)
+		{
+			prog.uniform("view", camera.view());
+			prog.uniform("projection", camera.projection());
+			cameraVersion = camera.version();
+		}
 
-		for_each(begin(cubePositions), end(cubePositions), [&prog, &vertices](const auto& pos)
+		for_each(begin(cubePositions), end(cubePositions), [&prog, &vertices, &context](const auto& pos)
 		{
 			auto model = glm::mat4{ 1.0f };
 			model = glm::translate(model, pos);
-			model = glm::rotate(model, glm::radians(static_cast<float>(glfwGetTime() * 10.0f)), glm::vec3{ 1.0f, 0.3f, 0.5f });
-			prog.uniform("model"s, model);
+			model = glm::rotate(model, glm::radians(static_cast<float>(context.time() * 10.0f)), glm::vec3{ 1.0f, 0.3f, 0.5f });
+			prog.uniform("model", model);
 			glDrawArrays(GL_TRIANGLES, 0, static_cast<GLint>(vertices.size()));
 		});
 
-		glfwSwapBuffers(window);		
+		context.swapBuffers();		
 	}
 
-	glDeleteBuffers(1, &pos_vbo);
-	glDeleteVertexArrays(1, &vao);
-
-	glfwDestroyWindow(window);
-	glfwTerminate();
 	return 0;
+}
+catch (const exception& e)
+{
+	// the context has been destroyed by now; headless runs see a failed exit
+	cerr << e.what() << endl;
+	return 1;
 }
\ No newline at end of file
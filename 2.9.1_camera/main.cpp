@@ -2,14 +2,29 @@
 
 #include "stb_image.h"
 #include <glsl.hpp>
+#include <cpu_profiler.hpp>
+#include <gl_objects.hpp>
+#include <geometry_arena.hpp>
+#include <camera.hpp>
+#include <frame_pipeline.hpp>
+#include <render_queue.hpp>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
+#include <app_context.hpp>
+#include <gpu_profiler.hpp>
 #include <GLFW/glfw3.h>
 #include <iostream>
 #include <array>
+#include <cstddef>
 using namespace std;
 
-static int g_width = 800, g_height = 600;
+static const int g_width = 800, g_height = 600;
+
+// Everything the simulation hands over to the render thread for one frame.
+struct FrameState {
+	common::Camera camera{ glm::radians(45.0f), g_width, g_height };
+	glsl::RenderQueue queue;
+};
 
 void keyCallback(GLFWwindow* window, int key, int, int action, int)
 {
@@ -27,7 +42,7 @@ void keyCallback(GLFWwindow* window, int key, int, int action, int)
 
 		wireframe = !wireframe;
 
-		glPolygonMode(GL_FRONT_AND_BACK, wireframe ? GL_LINE : GL_FILL);
+		glsl::GLState::current().polygonMode(wireframe ? GL_LINE : GL_FILL);
 		
 	default:
 		break;
@@ -36,44 +51,34 @@ void keyCallback(GLFWwindow* window, int key, int, int action, int)
 
 void frameBufferSizeCallback(GLFWwindow* window, int width, int height)
 {
-	g_width = width;
-	g_height = height;
+	auto viewport = static_cast<glm::ivec2*>(glfwGetWindowUserPointer(window));
+	*viewport = glm::ivec2{ width, height };
 	glViewport(0, 0, width, height);
 }
 
 #if defined(WIN32)
 int wWinMain(HINSTANCE /*hInst*/, HINSTANCE /*hPrevInst*/, LPWSTR /*lpCmdLine*/, int /*nCmdShow*/)
 #else
-int main()
+int main(int argc, char** argv)
 #endif
+try
 {
-	glfwInit();
-
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 4);
-	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-
-	auto window = glfwCreateWindow(g_width, g_height, "2.9.1 Camera", nullptr, nullptr);
-
-	if (!window)
-	{
-		const char* error;
-		glfwGetError(&error);
-		cerr << "Unable to open the window: " << error << endl;
-		glfwTerminate();
-
-		return 1;
-	}
+#if defined(WIN32)
+	glsl::CommandLine commandLine;
+	const auto argc = commandLine.argc();
+	const auto argv = commandLine.argv();
+#endif
 
-	glfwSetFramebufferSizeCallback(window, frameBufferSizeCallback);
-	glfwSetKeyCallback(window, keyCallback);
+	glsl::AppContext context{ glsl::ContextOptions::fromCommandLine(argc, argv, { g_width, g_height, "2.9.1 Camera", 4, 5 }) };
+	auto window = context.window();
 
-	glfwMakeContextCurrent(window);
+	glm::ivec2 viewport{ g_width, g_height };
 
-	if (!gladLoadGLLoader(reinterpret_cast<GLADloadproc>(glfwGetProcAddress)))
+	if (window)
 	{
-		cerr << "Failed to initialize GLAD" << std::endl;
-		return -1;
+		glfwSetWindowUserPointer(window, &viewport);
+		glfwSetFramebufferSizeCallback(window, frameBufferSizeCallback);
+		glfwSetKeyCallback(window, keyCallback);
 	}
 
 	array<glm::vec3, 10> cubePositions{
@@ -89,8 +94,7 @@ int main()
 		glm::vec3{ -1.3f,  1.0f,  -1.5f}
 	};
 
-	glfwSwapInterval(1);
-	glEnable(GL_DEPTH_TEST);
+	glsl::GLState::current().enable(GL_DEPTH_TEST);
 	glClearColor(0.2f, 0.3f, 3.0f, 0.0f);
 
 	array<glm::vec2, 36> texCoords{
@@ -181,66 +185,56 @@ int main()
 		glm::vec4{ -0.5f,  0.5f, -0.5f, 1.0f},
 	};
 
-	GLuint pos_vbo;
-	glGenBuffers(1, &pos_vbo);
-	glBindBuffer(GL_ARRAY_BUFFER, pos_vbo);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices.data(), GL_STATIC_DRAW);
+	struct CubeVertex {
+		glm::vec4 position;
+		glm::vec2 texCoord;
+	};
 
-	GLuint tex_vbo;
-	glGenBuffers(1, &tex_vbo);
-	glBindBuffer(GL_ARRAY_BUFFER, tex_vbo);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(texCoords), texCoords.data(), GL_STATIC_DRAW);
+	array<CubeVertex, 36> cubeVertices;
+	array<GLuint, 36> cubeIndices;
+	for (size_t i = 0; i < cubeVertices.size(); ++i)
+	{
+		cubeVertices[i] = { vertices[i], texCoords[i] };
+		cubeIndices[i] = static_cast<GLuint>(i);
+	}
 
-	GLuint vao;
-	glGenVertexArrays(1, &vao);
-	glBindVertexArray(vao);
+	glsl::GeometryArena arena{ {
+		static_cast<GLsizei>(sizeof(CubeVertex)), {
+			{ 0, 4, GL_FLOAT, offsetof(CubeVertex, position) },
+			{ 1, 2, GL_FLOAT, offsetof(CubeVertex, texCoord) }
+		} } };
+	const auto cubeMesh = arena.add(cubeVertices, cubeIndices);
 
-	glBindBuffer(GL_ARRAY_BUFFER, pos_vbo);
-	glVertexAttribPointer(0, 4, GL_FLOAT, false, 4 * sizeof(GLfloat), nullptr);
+	array<glsl::Texture, 2> textures;
 
-	glBindBuffer(GL_ARRAY_BUFFER, tex_vbo);
-	glVertexAttribPointer(1, 2, GL_FLOAT, false, 2 * sizeof(GLfloat), nullptr);
+	for (auto& texture : textures)
+	{
+		texture.parameter(GL_TEXTURE_WRAP_S, GL_REPEAT);
+		texture.parameter(GL_TEXTURE_WRAP_T, GL_REPEAT);
+		texture.parameter(GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		texture.parameter(GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	}
 
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-	
-	array<GLuint, 2> textures;
-	glGenTextures((GLsizei)textures.size(), textures.data());
-	
 	int width, height, channels;
-	auto rawWallImageData = stbi_load("resources/textures/wall.jpeg", &width, &height, &channels, 0);
-
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_2D, textures[0]);
-
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	auto rawWallImageData = COMMON_PROFILE_CALL("stbi_load", stbi_load("resources/textures/wall.jpeg", &width, &height, &channels, 0));
 
 	if (rawWallImageData)
 	{
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, rawWallImageData);
-		glGenerateMipmap(GL_TEXTURE_2D);
+		textures[0].storage2D(glsl::mipLevels(width, height), GL_RGB8, width, height);
+		textures[0].subImage2D(0, 0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, rawWallImageData);
+		textures[0].generateMipmap();
 	}
 
 	stbi_image_free(rawWallImageData);
 
 	stbi_set_flip_vertically_on_load(true);
-	auto rawSmileImageData = stbi_load("resources/textures/wall.png", &width, &height, &channels, 0);
-
-	glActiveTexture(GL_TEXTURE1);
-	glBindTexture(GL_TEXTURE_2D, textures[1]);
-
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	auto rawSmileImageData = COMMON_PROFILE_CALL("stbi_load", stbi_load("resources/textures/wall.png", &width, &height, &channels, 0));
 
 	if (rawSmileImageData)
 	{
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, rawSmileImageData);
-		glGenerateMipmap(GL_TEXTURE_2D);
+		textures[1].storage2D(glsl::mipLevels(width, height), GL_RGB8, width, height);
+		textures[1].subImage2D(0, 0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, rawSmileImageData);
+		textures[1].generateMipmap();
 	}
 
 	stbi_image_free(rawSmileImageData);
@@ -251,46 +245,113 @@ int main()
 	};
 	
 	prog.use();
-	prog.uniform("text"s, 0);
-
-	while (!glfwWindowShouldClose(window))
+	prog.uniform("text", 0);
+
+	common::JobSystem jobs;
+	common::FramePipeline<FrameState> pipeline{ jobs };
+	auto cameraVersion = ~std::uint64_t{ 0 };
+
+	glsl::DrawPacket cube;
+	cube.program = prog;
+	cube.vao = arena.vertexArray(cubeMesh.page);
+	cube.textures = { textures[0], textures[1] };
+	cube.indexType = GL_UNSIGNED_INT;
+	cube.first = static_cast<GLint>(cubeMesh.firstIndex * sizeof(GLuint));
+	cube.count = cubeMesh.indexCount;
+	cube.baseVertex = cubeMesh.baseVertex;
+	cube.modelLocation = glGetUniformLocation(prog, "model");
+
+	glsl::RenderQueueStats queueTotals;
+	auto& gpuProfiler = context.gpuProfiler();
+
+	while (context.running())
 	{
-		glfwPollEvents();
+		context.pollEvents();
+
+		// runs on a worker, one frame ahead of the draws below
+		const auto t = static_cast<float>(context.time());
+		auto simulate = [&cubePositions, cube, viewport, t](FrameState& next, const FrameState& previous, uint64_t)
+		{
+			const auto radius = 10.0f;
+			const auto camX = sin(t) * radius;
+			const auto camZ = cos(t) * radius;
+
+			next.camera = previous.camera;
+			next.camera.setViewport(viewport.x, viewport.y);
+			next.camera.lookAt(glm::vec3{ camX, 0.0f, camZ }, glm::vec3{ 0.0f, 0.0f, 0.0f });
 
-		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+			// a rotated unit cube stays inside a sphere of radius sqrt(3) / 2
+			const auto extent = glm::vec3{ 0.87f };
 
-		const auto radius = 10.0f;
-		const auto t = static_cast<float>(glfwGetTime());
-		const auto camX = sin(t) * radius;
-		const auto camZ = cos(t) * radius;
+			// this also settles the cached matrices, the render thread only reads them
+			const auto& frustum = next.camera.frustum();
 
-		const auto view = glm::lookAt(
-			glm::vec3{ camX, 0.0f, camZ },
-			glm::vec3{ 0.0f, 0.0f, 0.0f },
-			glm::vec3{ 0.0f, 1.0f, 0.0f }
-		);
+			next.queue.clear();
+			for (const auto& pos : cubePositions)
+			{
+				if (!frustum.intersects({ pos - extent, pos + extent }))
+					continue;
 
-		auto projection = glm::perspective(glm::radians(45.0f), static_cast<float>(g_width) / g_height, 0.1f, 100.0f);
+				auto packet = cube;
+				packet.model = glm::translate(packet.model, pos);
+				packet.model = glm::rotate(packet.model, sin(t) * 4.0f, glm::vec3{ 1.0f, 0.3f, 1.5f });
+				packet.depth = glm::distance(next.camera.position(), pos);
+				next.queue.push(packet);
+			}
 
-		prog.uniform("view"s, view);
-		prog.uniform("projection"s, projection);
+			next.queue.sort();
+		};
 
-		for_each(begin(cubePositions), end(cubePositions), [&prog, &vertices, &t](const auto& pos)
+		pipeline.frame(simulate, [&](const FrameState& state, uint64_t)
 		{
-			auto model = glm::mat4{ 1.0f };
-			model = glm::translate(model, pos);
-			model = glm::rotate(model, sin(t) * 4.0f, glm::vec3{ 1.0f, 0.3f, 1.5f });
-			prog.uniform("model"s, model);
-			glDrawArrays(GL_TRIANGLES, 0, static_cast<GLint>(vertices.size()));
+			gpuProfiler.begin("frame");
+			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+			if (state.camera.version() != cameraVersion)
+			{
+				prog.uniform("view", state.camera.view());
+				prog.uniform("projection", state.camera.projection());
+				cameraVersion = state.camera.version();
+			}
+
+			gpuProfiler.begin("queue");
+			const auto submitted = state.queue.submit();
+			gpuProfiler.end();
+
+			queueTotals.draws += submitted.draws;
+			queueTotals.programBindsSkipped += submitted.programBindsSkipped;
+			queueTotals.vaoBindsSkipped += submitted.vaoBindsSkipped;
+			queueTotals.textureBindsSkipped += submitted.textureBindsSkipped;
+
+			gpuProfiler.end();
+			context.swapBuffers();
 		});
-
-		glfwSwapBuffers(window);		
 	}
 
-	glDeleteBuffers(1, &pos_vbo);
-	glDeleteVertexArrays(1, &vao);
+	const auto& stats = pipeline.stats();
+	if (stats.frames)
+	{
+		cout << "frames: " << stats.frames
+			<< ", simulate: " << stats.simulateMs / stats.frames << " ms"
+			<< ", render: " << stats.renderMs / stats.frames << " ms"
+			<< ", frame: " << stats.frameMs / stats.frames << " ms"
+			<< ", overlap: " << stats.overlapMs() / stats.frames << " ms/frame" << endl;
+
+		cout << "draws: " << queueTotals.draws
+			<< ", skipped binds: program " << queueTotals.programBindsSkipped
+			<< ", vao " << queueTotals.vaoBindsSkipped
+			<< ", texture " << queueTotals.textureBindsSkipped << endl;
+
+		const auto& glState = glsl::GLState::current();
+		cout << "GL state calls: issued " << glState.callsIssued()
+			<< ", skipped " << glState.callsSkipped() << endl;
+	}
 
-	glfwDestroyWindow(window);
-	glfwTerminate();
 	return 0;
+}
+catch (const exception& e)
+{
+	// the context has been destroyed by now; headless runs see a failed exit
+	cerr << e.what() << endl;
+	return 1;
 }
\ No newline at end of file
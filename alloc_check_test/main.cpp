@@ -0,0 +1,47 @@
+#include <glsl.hpp>
+#include <app_context.hpp>
+#include <gl_objects.hpp>
+#include <iostream>
+#include <string>
+using namespace std;
+
+// 2.4.1 with a regression --alloc-check must catch: a uniform name built as
+// a std::string every frame. It outgrows the small string buffer in
+// append(), which libstdc++ does not inline, so the allocator is called from
+// the shared libstdc++ on the program's behalf.
+int main(int argc, char** argv)
+try
+{
+	glsl::AppContext context{ glsl::ContextOptions::fromCommandLine(argc, argv, { 800, 600, "alloc check regression", 4, 4 }) };
+
+	glsl::Program prog{
+		{ glsl::vertex_shader  , "resources/shaders/2.4.1_hello_triangle.vs"s },
+		{ glsl::fragment_shader, "resources/shaders/2.4.1_hello_triangle.fs"s }
+	};
+
+	prog.use();
+
+	glsl::VertexArray vao;
+	vao.bind();
+
+	const string prefix = "lights";
+	const string_view member = "[0].attenuation_constant";
+
+	while (context.running())
+	{
+		context.pollEvents();
+
+		glClear(GL_COLOR_BUFFER_BIT);
+		prog.uniform(prefix + member.data(), 0u);
+		glDrawArrays(GL_TRIANGLES, 0, 3);
+
+		context.swapBuffers();
+	}
+
+	return 0;
+}
+catch (const exception& e)
+{
+	cerr << e.what() << endl;
+	return 1;
+}
\ No newline at end of file
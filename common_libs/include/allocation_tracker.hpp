@@ -0,0 +1,121 @@
+#pragma once
+
+#include <frame_stats.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace common {
+
+	struct AllocationCount {
+		std::uint64_t count = 0;
+		std::uint64_t bytes = 0;
+
+		// Of those, the ones a shared library asked for: the GL driver, libc.
+		std::uint64_t libraryCount = 0;
+		std::uint64_t libraryBytes = 0;
+
+		std::uint64_t programCount() const noexcept
+		{
+			return count - libraryCount;
+		}
+	};
+
+	struct AllocationSite {
+		static constexpr std::size_t depth = 6;
+
+		void* callers[depth];           // innermost first, null past the stack's end
+		std::uint64_t count;
+		std::uint64_t bytes;
+		bool library;                   // made for a shared library, see AllocationTracker
+	};
+
+	// Counts the heap allocations made on every thread. common_libs
+	// replaces operator new and delete when built with
+	// USE_ALLOCATION_TRACKER, and on glibc the malloc family as well, so
+	// C libraries and the GL driver are seen too. The replacements go to
+	// the C runtime's allocator; while the tracker is off they add one
+	// relaxed load.
+	//
+	// Where malloc is hooked each allocation is also put down to the
+	// program, with common_libs and everything else linked into it
+	// statically, or a shared library such as the GL driver. libc and
+	// libstdc++ only allocate for their callers, so they are looked through:
+	// a std::string the program builds is the program's even though
+	// libstdc++ calls operator new. Without sites only the allocator's
+	// direct caller is known, and one in those runtimes counts as a library.
+	// Elsewhere every allocation counts as the program's.
+	//
+	// With sites every allocation also walks the stack and is counted under
+	// its innermost callers, in a fixed table that needs no allocation.
+	// frameEnd() closes a frame: the allocations since the last one are that
+	// frame's. The tracker's own bookkeeping is not counted.
+	class AllocationTracker {
+	public:
+		// Frames the histograms cover, the newest ones; room for them is taken
+		// by enable() so that closing a frame never allocates.
+		static constexpr std::size_t history_frames = 16384;
+
+		static AllocationTracker& instance();
+
+		// False without USE_ALLOCATION_TRACKER; nothing is counted then.
+		static bool available() noexcept;
+
+		AllocationTracker(const AllocationTracker&) = delete;
+		AllocationTracker& operator = (const AllocationTracker&) = delete;
+
+		void enable(bool sites = false);
+		void disable();
+		bool enabled() const noexcept;
+
+		void frameEnd();
+
+		std::uint64_t frames() const noexcept
+		{
+			return mFrames;
+		}
+
+		AllocationCount lastFrame() const noexcept
+		{
+			return mLastFrame;
+		}
+
+		// Everything counted since enable() or reset(), closed frame or not.
+		AllocationCount total() const noexcept;
+
+		// Per frame allocations, bytes and library allocations over the last
+		// history_frames closed frames.
+		TimingSummary countHistogram() const;
+		TimingSummary byteHistogram() const;
+		TimingSummary libraryHistogram() const;
+
+		// Sites by allocations, busiest first; empty unless enabled with sites.
+		std::vector<AllocationSite> busiest(std::size_t count) const;
+
+		void reset();
+
+		void writeReport(std::ostream& out, std::size_t siteCount = 10) const;
+
+		// "caller <- its caller <- .." with symbol names where the platform
+		// has them, module and offset otherwise; an executable not linked
+		// with its symbols exported shows the latter, for addr2line.
+		static std::string describe(const AllocationSite& site);
+
+		// Called by the allocator replacements with their return address.
+		static void record(std::size_t bytes, const void* caller) noexcept;
+
+	private:
+		AllocationTracker() = default;
+
+	private:
+		std::uint64_t mFrames = 0;
+		AllocationCount mLastFrame;
+		AllocationCount mClosed;        // of the closed frames
+		std::vector<double> mPerFrameCount;
+		std::vector<double> mPerFrameBytes;
+		std::vector<double> mPerFrameLibrary;
+	};
+
+} // common
\ No newline at end of file
@@ -0,0 +1,232 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <vector>
+
+struct GLFWwindow;
+
+namespace glsl {
+
+	class FrameBenchmark;
+	class GpuProfiler;
+
+	enum class ContextBackend : std::uint8_t { window, egl, osmesa };
+
+	struct ContextOptions {
+		int width = 800;
+		int height = 600;
+		std::string title;
+		int glMajor = 4;
+		int glMinor = 5;
+		ContextBackend backend = ContextBackend::window;
+		// running() turns false after this many frames; 0 means until the
+		// window is closed. Headless contexts default to 60.
+		std::uint64_t frames = 0;
+		bool vsync = true;
+		bool visible = true;            // window backend only
+		bool gpuTitle = false;          // GPU scope times in the window title
+
+		// Benchmark mode times the frames after the first warmup ones; frames
+		// then counts the timed frames and defaults to 300.
+		bool bench = false;
+		std::uint64_t warmup = 10;
+		std::string benchOutput;        // empty for stdout
+
+		// Records the CPU profiler and writes a Chrome trace there on exit.
+		std::string traceOutput;
+
+		// Counts (and with glTraceTiming times) every GL call, see GlCallTrace.
+		bool glTrace = false;
+		bool glTraceTiming = false;
+
+		// Records the GL calls of the run there for glreplay, see GlCapture.
+		// Not with bench: the benchmark's own queries would be recorded.
+		std::string captureOutput;
+
+		// Writes the last frame there as a PNG; needs a frame count. Headless
+		// the frame count fixes the time the image shows.
+		std::string screenshotOutput;
+
+		// Counts the heap allocations of every frame and reports them on
+		// exit, see AllocationTracker; allocSites also finds where they are
+		// made.
+		bool allocTrace = false;
+		bool allocSites = false;
+
+		// swapBuffers() throws once a frame after the warmup ones allocates.
+		// Allocations a shared library makes, such as the GL driver's, do
+		// not count. Not with bench, trace, gl-trace, capture or the GPU
+		// title, which allocate as they record.
+		bool allocCheck = false;
+
+		// Applies the shared sample arguments on top of defaults:
+		//   --headless[=egl|osmesa]   render offscreen, EGL unless told otherwise
+		//   --frames N                stop after N frames
+		//   --bench                   time the frames, report when done
+		//   --warmup M                untimed (or unchecked) frames first
+		//   --bench-out FILE          write the report to FILE
+		//   --no-vsync                swap without waiting for vertical sync
+		//   --gpu-title               show the GPU scope times in the title
+		//   --trace FILE              write a Chrome trace of the CPU scopes
+		//   --gl-trace[=timing]       count (and time) the GL calls per frame
+		//   --capture FILE            record the GL calls for glreplay
+		//   --screenshot FILE         write the last frame as a PNG
+		//   --alloc-trace[=sites]     count (and locate) the heap allocations
+		//   --alloc-check             fail on a heap allocation after warmup
+		// Throws std::invalid_argument for any other argument starting with
+		// "--", or an option missing its value, so a mistyped option does
+		// not go unnoticed. Other arguments are left for the sample; argv
+		// may be null.
+		static ContextOptions fromCommandLine(int argc, char** argv, ContextOptions defaults);
+	};
+
+#if defined(_WIN32)
+	// The arguments of the process in UTF-8, for the samples' WinMain and
+	// wWinMain. The CRT fills __argv only for WinMain, and in the ANSI code
+	// page, so they read GetCommandLineW() through this instead.
+	class CommandLine {
+	public:
+		CommandLine();
+
+		CommandLine(const CommandLine&) = delete;
+		CommandLine& operator = (const CommandLine&) = delete;
+
+		int argc() const noexcept
+		{
+			return static_cast<int>(mArgs.size());
+		}
+
+		// Null-terminated like main's argv.
+		char** argv() noexcept
+		{
+			return mPointers.data();
+		}
+
+	private:
+		std::vector<std::string> mArgs;
+		std::vector<char*> mPointers;
+	};
+#endif
+
+	// Creates the GL context a sample renders into and loads GL through glad.
+	// The window backend is a GLFW window. The headless backends make a
+	// surfaceless EGL or an OSMesa context and bind an FBO of the requested
+	// size as the framebuffer, so a sample draws the same way in both modes;
+	// they exist when common_libs is built with USE_EGL / USE_OSMESA.
+	//
+	// Headless time() advances 1/60 s per swapBuffers() so offscreen runs are
+	// reproducible frame for frame. Throws std::runtime_error if the context
+	// cannot be created.
+	//
+	// In benchmark mode swapBuffers() feeds a FrameBenchmark, and the context
+	// writes its JSON report when it is destroyed:
+	//   {"name":..,"backend":..,"renderer":..,"version":..,"width":..,
+	//    "height":..,"vsync":..,"warmup":..,"frames":..,
+	//    "cpu_ms":{"count":..,"min":..,"mean":..,"p50":..,"p95":..,"p99":..,"max":..},
+	//    "gpu_ms":{..same keys..},
+	//    "gpu_scopes":{"frame/queue":{..same keys..},..},
+	//    "gl_calls":{..GlCallTrace::writeJson..}}    with --gl-trace only
+	//
+	// gpuProfiler() is ended with every frame; the samples open their scopes
+	// on it and the benchmark report and the window title show them.
+	class AppContext {
+	public:
+		explicit AppContext(const ContextOptions& options);
+
+		AppContext(const AppContext&) = delete;
+		AppContext& operator = (const AppContext&) = delete;
+
+		~AppContext();
+
+		// nullptr when headless; callbacks and user pointers go through it.
+		GLFWwindow* window() const noexcept
+		{
+			return mWindow;
+		}
+
+		bool headless() const noexcept
+		{
+			return mOptions.backend != ContextBackend::window;
+		}
+
+		const ContextOptions& options() const noexcept
+		{
+			return mOptions;
+		}
+
+		bool running() const;
+		void pollEvents();
+		void swapBuffers();
+
+		double time() const;
+
+		std::uint64_t frame() const noexcept
+		{
+			return mFrame;
+		}
+
+		// Tightly packed RGBA8 of the current framebuffer, bottom row first.
+		void readPixels(std::vector<unsigned char>& rgba) const;
+
+		// The headless FBO, 0 for a window.
+		GLuint framebuffer() const noexcept
+		{
+			return mFramebuffer;
+		}
+
+		GpuProfiler& gpuProfiler() noexcept
+		{
+			return *mGpuProfiler;
+		}
+
+		// nullptr unless in benchmark mode.
+		const FrameBenchmark* benchmark() const noexcept
+		{
+			return mBenchmark.get();
+		}
+
+		void writeBenchmarkReport(std::ostream& out);
+
+		static bool backendAvailable(ContextBackend backend) noexcept;
+
+	private:
+		void createWindow();
+		void createEgl();
+		void createOsMesa();
+		void createFramebuffer();
+		void release() noexcept;
+		void finishBenchmark() noexcept;
+		void finishTrace() noexcept;
+		void finishGlTrace() noexcept;
+		void finishCapture() noexcept;
+		void finishAllocationTrace() noexcept;
+		void checkAllocations();
+		void writeScreenshot();
+		std::uint64_t frameLimit() const noexcept;
+
+	private:
+		ContextOptions mOptions;
+		std::uint64_t mFrame = 0;
+		std::uint64_t mFrameStart = 0;
+
+		GLFWwindow* mWindow = nullptr;
+
+		void* mEglDisplay = nullptr;
+		void* mEglContext = nullptr;
+
+		void* mOsMesaContext = nullptr;
+		std::vector<unsigned char> mOsMesaBuffer;
+
+		GLuint mFramebuffer = 0;
+		GLuint mColorBuffer = 0;
+		GLuint mDepthBuffer = 0;
+
+		std::unique_ptr<GpuProfiler> mGpuProfiler;
+		std::unique_ptr<FrameBenchmark> mBenchmark;
+	};
+
+} // glsl
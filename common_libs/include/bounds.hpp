@@ -0,0 +1,83 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <array>
+#include <cmath>
+
+namespace common {
+
+	struct Aabb {
+		glm::vec3 min;
+		glm::vec3 max;
+
+		glm::vec3 center() const noexcept
+		{
+			return (min + max) * 0.5f;
+		}
+
+		glm::vec3 halfExtent() const noexcept
+		{
+			return (max - min) * 0.5f;
+		}
+
+		bool overlaps(const Aabb& rhs) const noexcept
+		{
+			return min.x <= rhs.max.x && max.x >= rhs.min.x
+				&& min.y <= rhs.max.y && max.y >= rhs.min.y
+				&& min.z <= rhs.max.z && max.z >= rhs.min.z;
+		}
+	};
+
+	// Planes are stored as (normal, d) with the normal pointing inwards, so a
+	// point p is inside when dot(normal, p) + d >= 0.
+	struct Frustum {
+		std::array<glm::vec4, 6> planes;
+
+		// Gribb/Hartmann extraction from a view-projection matrix.
+		static Frustum fromMatrix(const glm::mat4& m) noexcept
+		{
+			Frustum f;
+			for (int i = 0; i < 3; ++i)
+			{
+				for (int j = 0; j < 2; ++j)
+				{
+					const auto sign = j == 0 ? 1.0f : -1.0f;
+					glm::vec4 plane{
+						m[0][3] + sign * m[0][i],
+						m[1][3] + sign * m[1][i],
+						m[2][3] + sign * m[2][i],
+						m[3][3] + sign * m[3][i]
+					};
+
+					f.planes[i * 2 + j] = plane / glm::length(glm::vec3{ plane });
+				}
+			}
+			return f;
+		}
+
+		bool intersects(const Aabb& box) const noexcept
+		{
+			const auto c = box.center();
+			const auto e = box.halfExtent();
+
+			for (const auto& p : planes)
+			{
+				const auto r = e.x * std::abs(p.x) + e.y * std::abs(p.y) + e.z * std::abs(p.z);
+				if (p.x * c.x + p.y * c.y + p.z * c.z + p.w < -r)
+					return false;
+			}
+			return true;
+		}
+
+		bool intersects(const glm::vec3& center, float radius) const noexcept
+		{
+			for (const auto& p : planes)
+			{
+				if (p.x * center.x + p.y * center.y + p.z * center.z + p.w < -radius)
+					return false;
+			}
+			return true;
+		}
+	};
+
+} // common
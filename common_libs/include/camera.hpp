@@ -0,0 +1,91 @@
+#pragma once
+
+#include <bounds.hpp>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <cstdint>
+
+namespace common {
+
+	// Perspective camera that caches its matrices. Setters only mark the cached
+	// values stale when something actually changed, the getters recompute
+	// lazily, and every real change bumps version() so that anything derived
+	// from the camera (uniform uploads, culling results) can tell whether it
+	// is still current.
+	class Camera {
+	public:
+		Camera(float fovY, int viewportWidth, int viewportHeight, float zNear = 0.1f, float zFar = 100.0f);
+
+		void setPosition(const glm::vec3& position);
+		void setOrientation(const glm::quat& orientation);
+		void lookAt(const glm::vec3& eye, const glm::vec3& target, const glm::vec3& up = glm::vec3{ 0.0f, 1.0f, 0.0f });
+
+		void setFov(float fovY);
+		void setClipPlanes(float zNear, float zFar);
+
+		// A zero sized viewport (minimized window) keeps the previous aspect.
+		void setViewport(int width, int height);
+
+		const glm::vec3& position() const noexcept
+		{
+			return mPosition;
+		}
+
+		const glm::quat& orientation() const noexcept
+		{
+			return mOrientation;
+		}
+
+		glm::vec3 forward() const noexcept
+		{
+			return mOrientation * glm::vec3{ 0.0f, 0.0f, -1.0f };
+		}
+
+		float fov() const noexcept
+		{
+			return mFovY;
+		}
+
+		float aspect() const noexcept
+		{
+			return mAspect;
+		}
+
+		const glm::mat4& view() const;
+		const glm::mat4& projection() const;
+		const glm::mat4& viewProjection() const;
+		const Frustum& frustum() const;
+
+		std::uint64_t version() const noexcept
+		{
+			return mVersion;
+		}
+
+	private:
+		enum Dirty : unsigned {
+			dirty_view = 1,
+			dirty_projection = 2,
+			dirty_view_projection = 4,
+			dirty_frustum = 8,
+			dirty_all = 15
+		};
+
+		void invalidate(unsigned flags) noexcept;
+
+	private:
+		glm::vec3 mPosition;
+		glm::quat mOrientation;
+		float mFovY;
+		float mAspect;
+		float mNear;
+		float mFar;
+		std::uint64_t mVersion;
+
+		mutable unsigned mDirty;
+		mutable glm::mat4 mView;
+		mutable glm::mat4 mProjection;
+		mutable glm::mat4 mViewProjection;
+		mutable Frustum mFrustum;
+	};
+
+} // common
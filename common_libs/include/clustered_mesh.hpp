@@ -0,0 +1,55 @@
+#pragma once
+
+#include <bounds.hpp>
+#include <geometry_arena.hpp>
+#include <indirect_draw.hpp>
+#include <meshlets.hpp>
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace glsl {
+
+	struct ClusterCullStats {
+		std::uint32_t clusters = 0;
+		std::uint32_t outside = 0;
+		std::uint32_t backfacing = 0;
+		std::uint32_t triangles = 0;
+	};
+
+	// A large mesh split into meshlets at load time and stored in a
+	// GeometryArena with each meshlet's triangles as a contiguous index range.
+	// Every frame cull() drops the meshlets that are off screen or face away
+	// and adds one indirect draw per survivor, so the rasterizer only sees
+	// clusters that can contribute pixels.
+	class ClusteredMesh {
+	public:
+		// Positions are read from the layout attribute at location 0, which
+		// must be at least three floats.
+		ClusteredMesh(GeometryArena& arena, const void* vertices, GLsizei vertexCount,
+			const GLuint* indices, GLsizei indexCount, const common::MeshletLimits& limits = {});
+
+		ClusteredMesh(const ClusteredMesh&) = delete;
+		ClusteredMesh& operator = (const ClusteredMesh&) = delete;
+
+		~ClusteredMesh();
+
+		ClusterCullStats cull(const glm::mat4& model, const glm::vec3& eye, const common::Frustum& frustum, IndirectDrawBatch& batch) const;
+
+		const std::vector<common::Meshlet>& meshlets() const noexcept
+		{
+			return mMeshlets;
+		}
+
+		const MeshRange& range() const noexcept
+		{
+			return mRange;
+		}
+
+	private:
+		GeometryArena& mArena;
+		MeshRange mRange;
+		std::vector<common::Meshlet> mMeshlets;
+	};
+
+} // glsl
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace common {
+
+	// Collects named CPU scopes for a Chrome trace (about:tracing, Perfetto).
+	// Every thread appends to its own buffer, a list of fixed size chunks
+	// that only the owner writes: publishing an event is a release store of
+	// the chunk's count, so recording takes no lock and never moves earlier
+	// events. The mutex is only taken the first time a thread records and
+	// when exporting. Buffers outlive their threads.
+	//
+	// Time stamps are steady_clock nanoseconds. Names must outlive the
+	// profiler (string literals). Nothing is recorded until enable(true);
+	// while disabled a scope costs one relaxed load. The macros below compile
+	// to nothing unless COMMON_LIBS_PROFILER is defined (CMake option
+	// USE_CPU_PROFILER).
+	class CpuProfiler {
+	public:
+		struct Event {
+			const char* name;
+			std::uint64_t begin;
+			std::uint64_t end;
+		};
+
+		static CpuProfiler& instance();
+
+		static std::uint64_t now() noexcept;
+
+		CpuProfiler(const CpuProfiler&) = delete;
+		CpuProfiler& operator = (const CpuProfiler&) = delete;
+
+		~CpuProfiler();
+
+		void enable(bool on) noexcept
+		{
+			mEnabled.store(on, std::memory_order_relaxed);
+		}
+
+		bool enabled() const noexcept
+		{
+			return mEnabled.load(std::memory_order_relaxed);
+		}
+
+		void record(const char* name, std::uint64_t begin, std::uint64_t end);
+
+		// Names the calling thread in the trace.
+		void setThreadName(const char* name);
+
+		std::size_t eventCount() const;
+
+		// {"traceEvents":[..]} with one complete ("X") event per scope and the
+		// thread names as metadata; times in microseconds since construction.
+		void writeChromeTrace(std::ostream& out) const;
+
+		// Drops every event. No thread may be recording meanwhile.
+		void clear();
+
+	private:
+		static constexpr std::size_t chunk_size = 4096;
+
+		struct Chunk {
+			std::array<Event, chunk_size> events;
+			std::atomic<std::size_t> count{ 0 };
+			std::atomic<Chunk*> next{ nullptr };
+		};
+
+		struct ThreadBuffer {
+			explicit ThreadBuffer(std::uint32_t id) noexcept
+				: id{ id }
+				, tail{ &head }
+			{
+			}
+
+			~ThreadBuffer();
+
+			std::uint32_t id;
+			std::atomic<const char*> name{ nullptr };
+			Chunk head;
+			Chunk* tail;                // owner thread only
+		};
+
+		CpuProfiler();
+
+		ThreadBuffer& threadBuffer();
+
+	private:
+		std::atomic<bool> mEnabled{ false };
+		std::uint64_t mStart;
+		mutable std::mutex mMutex;
+		std::vector<std::unique_ptr<ThreadBuffer>> mThreads;
+	};
+
+	class ProfileScope {
+	public:
+		explicit ProfileScope(const char* name) noexcept
+			: mName{ CpuProfiler::instance().enabled() ? name : nullptr }
+			, mBegin{ mName ? CpuProfiler::now() : 0 }
+		{
+		}
+
+		ProfileScope(const ProfileScope&) = delete;
+		ProfileScope& operator = (const ProfileScope&) = delete;
+
+		~ProfileScope()
+		{
+			if (mName)
+				CpuProfiler::instance().record(mName, mBegin, CpuProfiler::now());
+		}
+
+	private:
+		const char* mName;
+		std::uint64_t mBegin;
+	};
+
+} // common
+
+// COMMON_PROFILE_SCOPE times the rest of the enclosing block,
+// COMMON_PROFILE_CALL times one expression and yields its value.
+#if defined(COMMON_LIBS_PROFILER)
+#	define COMMON_PROFILE_CONCAT_(a, b) a##b
+#	define COMMON_PROFILE_CONCAT(a, b) COMMON_PROFILE_CONCAT_(a, b)
+#	define COMMON_PROFILE_SCOPE(name) ::common::ProfileScope COMMON_PROFILE_CONCAT(profileScope, __LINE__){ name }
+#	define COMMON_PROFILE_FUNCTION() COMMON_PROFILE_SCOPE(__func__)
+#	define COMMON_PROFILE_CALL(name, ...) ([&]() -> decltype(auto) { COMMON_PROFILE_SCOPE(name); return __VA_ARGS__; }())
+#	define COMMON_PROFILE_THREAD(name) ::common::CpuProfiler::instance().setThreadName(name)
+#else
+#	define COMMON_PROFILE_SCOPE(name) ((void)0)
+#	define COMMON_PROFILE_FUNCTION() ((void)0)
+#	define COMMON_PROFILE_CALL(name, ...) (__VA_ARGS__)
+#	define COMMON_PROFILE_THREAD(name) ((void)0)
+#endif
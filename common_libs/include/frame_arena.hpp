@@ -0,0 +1,162 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace common {
+
+	// A bump allocator over one buffer. Any thread may allocate: taking
+	// memory is a compare-exchange on the offset, with no lock and no free
+	// list. Nothing is freed on its own; reset() drops everything at once.
+	//
+	// Past the capacity allocations come from overflow blocks on the heap,
+	// so a busy frame still works. The next reset() then grows the buffer to
+	// at least what the frame needed, so the ones after it fit again.
+	class LinearArena {
+	public:
+		explicit LinearArena(std::size_t capacity = 64 * 1024);
+		~LinearArena();
+
+		LinearArena(const LinearArena&) = delete;
+		LinearArena& operator = (const LinearArena&) = delete;
+
+		// alignment is a power of two. Never returns nullptr; throws
+		// std::length_error for a size that cannot be allocated at all.
+		void* allocate(std::size_t bytes, std::size_t alignment = alignof(std::max_align_t));
+
+		template <typename T>
+		T* allocate(std::size_t count)
+		{
+			if (count > std::numeric_limits<std::size_t>::max() / sizeof(T))
+				throw std::length_error{ "LinearArena allocation is too large" };
+
+			return static_cast<T*>(allocate(count * sizeof(T), alignof(T)));
+		}
+
+		// No thread may be allocating, and nothing allocated may be in use.
+		void reset();
+
+		// Bytes taken since the last reset, padding and overflow included.
+		std::size_t used() const noexcept
+		{
+			return mOffset.load(std::memory_order_relaxed) + mOverflowBytes.load(std::memory_order_relaxed);
+		}
+
+		std::size_t capacity() const noexcept
+		{
+			return mCapacity;
+		}
+
+		// The most used() ever reached before a reset.
+		std::size_t highWater() const noexcept;
+
+		// Allocations that did not fit since the last reset.
+		std::size_t overflows() const;
+
+	private:
+		void* allocateOverflow(std::size_t bytes, std::size_t alignment);
+
+	private:
+		std::unique_ptr<unsigned char[]> mBuffer;
+		std::size_t mCapacity;
+		std::atomic<std::size_t> mOffset{ 0 };
+		std::atomic<std::size_t> mOverflowBytes{ 0 };
+		std::size_t mHighWater = 0;
+
+		mutable std::mutex mOverflowMutex;
+		std::vector<std::unique_ptr<unsigned char[]>> mOverflow;
+	};
+
+	// One LinearArena per frame in flight, two by default, so the data a
+	// frame hands to the render thread lives until the same slot comes round
+	// again while the next frame fills the other one. begin(frame) resets
+	// the slot of frame % framesInFlight, so the frame framesInFlight before
+	// it must be done with its data by then.
+	class FrameArena {
+	public:
+		explicit FrameArena(std::size_t framesInFlight = 2, std::size_t capacity = 64 * 1024);
+
+		FrameArena(const FrameArena&) = delete;
+		FrameArena& operator = (const FrameArena&) = delete;
+
+		LinearArena& begin(std::uint64_t frame);
+
+		// The arena of a frame that has begun.
+		LinearArena& operator [] (std::uint64_t frame) noexcept
+		{
+			return *mFrames[frame % mFrames.size()];
+		}
+
+		std::size_t framesInFlight() const noexcept
+		{
+			return mFrames.size();
+		}
+
+		// Over every slot.
+		std::size_t highWater() const noexcept;
+		std::size_t capacity() const noexcept;
+
+	private:
+		std::vector<std::unique_ptr<LinearArena>> mFrames;
+	};
+
+	// Lets standard containers take their memory from a LinearArena.
+	// deallocate() does nothing: a container that grows leaves its old
+	// storage in the arena until reset, so reserve() up front where the size
+	// is known.
+	template <typename T>
+	class ArenaAllocator {
+	public:
+		using value_type = T;
+
+		ArenaAllocator(LinearArena& arena) noexcept
+			: mArena{ &arena }
+		{
+		}
+
+		template <typename U>
+		ArenaAllocator(const ArenaAllocator<U>& other) noexcept
+			: mArena{ other.arena() }
+		{
+		}
+
+		T* allocate(std::size_t count)
+		{
+			return mArena->allocate<T>(count);
+		}
+
+		void deallocate(T*, std::size_t) noexcept
+		{
+		}
+
+		LinearArena* arena() const noexcept
+		{
+			return mArena;
+		}
+
+		template <typename U>
+		bool operator == (const ArenaAllocator<U>& other) const noexcept
+		{
+			return mArena == other.arena();
+		}
+
+		template <typename U>
+		bool operator != (const ArenaAllocator<U>& other) const noexcept
+		{
+			return mArena != other.arena();
+		}
+
+	private:
+		LinearArena* mArena;
+	};
+
+	template <typename T>
+	using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+} // common
\ No newline at end of file
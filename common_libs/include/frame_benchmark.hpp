@@ -0,0 +1,78 @@
+#pragma once
+
+#include <frame_stats.hpp>
+#include <glad/glad.h>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace glsl {
+
+	// Records the CPU and GPU time of every frame after the first warmup
+	// frames. frameEnd() goes right before the swap: the CPU time of a frame
+	// runs from one frameEnd() to the next (the first from construction), the
+	// GPU time is a GL_TIME_ELAPSED query over the same span. Queries rotate
+	// through query_count objects and each is read when it comes round again,
+	// so the results are query_count - 1 frames old and never stall the
+	// pipeline. finish() ends the last query and collects the ones in flight.
+	//
+	// The first frame also covers whatever setup came before it (and Mesa
+	// llvmpipe reports garbage for the first query of a context), so at least
+	// one frame is always warmup. frames, when known, is how many timed
+	// frames to make room for up front.
+	class FrameBenchmark {
+	public:
+		static constexpr std::size_t query_count = 4;
+
+		explicit FrameBenchmark(std::uint64_t warmup, std::uint64_t frames = 0);
+
+		FrameBenchmark(const FrameBenchmark&) = delete;
+		FrameBenchmark& operator = (const FrameBenchmark&) = delete;
+
+		~FrameBenchmark();
+
+		void frameEnd();
+		void finish();
+
+		std::uint64_t frames() const noexcept
+		{
+			return mFrame;
+		}
+
+		std::uint64_t warmup() const noexcept
+		{
+			return mWarmup;
+		}
+
+		const std::vector<double>& cpuMs() const noexcept
+		{
+			return mCpuMs;
+		}
+
+		const std::vector<double>& gpuMs() const noexcept
+		{
+			return mGpuMs;
+		}
+
+	private:
+		void collect(std::size_t slot);
+
+	private:
+		using Clock = std::chrono::steady_clock;
+
+		std::uint64_t mWarmup;
+		std::uint64_t mFrame = 0;
+		Clock::time_point mFrameStart;
+
+		std::array<GLuint, query_count> mQueries{};
+		std::array<std::uint64_t, query_count> mQueryFrames{};
+		std::array<bool, query_count> mPending{};
+		std::size_t mSlot = 0;
+		bool mFinished = false;
+
+		std::vector<double> mCpuMs;
+		std::vector<double> mGpuMs;
+	};
+
+} // glsl
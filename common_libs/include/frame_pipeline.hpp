@@ -0,0 +1,124 @@
+#pragma once
+
+#include <jobs.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace common {
+
+	// Overlaps the CPU side of the next frames with the submission of the
+	// current one. State is kept in framesInFlight slots: while the calling
+	// (render) thread submits frame N from its slot, simulate() for frames
+	// N+1 .. N+framesInFlight-1 runs as jobs writing the slots ahead of it.
+	// Each simulation sees the state of the frame before it and starts only
+	// once that one is finished.
+	template <typename State>
+	class FramePipeline {
+	public:
+		struct Stats {
+			std::uint64_t frames = 0;
+			double simulateMs = 0.0;
+			double renderMs = 0.0;
+			double frameMs = 0.0;
+
+			// time saved compared to running simulation and rendering back to back
+			double overlapMs() const noexcept
+			{
+				return std::max(0.0, simulateMs + renderMs - frameMs);
+			}
+		};
+
+		FramePipeline(JobSystem& jobs, std::size_t framesInFlight = 2, const State& initial = State{})
+			: mJobs(jobs)
+			, mStates(framesInFlight, initial)
+			, mSimulateMs(framesInFlight, 0.0)
+			, mCounters(framesInFlight)
+		{
+			if (framesInFlight < 2)
+				throw std::invalid_argument{ "FramePipeline needs at least two frames in flight" };
+
+			for (auto& c : mCounters)
+				c = std::make_unique<JobCounter>();
+		}
+
+		FramePipeline(const FramePipeline&) = delete;
+		FramePipeline& operator = (const FramePipeline&) = delete;
+
+		~FramePipeline()
+		{
+			for (auto& c : mCounters)
+				mJobs.wait(*c);
+		}
+
+		// simulate(State& next, const State& previous, std::uint64_t frame) runs on
+		// a job and must be copyable, and small enough to fit a Job next to four
+		// words of its own; render(const State&, std::uint64_t frame) runs on the
+		// calling thread.
+		template <typename Simulate, typename Render>
+		void frame(const Simulate& simulate, Render&& render)
+		{
+			using clock = std::chrono::steady_clock;
+			const auto start = clock::now();
+
+			while (mKicked < mFrame + mStates.size())
+				kick(mKicked++, simulate);
+
+			const auto slot = mFrame % mStates.size();
+			mJobs.wait(*mCounters[slot]);
+
+			const auto renderStart = clock::now();
+			render(static_cast<const State&>(mStates[slot]), mFrame);
+			const auto stop = clock::now();
+
+			mStats.frames++;
+			mStats.simulateMs += mSimulateMs[slot];
+			mStats.renderMs += std::chrono::duration<double, std::milli>(stop - renderStart).count();
+			mStats.frameMs += std::chrono::duration<double, std::milli>(stop - start).count();
+
+			// the slot is free again, the next kick will refill it
+			++mFrame;
+		}
+
+		const Stats& stats() const noexcept
+		{
+			return mStats;
+		}
+
+		std::size_t framesInFlight() const noexcept
+		{
+			return mStates.size();
+		}
+
+	private:
+		template <typename Simulate>
+		void kick(std::uint64_t frame, const Simulate& simulate)
+		{
+			const auto count = mStates.size();
+			const auto slot = frame % count;
+			const auto previous = (frame + count - 1) % count;
+
+			auto job = [this, simulate, frame, slot, previous]
+			{
+				const auto start = std::chrono::steady_clock::now();
+				simulate(mStates[slot], static_cast<const State&>(mStates[previous]), frame);
+				mSimulateMs[slot] = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+			};
+
+			mJobs.runAfter(*mCounters[previous], job, mCounters[slot].get());
+		}
+
+	private:
+		JobSystem& mJobs;
+		std::vector<State> mStates;
+		std::vector<double> mSimulateMs;
+		std::vector<std::unique_ptr<JobCounter>> mCounters;
+		std::uint64_t mFrame = 0;
+		std::uint64_t mKicked = 0;
+		Stats mStats;
+	};
+
+} // common
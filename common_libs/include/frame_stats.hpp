@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace common {
+
+	struct TimingSummary {
+		std::size_t count = 0;
+		double min = 0.0;
+		double mean = 0.0;
+		double p50 = 0.0;
+		double p95 = 0.0;
+		double p99 = 0.0;
+		double max = 0.0;
+	};
+
+	// Percentiles interpolate linearly between the two closest samples. An
+	// empty input gives an all zero summary.
+	TimingSummary summarize(std::vector<double> samples);
+
+	// Writes the summary as one JSON object:
+	// {"count":..,"min":..,"mean":..,"p50":..,"p95":..,"p99":..,"max":..}
+	void writeJson(std::ostream& out, const TimingSummary& summary);
+
+	// Writes text as a quoted JSON string.
+	void writeJson(std::ostream& out, const std::string& text);
+
+} // common
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <gl_objects.hpp>
+#include <offset_allocator.hpp>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+namespace glsl {
+
+	// Where a mesh landed inside a GeometryArena.
+	struct MeshRange {
+		std::uint32_t page = 0;
+		GLint baseVertex = 0;
+		GLuint firstIndex = 0;
+		GLsizei indexCount = 0;
+		GLsizei vertexCount = 0;
+		common::OffsetAllocator::Allocation vertices;
+		common::OffsetAllocator::Allocation indices;
+	};
+
+	// Suballocates static geometry out of a few large immutable buffers. All
+	// meshes share one vertex layout; each page is a vertex buffer, a 32-bit
+	// index buffer and the one VAO that reads them, so every mesh of a page is
+	// drawn from the same VAO with baseVertex/firstIndex offsets. Indices stay
+	// relative to their own mesh. A new page is added when a mesh does not fit.
+	class GeometryArena {
+	public:
+		struct Stats {
+			std::uint32_t pages = 0;
+			common::OffsetAllocator::Stats vertices;
+			common::OffsetAllocator::Stats indices;
+		};
+
+		GeometryArena(VertexLayout layout, std::uint32_t verticesPerPage = 1 << 20, std::uint32_t indicesPerPage = 1 << 22);
+
+		MeshRange add(const void* vertices, GLsizei vertexCount, const GLuint* indices, GLsizei indexCount);
+
+		template <typename Vertices, typename Indices>
+		MeshRange add(const Vertices& vertices, const Indices& indices)
+		{
+			return add(std::data(vertices), static_cast<GLsizei>(std::size(vertices)),
+				std::data(indices), static_cast<GLsizei>(std::size(indices)));
+		}
+
+		void remove(const MeshRange& mesh);
+
+		std::size_t pageCount() const noexcept
+		{
+			return mPages.size();
+		}
+
+		const VertexArray& vertexArray(std::uint32_t page) const
+		{
+			return mPages[page]->vao;
+		}
+
+		const VertexLayout& layout() const noexcept
+		{
+			return mLayout;
+		}
+
+		// Binds the page's VAO and issues one glDrawElementsBaseVertex.
+		void draw(const MeshRange& mesh, GLenum mode = GL_TRIANGLES) const;
+
+		// Summed over pages; largestFree is the largest block of any page.
+		Stats stats() const;
+
+	private:
+		struct Page {
+			Page(const VertexLayout& layout, std::uint32_t vertexCount, std::uint32_t indexCount);
+
+			Buffer vertexBuffer;
+			Buffer indexBuffer;
+			VertexArray vao;
+			common::OffsetAllocator vertexSpace;
+			common::OffsetAllocator indexSpace;
+		};
+
+	private:
+		VertexLayout mLayout;
+		std::uint32_t mVerticesPerPage;
+		std::uint32_t mIndicesPerPage;
+		std::vector<std::unique_ptr<Page>> mPages;
+	};
+
+} // glsl
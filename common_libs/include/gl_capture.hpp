@@ -0,0 +1,128 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace glsl {
+
+	struct GlReplayState;
+
+	// Records every GL call made through glad into a compact binary file
+	// that GlReplay plays back. start() hooks the glad_gl* pointers the way
+	// GlCallTrace does; each call is written as its arguments plus the data
+	// they point at: buffer and texture uploads, uniform arrays, shader
+	// sources, name lists and the contents of mapped buffer ranges when they
+	// are flushed or unmapped. Object names and sync objects a replay gets
+	// back from GL are mapped onto the captured ones, so the replay does not
+	// depend on GL handing out the same names.
+	//
+	// Calls with a pointer the capture cannot size (client side vertex
+	// arrays, debug callbacks, ..) are made but not recorded; writeReport()
+	// lists them. Writes through a persistent mapping are only seen when
+	// they are flushed, so mapping a range for persistent writes that is
+	// coherent or lacks GL_MAP_FLUSH_EXPLICIT_BIT, as SpriteBatch does,
+	// throws std::runtime_error while capturing instead of recording a
+	// stream that replays stale data. Uniform locations are replayed as
+	// captured, which holds on the driver the capture was made with.
+	// Everything here belongs to the GL thread.
+	class GlCapture {
+	public:
+		static GlCapture& instance();
+
+		GlCapture(const GlCapture&) = delete;
+		GlCapture& operator = (const GlCapture&) = delete;
+
+		~GlCapture();
+
+		// Throws std::runtime_error if the file cannot be written.
+		void start(const std::string& path, int width, int height);
+
+		// Writes the rest of the file and unhooks; throws std::runtime_error
+		// if the file could not be written.
+		void stop();
+
+		bool capturing() const noexcept;
+
+		void frameEnd();
+
+		std::uint64_t frames() const noexcept;
+		std::uint64_t calls() const noexcept;
+		std::uint64_t bytes() const noexcept;
+
+		// Calls made while capturing that are missing from the file.
+		std::uint64_t skipped() const noexcept;
+
+		void writeReport(std::ostream& out) const;
+
+	private:
+		GlCapture() = default;
+	};
+
+	// Plays a GlCapture file back on the current context, a frame at a
+	// time, as fast as the context takes the calls. The file is read whole
+	// up front; the calls go through the glad pointers of the moment, so a
+	// GlCallTrace enabled around the replay counts them. Throws
+	// std::runtime_error for a file it cannot read or a call the context
+	// does not have.
+	class GlReplay {
+	public:
+		explicit GlReplay(const std::string& path);
+
+		GlReplay(const GlReplay&) = delete;
+		GlReplay& operator = (const GlReplay&) = delete;
+
+		~GlReplay();
+
+		int width() const noexcept
+		{
+			return mWidth;
+		}
+
+		int height() const noexcept
+		{
+			return mHeight;
+		}
+
+		// Frames and calls in the file; 0 if the capture was not stopped.
+		std::uint64_t frames() const noexcept
+		{
+			return mFrames;
+		}
+
+		std::uint64_t calls() const noexcept
+		{
+			return mCalls;
+		}
+
+		// What framebuffer 0 of the capture is drawn into, the headless FBO
+		// of AppContext for instance.
+		void setDefaultFramebuffer(GLuint framebuffer) noexcept
+		{
+			mDefaultFramebuffer = framebuffer;
+		}
+
+		// Plays the calls up to the end of the next frame; false once the
+		// file is done.
+		bool playFrame();
+
+		std::uint64_t played() const noexcept
+		{
+			return mPlayed;
+		}
+
+	private:
+		std::vector<unsigned char> mFile;
+		int mWidth = 0;
+		int mHeight = 0;
+		std::uint64_t mFrames = 0;
+		std::uint64_t mCalls = 0;
+		std::uint64_t mPlayed = 0;
+		GLuint mDefaultFramebuffer = 0;
+		std::unique_ptr<GlReplayState> mState;
+	};
+
+} // glsl
\ No newline at end of file
@@ -0,0 +1,170 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <iterator>
+#include <vector>
+
+namespace glsl {
+
+	// Move-only owners of GL objects, created and edited with the GL 4.5
+	// direct state access entry points so setting them up never disturbs the
+	// current bindings. The destructors delete the object and tell GLState.
+
+	class Buffer {
+	public:
+		// Immutable storage; flags are the glNamedBufferStorage flags.
+		Buffer(GLsizeiptr size, const void* data, GLbitfield flags = 0);
+
+		template <typename Container>
+		explicit Buffer(const Container& data, GLbitfield flags = 0)
+			: Buffer(static_cast<GLsizeiptr>(std::size(data) * sizeof(*std::data(data))), std::data(data), flags)
+		{
+		}
+
+		Buffer(Buffer&& rhs) noexcept;
+		Buffer(const Buffer&) = delete;
+
+		Buffer& operator = (const Buffer&) = delete;
+		Buffer& operator = (Buffer&& rhs) noexcept;
+
+		~Buffer();
+
+		operator GLuint() const noexcept
+		{
+			return mBuffer;
+		}
+
+		GLsizeiptr size() const noexcept
+		{
+			return mSize;
+		}
+
+		// Needs GL_DYNAMIC_STORAGE_BIT.
+		void subData(GLintptr offset, GLsizeiptr size, const void* data);
+
+		void* mapRange(GLintptr offset, GLsizeiptr length, GLbitfield access);
+		void unmap();
+
+		void bind(GLenum target) const;
+		void bindBase(GLenum target, GLuint index) const;
+
+	private:
+		GLuint mBuffer;
+		GLsizeiptr mSize;
+	};
+
+	struct VertexAttribute {
+		GLuint location;
+		GLint components;
+		GLenum type;
+		GLuint offset;
+		bool normalized = false;
+	};
+
+	// Interleaved layout of one vertex buffer binding.
+	struct VertexLayout {
+		GLsizei stride;
+		std::vector<VertexAttribute> attributes;
+	};
+
+	class VertexArray {
+	public:
+		VertexArray();
+		VertexArray(VertexArray&& rhs) noexcept;
+		VertexArray(const VertexArray&) = delete;
+
+		VertexArray& operator = (const VertexArray&) = delete;
+		VertexArray& operator = (VertexArray&& rhs) noexcept;
+
+		~VertexArray();
+
+		operator GLuint() const noexcept
+		{
+			return mVao;
+		}
+
+		void vertexBuffer(GLuint binding, const Buffer& buffer, GLintptr offset, GLsizei stride);
+
+		// A divisor of 1 advances the binding once per instance.
+		void bindingDivisor(GLuint binding, GLuint divisor);
+		void elementBuffer(const Buffer& buffer);
+
+		// Enables the attribute and sources it from a vertex buffer binding.
+		void attribute(GLuint index, GLuint binding, GLint size, GLenum type, GLuint relativeOffset = 0, bool normalized = false);
+
+		// Sets up every attribute of layout to read from binding.
+		void format(GLuint binding, const VertexLayout& layout);
+
+		void bind() const;
+
+	private:
+		GLuint mVao;
+	};
+
+	class Texture {
+	public:
+		explicit Texture(GLenum target = GL_TEXTURE_2D);
+		Texture(Texture&& rhs) noexcept;
+		Texture(const Texture&) = delete;
+
+		Texture& operator = (const Texture&) = delete;
+		Texture& operator = (Texture&& rhs) noexcept;
+
+		~Texture();
+
+		operator GLuint() const noexcept
+		{
+			return mTexture;
+		}
+
+		GLenum target() const noexcept
+		{
+			return mTarget;
+		}
+
+		void storage2D(GLsizei levels, GLenum internalFormat, GLsizei width, GLsizei height);
+
+		// For 3D and array textures; depth is the layer count of an array.
+		void storage3D(GLsizei levels, GLenum internalFormat, GLsizei width, GLsizei height, GLsizei depth);
+		void subImage2D(GLint level, GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, const void* pixels);
+		void generateMipmap();
+
+		void parameter(GLenum name, GLint value);
+		void parameter(GLenum name, GLfloat value);
+
+		void bind(GLuint unit) const;
+
+	private:
+		GLuint mTexture;
+		GLenum mTarget;
+	};
+
+	class Sampler {
+	public:
+		Sampler();
+		Sampler(Sampler&& rhs) noexcept;
+		Sampler(const Sampler&) = delete;
+
+		Sampler& operator = (const Sampler&) = delete;
+		Sampler& operator = (Sampler&& rhs) noexcept;
+
+		~Sampler();
+
+		operator GLuint() const noexcept
+		{
+			return mSampler;
+		}
+
+		void parameter(GLenum name, GLint value);
+		void parameter(GLenum name, GLfloat value);
+
+		void bind(GLuint unit) const;
+
+	private:
+		GLuint mSampler;
+	};
+
+	// Number of mip levels of a full chain for the given size.
+	GLsizei mipLevels(GLsizei width, GLsizei height) noexcept;
+
+} // glsl
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <array>
+#include <cstdint>
+
+namespace glsl {
+
+	// Shadow copy of the binding and enable state of the current context.
+	// Every setter compares against the shadow and only reaches the driver
+	// when the value changes. State starts out unknown, so the first call to
+	// each setter always goes through; call invalidate() after any GL code
+	// that binds behind the cache's back.
+	class GLState {
+	public:
+		static constexpr std::size_t max_texture_units = 32;
+
+		// The state of the context current on this thread.
+		static GLState& current();
+
+		GLState();
+
+		void invalidate() noexcept;
+
+		void useProgram(GLuint program);
+		void bindVertexArray(GLuint vao);
+		void bindBuffer(GLenum target, GLuint buffer);
+
+		// Indexed bindings are not shadowed, so this always reaches the driver;
+		// it only records the generic binding glBindBufferBase also changes.
+		void bindBufferBase(GLenum target, GLuint index, GLuint buffer);
+		void bindTexture(GLuint unit, GLenum target, GLuint texture);
+		void bindSampler(GLuint unit, GLuint sampler);
+
+		void enable(GLenum cap);
+		void disable(GLenum cap);
+		void setEnabled(GLenum cap, bool enabled);
+
+		// Core profile only accepts GL_FRONT_AND_BACK.
+		void polygonMode(GLenum mode);
+
+		GLuint program() const noexcept
+		{
+			return mProgram;
+		}
+
+		// Deleted objects are unbound by GL, these keep the shadow in step.
+		void forgetProgram(GLuint program) noexcept;
+		void forgetVertexArray(GLuint vao) noexcept;
+		void forgetBuffer(GLuint buffer) noexcept;
+		void forgetTexture(GLuint texture) noexcept;
+		void forgetSampler(GLuint sampler) noexcept;
+
+		std::uint64_t callsIssued() const noexcept
+		{
+			return mIssued;
+		}
+
+		std::uint64_t callsSkipped() const noexcept
+		{
+			return mSkipped;
+		}
+
+		void resetCounters() noexcept
+		{
+			mIssued = mSkipped = 0;
+		}
+
+	private:
+		static constexpr GLuint unknown = ~GLuint{ 0 };
+
+		static constexpr std::array<GLenum, 14> buffer_targets{
+			GL_ARRAY_BUFFER, GL_ELEMENT_ARRAY_BUFFER, GL_UNIFORM_BUFFER,
+			GL_SHADER_STORAGE_BUFFER, GL_DRAW_INDIRECT_BUFFER, GL_DISPATCH_INDIRECT_BUFFER,
+			GL_PARAMETER_BUFFER, GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+			GL_PIXEL_PACK_BUFFER, GL_PIXEL_UNPACK_BUFFER, GL_ATOMIC_COUNTER_BUFFER,
+			GL_QUERY_BUFFER, GL_TEXTURE_BUFFER
+		};
+
+		static constexpr std::array<GLenum, 8> texture_targets{
+			GL_TEXTURE_2D, GL_TEXTURE_2D_ARRAY, GL_TEXTURE_3D, GL_TEXTURE_CUBE_MAP,
+			GL_TEXTURE_1D, GL_TEXTURE_BUFFER, GL_TEXTURE_RECTANGLE, GL_TEXTURE_2D_MULTISAMPLE
+		};
+
+		static constexpr std::array<GLenum, 13> caps{
+			GL_DEPTH_TEST, GL_BLEND, GL_CULL_FACE, GL_SCISSOR_TEST, GL_STENCIL_TEST,
+			GL_POLYGON_OFFSET_FILL, GL_MULTISAMPLE, GL_FRAMEBUFFER_SRGB,
+			GL_PRIMITIVE_RESTART, GL_RASTERIZER_DISCARD, GL_DEPTH_CLAMP,
+			GL_PROGRAM_POINT_SIZE, GL_TEXTURE_CUBE_MAP_SEAMLESS
+		};
+
+		enum class Cap : std::uint8_t { off, on, unknown };
+
+		template <std::size_t N>
+		static int indexOf(const std::array<GLenum, N>& values, GLenum value) noexcept
+		{
+			for (std::size_t i = 0; i < N; ++i)
+				if (values[i] == value)
+					return static_cast<int>(i);
+			return -1;
+		}
+
+		bool skip(bool same) noexcept
+		{
+			if (same)
+				++mSkipped;
+			else
+				++mIssued;
+			return same;
+		}
+
+		void activeTexture(GLuint unit);
+
+	private:
+		GLuint mProgram;
+		GLuint mVertexArray;
+		GLuint mActiveUnit;
+		GLenum mPolygonMode;
+		std::array<GLuint, buffer_targets.size()> mBuffers;
+		std::array<std::array<GLuint, texture_targets.size()>, max_texture_units> mTextures;
+		std::array<GLuint, max_texture_units> mSamplers;
+		std::array<Cap, caps.size()> mCaps;
+		std::uint64_t mIssued = 0;
+		std::uint64_t mSkipped = 0;
+	};
+
+} // glsl
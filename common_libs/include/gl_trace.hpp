@@ -0,0 +1,90 @@
+#pragma once
+
+#include <frame_stats.hpp>
+#include <glad/glad.h>
+#include <array>
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+namespace glsl {
+
+	enum class GlCallCategory : std::uint8_t { draw, bind, uniform, upload, other };
+
+	constexpr std::size_t gl_call_category_count = 5;
+
+	struct GlCallCount {
+		const char* name;
+		std::uint64_t calls;
+		double ms;                      // 0 unless timing
+	};
+
+	// Counts every GL call made through glad. enable() swaps each loaded
+	// glad_gl* pointer for a wrapper that bumps the entry point's counter
+	// (and times it when asked) before calling the original; disable() puts
+	// the originals back. While disabled the pointers are glad's own, so the
+	// layer costs nothing. Entry points that did not load stay null.
+	//
+	// frameEnd() closes a frame: the calls of every category since the last
+	// one are kept as that frame's counts. enable() again after gladLoad*
+	// reloads the pointers. Everything here belongs to the GL thread.
+	class GlCallTrace {
+	public:
+		// Frames the histograms cover, the newest ones; enable() makes room
+		// for them so that closing a frame never allocates.
+		static constexpr std::size_t history_frames = 16384;
+
+		static GlCallTrace& instance();
+
+		GlCallTrace(const GlCallTrace&) = delete;
+		GlCallTrace& operator = (const GlCallTrace&) = delete;
+
+		void enable(bool timing = false);
+		void disable();
+
+		bool enabled() const noexcept
+		{
+			return mEnabled;
+		}
+
+		void frameEnd();
+
+		std::uint64_t frames() const noexcept
+		{
+			return mFrames;
+		}
+
+		// Calls of one category in the last closed frame.
+		std::uint64_t lastFrame(GlCallCategory category) const noexcept
+		{
+			return mLastFrame[static_cast<std::size_t>(category)];
+		}
+
+		// Per frame counts of a category over the last history_frames closed
+		// frames.
+		common::TimingSummary histogram(GlCallCategory category) const;
+
+		// Entry points by total calls, busiest first.
+		std::vector<GlCallCount> busiest(std::size_t count) const;
+
+		void reset();
+
+		// {"frames":..,"draw":{summary},"bind":..,"uniform":..,"upload":..,
+		//  "other":..,"busiest":[{"name":..,"calls":..,"ms":..},..]}
+		void writeJson(std::ostream& out, std::size_t busiestCount = 10) const;
+
+		void writeReport(std::ostream& out, std::size_t busiestCount = 10) const;
+
+		static const char* categoryName(GlCallCategory category) noexcept;
+
+	private:
+		GlCallTrace() = default;
+
+	private:
+		bool mEnabled = false;
+		std::uint64_t mFrames = 0;
+		std::array<std::uint64_t, gl_call_category_count> mLastFrame{};
+		std::array<std::vector<double>, gl_call_category_count> mPerFrame;
+	};
+
+} // glsl
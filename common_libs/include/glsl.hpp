@@ -1,22 +1,31 @@
 #pragma once
 
 #include <glad/glad.h>
+#include <cpu_profiler.hpp>
+#include <gl_state.hpp>
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
+#include <functional>
 #include <initializer_list>
 #include <string>
+#include <string_view>
 #include <map>
 
 namespace glsl {
 	
 	enum ShaderType : GLenum {
 		vertex_shader = GL_VERTEX_SHADER,
-		fragment_shader = GL_FRAGMENT_SHADER
+		fragment_shader = GL_FRAGMENT_SHADER,
+		compute_shader = GL_COMPUTE_SHADER
 	};
 
 	class Shader {
 	public:
 		Shader(ShaderType type, const std::string& filename);
+
+		// Compiles the file with prelude spliced in right after its #version
+		// line, e.g. declarations generated at run time.
+		Shader(ShaderType type, const std::string& filename, const std::string& prelude);
 		Shader(Shader&& rhs);
 		Shader(Shader&) = delete;
 
@@ -45,34 +54,42 @@ namespace glsl {
 		
 		~Program();
 
-		void use() noexcept
+		operator GLuint() const noexcept
+		{
+			return mProgram;
+		}
+
+		void use()
 		{
-			glUseProgram(mProgram);
+			GLState::current().useProgram(mProgram);
 		}
 
-		void unuse() noexcept
+		void unuse()
 		{
-			glUseProgram(0);
+			GLState::current().useProgram(0);
 		}
 
-		void uniform(std::string str, GLuint val)
+		// Locations are looked up on a name's first use and cached, so later
+		// calls neither query GL nor allocate.
+		void uniform(std::string_view name, GLuint val)
 		{
-			m_uniformMap.insert_or_assign(str, uniformLocation(str));
-			glUniform1i(m_uniformMap[str], val);
+			COMMON_PROFILE_SCOPE("Program::uniform");
+			glUniform1i(location(name), val);
 		}
 
-		void uniform(std::string str, const glm::mat4& mat)
+		void uniform(std::string_view name, const glm::mat4& mat)
 		{
-			m_uniformMap.insert_or_assign(str, uniformLocation(str));
-			glUniformMatrix4fv(m_uniformMap[str], 1, GL_FALSE, glm::value_ptr(mat));
+			COMMON_PROFILE_SCOPE("Program::uniform");
+			glUniformMatrix4fv(location(name), 1, GL_FALSE, glm::value_ptr(mat));
 		}
 
 	private:
+		GLint location(std::string_view name);
 		GLint uniformLocation(const std::string& str);
 
 	private:
 		GLuint mProgram;
-		std::map<std::string, GLint> m_uniformMap;
+		std::map<std::string, GLint, std::less<>> m_uniformMap;
 	};
 
 } // glsl
\ No newline at end of file
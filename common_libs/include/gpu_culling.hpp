@@ -0,0 +1,76 @@
+#pragma once
+
+#include <bounds.hpp>
+#include <geometry_arena.hpp>
+#include <gl_objects.hpp>
+#include <glsl.hpp>
+#include <indirect_draw.hpp>
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace glsl {
+
+	// One entry of the bounds SSBO, std430 layout.
+	struct CullBounds {
+		glm::vec4 center;
+		glm::vec4 halfExtent;
+	};
+
+	// Frustum culls the draws of an IndirectDrawBatch in a compute shader and
+	// writes the survivors to its own indirect buffer, so the CPU never reads
+	// back which objects are visible.
+	//
+	// With glMultiDrawElementsIndirectCount the survivors are compacted by an
+	// atomic counter that the draw then uses as its count. Without it (GL 4.3 -
+	// 4.5, e.g. llvmpipe) every command is kept in place and the culled ones get
+	// instanceCount 0. baseInstance is copied through either way, so the
+	// batch's draw index attribute still leads the vertex shader to its
+	// DrawData in the batch's SSBO.
+	class GpuCuller {
+	public:
+		explicit GpuCuller(std::uint32_t maxDraws, const std::string& shader = "resources/shaders/gpu_cull.comp");
+
+		// World space bounds, one per draw in the order they were added.
+		void setBounds(const std::vector<common::Aabb>& bounds);
+
+		// Culls what the batch uploaded last against frustum.
+		void cull(const IndirectDrawBatch& batch, const common::Frustum& frustum);
+
+		// Draws the survivors of the last cull().
+		void submit(const GeometryArena& arena, const IndirectDrawBatch& batch, GLenum mode = GL_TRIANGLES, GLuint dataBinding = 0) const;
+
+		bool compacting() const noexcept
+		{
+			return mCompact;
+		}
+
+		// Waits for the GPU; meant for checks and debugging only.
+		std::uint32_t readVisibleCount() const;
+
+		const Buffer& visibleCommandBuffer() const noexcept
+		{
+			return mVisibleBuffer;
+		}
+
+		const Buffer& countBuffer() const noexcept
+		{
+			return mCountBuffer;
+		}
+
+	private:
+		std::uint32_t mMaxDraws;
+		std::uint32_t mCulled = 0;
+		bool mCompact;
+		Program mProgram;
+		GLint mPlanesLocation;
+		GLint mDrawCountLocation;
+		GLint mCompactLocation;
+		std::vector<CullBounds> mBounds;
+		Buffer mBoundsBuffer;
+		Buffer mVisibleBuffer;
+		Buffer mCountBuffer;
+	};
+
+} // glsl
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace glsl {
+
+	// Times nested GPU scopes with GL_TIMESTAMP queries. Every frame in flight
+	// has its own set of queries; endFrame() moves on to the next set and
+	// collects the one it is about to reuse, so results arrive latency - 1
+	// frames late and reading them normally never waits on the GPU (stalls()
+	// counts the times it had to).
+	//
+	// Scope names must outlive the profiler (string literals). A scope's path
+	// is its name below the names of the scopes around it, e.g. "frame/queue".
+	// Each path gets an index the first time begin() sees it; history() keeps
+	// every collected time per path for the benchmark report.
+	class GpuProfiler {
+	public:
+		struct ScopeResult {
+			const char* name;
+			std::int32_t parent;        // index into the same results, -1 at the top
+			std::uint32_t depth;
+			double ms;
+		};
+
+		struct ScopeHistory {
+			std::string path;
+			std::vector<double> ms;
+		};
+
+		class Scope {
+		public:
+			explicit Scope(GpuProfiler& profiler) noexcept
+				: mProfiler{ profiler }
+			{
+			}
+
+			Scope(const Scope&) = delete;
+			Scope& operator = (const Scope&) = delete;
+
+			~Scope()
+			{
+				mProfiler.end();
+			}
+
+		private:
+			GpuProfiler& mProfiler;
+		};
+
+		explicit GpuProfiler(std::size_t latency = 4);
+
+		GpuProfiler(const GpuProfiler&) = delete;
+		GpuProfiler& operator = (const GpuProfiler&) = delete;
+
+		~GpuProfiler();
+
+		void begin(const char* name);
+		void end();
+
+		// auto scope = profiler.scope("shadows");
+		Scope scope(const char* name)
+		{
+			begin(name);
+			return Scope{ *this };
+		}
+
+		void endFrame();
+
+		// Collects every frame still in flight, waiting for the GPU.
+		void finish();
+
+		// The scopes of the newest collected frame, parents before children.
+		const std::vector<ScopeResult>& results() const noexcept
+		{
+			return mResults;
+		}
+
+		std::uint64_t resultFrame() const noexcept
+		{
+			return mResultFrame;
+		}
+
+		std::uint64_t stalls() const noexcept
+		{
+			return mStalls;
+		}
+
+		// One entry per path, in the order they were first seen.
+		const std::vector<ScopeHistory>& history() const noexcept
+		{
+			return mHistory;
+		}
+
+		// Frames before this one are left out of the history, which makes room
+		// for frames times per path.
+		void setHistoryStart(std::uint64_t frame, std::size_t frames = 0) noexcept
+		{
+			mHistoryStart = frame;
+			mHistoryFrames = frames;
+		}
+
+		// "frame 1.20 ms, frame/queue 0.85 ms" for the newest collected frame.
+		std::string summary() const;
+
+		// {"frame":{summary},"frame/queue":{summary}} over the whole history.
+		void writeJson(std::ostream& out) const;
+
+	private:
+		struct PendingScope {
+			const char* name;
+			std::int32_t parent;
+			std::uint32_t depth;
+			std::uint32_t query;        // begin timestamp; the end one follows it
+			std::uint32_t path;         // index into mHistory
+		};
+
+		struct PathKey {
+			const char* name;
+			std::int32_t parent;        // path index, -1 at the top
+		};
+
+		struct Frame {
+			std::vector<GLuint> queries;
+			std::vector<PendingScope> scopes;
+			std::uint64_t frame = 0;
+			bool pending = false;
+		};
+
+		std::uint32_t pathIndex(const char* name, std::int32_t parentPath);
+		void collect(Frame& frame);
+
+	private:
+		std::vector<Frame> mFrames;
+		std::size_t mCurrent = 0;
+		std::uint64_t mFrame = 0;
+		std::vector<std::int32_t> mOpen;
+
+		std::vector<ScopeResult> mResults;
+		std::vector<std::uint32_t> mResultPaths;
+		std::uint64_t mResultFrame = 0;
+		std::uint64_t mStalls = 0;
+		std::uint64_t mHistoryStart = 0;
+		std::size_t mHistoryFrames = 0;
+		std::vector<PathKey> mPathKeys;
+		std::vector<ScopeHistory> mHistory;
+	};
+
+} // glsl
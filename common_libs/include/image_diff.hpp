@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace common {
+
+	struct ImageDiff {
+		std::size_t pixels = 0;
+		std::size_t differing = 0;      // pixels with a channel past the tolerance
+		unsigned maxDelta = 0;          // largest difference of any channel
+		double mse = 0.0;               // mean squared channel difference
+		double psnr = 0.0;              // dB; infinity for identical images
+	};
+
+	// Compares two tightly packed RGBA8 images of the same size channel by
+	// channel. A pixel differs when any of its channels is further than
+	// tolerance from the other image's; PSNR is over all four channels with
+	// a peak of 255. Runs 16 bytes at a time with SSE2 where it is available.
+	ImageDiff diffRgba(const std::uint8_t* a, const std::uint8_t* b, std::size_t pixels, unsigned tolerance) noexcept;
+
+} // common
\ No newline at end of file
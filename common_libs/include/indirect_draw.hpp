@@ -0,0 +1,127 @@
+#pragma once
+
+#include <geometry_arena.hpp>
+#include <gl_objects.hpp>
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace glsl {
+
+	// Layout fixed by glMultiDrawElementsIndirect.
+	struct DrawElementsIndirectCommand {
+		GLuint count;
+		GLuint instanceCount;
+		GLuint firstIndex;
+		GLint baseVertex;
+		GLuint baseInstance;
+	};
+
+	// One entry of the per-draw SSBO, std430 layout. params is free for the
+	// shader's own per-draw values, e.g. a vertex format and offset.
+	struct DrawData {
+		glm::mat4 model;
+		glm::uvec4 params{ 0u };
+	};
+
+	// Submits many meshes of one GeometryArena page with a single
+	// glMultiDrawElementsIndirect. Each draw gets baseInstance = its index, and
+	// submit() feeds the sequence 0, 1, 2, .. to the VAO as an instanced
+	// attribute at draw_index_location. The base instance offsets instanced
+	// attributes (GL 4.2), so with
+	//   layout (location = 15) in uint drawIndex;
+	// the vertex shader finds its DrawData at draws[drawIndex] without any
+	// uniform updates between draws, and without gl_BaseInstance, which needs
+	// GLSL 4.60 or ARB_shader_draw_parameters.
+	//
+	// With useIndirectCount() the draw count is also read from a GPU buffer
+	// (GL 4.6 / ARB_indirect_parameters), which lets a compute pass decide how
+	// many of the commands actually run.
+	class IndirectDrawBatch {
+	public:
+		static constexpr GLuint draw_index_location = 15;
+		static constexpr GLuint draw_index_binding = 15;
+
+		explicit IndirectDrawBatch(std::uint32_t maxDraws);
+
+		void clear() noexcept;
+
+		// Returns the draw index. All meshes of a batch must share a page.
+		std::uint32_t add(const MeshRange& mesh, const glm::mat4& model);
+
+		// Adds a prepared command; its baseInstance is replaced by the draw index.
+		std::uint32_t add(DrawElementsIndirectCommand command, const DrawData& data);
+
+		std::uint32_t size() const noexcept
+		{
+			return static_cast<std::uint32_t>(mCommands.size());
+		}
+
+		std::uint32_t capacity() const noexcept
+		{
+			return mMaxDraws;
+		}
+
+		// What the GL buffers hold since the last upload().
+		std::uint32_t uploadedCount() const noexcept
+		{
+			return mUploaded;
+		}
+
+		std::uint32_t uploadedPage() const noexcept
+		{
+			return mUploadedPage;
+		}
+
+		// Copies the commands, draw data and count into their GL buffers.
+		void upload();
+
+		// Binds the page's VAO, the draw data at SSBO binding dataBinding and
+		// issues the multi-draw for everything uploaded last.
+		void submit(const GeometryArena& arena, GLenum mode = GL_TRIANGLES, GLuint dataBinding = 0) const;
+
+		// The same with any VAO that has the matching element buffer attached.
+		void submit(const VertexArray& vao, GLenum mode = GL_TRIANGLES, GLuint dataBinding = 0) const;
+
+		// Points the draw index attribute of vao at this batch, for callers
+		// that issue the multi-draw themselves.
+		void bindDrawIndex(const VertexArray& vao) const;
+
+		static bool indirectCountSupported() noexcept;
+
+		// Ignored when the context lacks glMultiDrawElementsIndirectCount.
+		void useIndirectCount(bool enabled) noexcept
+		{
+			mUseCount = enabled && indirectCountSupported();
+		}
+
+		const Buffer& commandBuffer() const noexcept
+		{
+			return mCommandBuffer;
+		}
+
+		const Buffer& drawDataBuffer() const noexcept
+		{
+			return mDrawDataBuffer;
+		}
+
+		const Buffer& countBuffer() const noexcept
+		{
+			return mCountBuffer;
+		}
+
+	private:
+		std::uint32_t mMaxDraws;
+		std::uint32_t mPage = 0;
+		std::uint32_t mUploaded = 0;
+		std::uint32_t mUploadedPage = 0;
+		bool mUseCount = false;
+		std::vector<DrawElementsIndirectCommand> mCommands;
+		std::vector<DrawData> mDrawData;
+		Buffer mCommandBuffer;
+		Buffer mDrawDataBuffer;
+		Buffer mCountBuffer;
+		Buffer mDrawIndexBuffer;
+	};
+
+} // glsl
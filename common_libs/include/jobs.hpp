@@ -0,0 +1,224 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace common {
+
+	class JobCounter;
+	class JobSystem;
+
+	// A queued task. The callable is kept inline, so a job needs no heap
+	// memory of its own; JobSystem hands them out of a preallocated pool.
+	struct Job {
+		static constexpr std::size_t storage_size = 192;
+
+		alignas(std::max_align_t) unsigned char storage[storage_size];
+		void (*run)(void* storage) = nullptr;       // calls the callable, then destroys it
+		void (*destroy)(void* storage) = nullptr;
+		JobCounter* counter = nullptr;
+		std::atomic<Job*> next{ nullptr };          // in the free list or a counter's continuations
+		Job* parkedPrev = nullptr;                  // in JobSystem's list of continuations
+		Job* parkedNext = nullptr;
+		bool pooled = false;
+	};
+
+	// Counts outstanding jobs. A counter handed to JobSystem::run() is
+	// incremented on submission and decremented when the job finishes; jobs
+	// queued with JobSystem::runAfter() are released once it drops to zero.
+	class JobCounter {
+	public:
+		JobCounter() = default;
+		JobCounter(const JobCounter&) = delete;
+		JobCounter& operator = (const JobCounter&) = delete;
+
+		bool done() const noexcept
+		{
+			return mValue.load(std::memory_order_acquire) == 0;
+		}
+
+	private:
+		friend class JobSystem;
+
+		std::atomic<int> mValue{ 0 };
+		std::mutex mMutex;
+		Job* mContinuations = nullptr;
+	};
+
+	// Work-stealing scheduler. Every worker owns a Chase-Lev deque: the owner
+	// pushes and pops at the bottom, idle workers steal from the top. The
+	// thread that creates the JobSystem is worker 0 and takes part in the work
+	// whenever it waits. Threads that are not workers submit through a shared
+	// locked queue.
+	//
+	// Jobs come from a pool of job_pool_size made up front, so once the
+	// shared queue has grown to its working size submitting allocates
+	// nothing. A callable has to fit Job::storage_size; capture large state
+	// by reference. Only when every pooled job is in flight does a job come
+	// from the heap.
+	class JobSystem {
+	public:
+		// threadCount includes the calling thread; 0 uses the hardware concurrency.
+		explicit JobSystem(unsigned threadCount = 0);
+
+		// Jobs still queued, and continuations still waiting on a counter,
+		// are dropped without running.
+		~JobSystem();
+
+		JobSystem(const JobSystem&) = delete;
+		JobSystem& operator = (const JobSystem&) = delete;
+
+		unsigned threadCount() const noexcept
+		{
+			return static_cast<unsigned>(mQueues.size());
+		}
+
+		// The calling thread's index among the workers, threadCount() on a
+		// thread that is not one of them.
+		unsigned workerIndex() const noexcept;
+
+		static constexpr std::size_t job_pool_size = 4096;
+
+		template <typename Fn>
+		void run(Fn&& task, JobCounter* counter = nullptr)
+		{
+			submit(makeJob(std::forward<Fn>(task), counter));
+		}
+
+		// Runs task once dependency reaches zero, signalling counter when done.
+		template <typename Fn>
+		void runAfter(JobCounter& dependency, Fn&& task, JobCounter* counter = nullptr)
+		{
+			runAfter(dependency, makeJob(std::forward<Fn>(task), counter));
+		}
+
+		// Executes other jobs until the counter reaches zero.
+		void wait(JobCounter& counter);
+
+		// Calls fn(begin, end) over [first, last) in chunks of at most grain
+		// items and returns when all of them are done. grain 0 picks a size
+		// that gives every thread a few chunks to balance with.
+		template <typename Fn>
+		void parallelFor(std::size_t first, std::size_t last, std::size_t grain, Fn&& fn)
+		{
+			if (first >= last)
+				return;
+
+			const auto count = last - first;
+			if (grain == 0)
+				grain = std::max<std::size_t>(1, count / (threadCount() * 4));
+
+			if (count <= grain)
+			{
+				fn(first, last);
+				return;
+			}
+
+			JobCounter counter;
+			for (auto begin = first; begin < last; begin += grain)
+			{
+				const auto end = std::min(last, begin + grain);
+				run([&fn, begin, end] { fn(begin, end); }, &counter);
+			}
+
+			wait(counter);
+		}
+
+	private:
+		class Deque {
+		public:
+			explicit Deque(std::size_t capacity);
+
+			bool push(Job* job) noexcept;
+			Job* pop() noexcept;
+			Job* steal() noexcept;
+
+		private:
+			std::atomic<std::int64_t> mTop{ 0 };
+			std::atomic<std::int64_t> mBottom{ 0 };
+			std::int64_t mMask;
+			std::unique_ptr<std::atomic<Job*>[]> mBuffer;
+		};
+
+		template <typename Fn>
+		Job* makeJob(Fn&& task, JobCounter* counter)
+		{
+			using Task = std::decay_t<Fn>;
+			static_assert(sizeof(Task) <= Job::storage_size, "the job's callable does not fit Job::storage_size, capture by reference");
+			static_assert(alignof(Task) <= alignof(std::max_align_t), "the job's callable is over-aligned");
+
+			auto job = acquire();
+			try
+			{
+				new (job->storage) Task(std::forward<Fn>(task));
+			}
+			catch (...)
+			{
+				release(job);
+				throw;
+			}
+
+			job->run = [](void* storage)
+			{
+				auto& task = *static_cast<Task*>(storage);
+				struct Destroy {
+					Task& task;
+					~Destroy() { task.~Task(); }
+				} destroy{ task };
+				task();
+			};
+			job->destroy = [](void* storage)
+			{
+				static_cast<Task*>(storage)->~Task();
+			};
+
+			job->counter = counter;
+			if (counter)
+				counter->mValue.fetch_add(1, std::memory_order_relaxed);
+
+			return job;
+		}
+
+		Job* acquire();
+		void release(Job* job) noexcept;
+
+		void runAfter(JobCounter& dependency, Job* job);
+		void park(Job* job) noexcept;
+		void unpark(Job* job) noexcept;
+		void submit(Job* job);
+		void execute(Job* job);
+		Job* findJob(unsigned self);
+		void workerLoop(unsigned index);
+
+	private:
+		std::vector<std::unique_ptr<Deque>> mQueues;
+		std::vector<std::thread> mThreads;
+
+		// head of the free list: a tag against ABA above, pool index + 1 below
+		std::unique_ptr<Job[]> mPool;
+		std::atomic<std::uint64_t> mFree{ 0 };
+
+		std::mutex mSharedMutex;
+		std::vector<Job*> mShared;
+
+		// every continuation parked on a counter, so they can be dropped too
+		std::mutex mParkedMutex;
+		Job* mParked = nullptr;
+
+		std::mutex mSleepMutex;
+		std::condition_variable mWake;
+		std::atomic<int> mQueued{ 0 };
+		std::atomic<bool> mStop{ false };
+	};
+
+} // common
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <bounds.hpp>
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace common {
+
+	struct MeshletLimits {
+		std::uint32_t maxVertices = 64;
+		std::uint32_t maxTriangles = 124;
+	};
+
+	// A cluster of at most MeshletLimits triangles, stored as a contiguous run
+	// of MeshletMesh::indices so it can be drawn as its own index range.
+	//
+	// The cone bounds the cluster's face normals: every triangle faces away
+	// from a viewer for whom
+	//   dot(center - eye, coneAxis) >= coneCutoff * |center - eye| + radius.
+	// A coneCutoff of 1 means the normals spread too far and the cluster is
+	// never backface culled.
+	struct Meshlet {
+		std::uint32_t firstIndex;
+		std::uint32_t triangleCount;
+		std::uint32_t vertexCount;
+		glm::vec3 center;
+		float radius;
+		glm::vec3 coneAxis;
+		float coneCutoff;
+	};
+
+	struct MeshletMesh {
+		std::vector<Meshlet> meshlets;
+		// The input triangles regrouped by meshlet, still indexing the input vertices.
+		std::vector<std::uint32_t> indices;
+	};
+
+	// Splits an indexed triangle list into meshlets by scanning the triangles
+	// in order and closing a meshlet when the next triangle would break either
+	// limit, so clusters are as coherent as the input order; run a vertex cache
+	// optimizer first for best results. Positions are three floats found every
+	// stride bytes from positions.
+	MeshletMesh buildMeshlets(const void* positions, std::size_t stride, std::size_t vertexCount,
+		const std::uint32_t* indices, std::size_t indexCount, const MeshletLimits& limits = {});
+
+	enum class MeshletVisibility : std::uint8_t { visible, outside, backfacing };
+
+	// Tests a meshlet placed by model against the frustum and the viewer at eye,
+	// all in world space. model may rotate, translate and scale uniformly.
+	MeshletVisibility cullMeshlet(const Meshlet& meshlet, const glm::mat4& model, const glm::vec3& eye, const Frustum& frustum) noexcept;
+
+} // common
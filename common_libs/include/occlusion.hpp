@@ -0,0 +1,97 @@
+#pragma once
+
+#include <bounds.hpp>
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace common {
+
+	class JobSystem;
+
+	// Software occlusion culling. A handful of large occluders are rasterized
+	// into a small depth buffer on the CPU, a max-depth (Hi-Z) pyramid is built
+	// on top of it and occludee bounds are tested against the pyramid before
+	// any draw call is issued. Depth is stored as NDC z remapped to [0, 1].
+	class OcclusionCuller {
+	public:
+		static constexpr int tile_width = 32;
+		static constexpr int tile_height = 16;
+
+		// The resolution is rounded up to a whole number of tiles. Without a
+		// JobSystem the tiles are rasterized on the calling thread.
+		OcclusionCuller(int width = 256, int height = 128, JobSystem* jobs = nullptr);
+
+		int width() const noexcept
+		{
+			return mWidth;
+		}
+
+		int height() const noexcept
+		{
+			return mHeight;
+		}
+
+		// Clears the occluder list and the depth buffer.
+		void beginFrame(const glm::mat4& viewProjection);
+
+		// Adds an indexed triangle list, transformed by model, to this frame's
+		// occluders. Nothing is rasterized until rasterize() is called.
+		// Triangles crossing the near plane or with non-finite vertices are
+		// dropped.
+		void addOccluder(const glm::vec3* vertices, std::size_t vertexCount,
+			const std::uint32_t* indices, std::size_t indexCount,
+			const glm::mat4& model);
+
+		// Bins the occluder triangles into screen tiles, rasterizes the tiles in
+		// parallel and rebuilds the Hi-Z pyramid.
+		void rasterize();
+
+		// false when the box is certainly hidden by the occluders or outside
+		// the viewport.
+		bool isVisible(const Aabb& bounds) const;
+
+		std::size_t levelCount() const noexcept
+		{
+			return mLevels.size();
+		}
+
+		const std::vector<float>& depth(std::size_t level = 0) const
+		{
+			return mLevels[level].depth;
+		}
+
+		std::size_t triangleCount() const noexcept
+		{
+			return mTriangles.size();
+		}
+
+	private:
+		struct Triangle {
+			float x[3];
+			float y[3];
+			float z[3];
+		};
+
+		struct Level {
+			int width;
+			int height;
+			std::vector<float> depth;
+		};
+
+		void rasterizeTile(std::size_t tile);
+		void buildPyramid();
+
+	private:
+		int mWidth;
+		int mHeight;
+		int mTilesX;
+		int mTilesY;
+		JobSystem* mJobs;
+		glm::mat4 mViewProjection;
+		std::vector<Triangle> mTriangles;
+		std::vector<std::vector<std::uint32_t>> mBins;
+		std::vector<Level> mLevels;
+	};
+
+} // common
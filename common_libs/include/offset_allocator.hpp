@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace common {
+
+	// Hands out ranges of an abstract [0, capacity) space, e.g. vertices or
+	// indices inside one big GPU buffer. Free blocks sit in 32 free lists
+	// bucketed by floor(log2(size)) with a bitmask of the non-empty ones, so
+	// allocation is a bit scan plus a pop. Every block also knows its address
+	// neighbours and freeing merges with them in constant time.
+	class OffsetAllocator {
+	public:
+		static constexpr std::uint32_t invalid = ~std::uint32_t{ 0 };
+
+		struct Allocation {
+			std::uint32_t offset = invalid;
+			std::uint32_t node = invalid;
+
+			explicit operator bool() const noexcept
+			{
+				return offset != invalid;
+			}
+		};
+
+		struct Stats {
+			std::uint32_t capacity = 0;
+			std::uint32_t used = 0;
+			std::uint32_t free = 0;
+			std::uint32_t largestFree = 0;
+			std::uint32_t freeBlocks = 0;
+			std::uint32_t allocations = 0;
+
+			// 0 when all free space is one block, towards 1 as it splinters
+			float fragmentation() const noexcept
+			{
+				return free ? 1.0f - static_cast<float>(largestFree) / free : 0.0f;
+			}
+		};
+
+		explicit OffsetAllocator(std::uint32_t capacity);
+
+		// An empty Allocation when no free block is large enough.
+		Allocation allocate(std::uint32_t size);
+		void free(const Allocation& allocation);
+
+		std::uint32_t sizeOf(const Allocation& allocation) const
+		{
+			return mNodes[allocation.node].size;
+		}
+
+		Stats stats() const;
+
+	private:
+		static constexpr std::uint32_t bucket_count = 32;
+
+		struct Node {
+			std::uint32_t offset;
+			std::uint32_t size;
+			std::uint32_t prev;
+			std::uint32_t next;
+			std::uint32_t binPrev;
+			std::uint32_t binNext;
+			bool used;
+		};
+
+		std::uint32_t newNode(std::uint32_t offset, std::uint32_t size, std::uint32_t prev, std::uint32_t next);
+		void insertFree(std::uint32_t node);
+		void removeFree(std::uint32_t node);
+
+	private:
+		std::uint32_t mCapacity;
+		std::uint32_t mUsed = 0;
+		std::uint32_t mAllocations = 0;
+		std::uint32_t mBucketMask = 0;
+		std::uint32_t mBuckets[bucket_count];
+		std::vector<Node> mNodes;
+		std::vector<std::uint32_t> mFreeNodes;
+	};
+
+} // common
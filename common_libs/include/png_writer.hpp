@@ -0,0 +1,16 @@
+#pragma once
+
+#include <iosfwd>
+#include <string>
+
+namespace common {
+
+	// Writes RGBA8 pixels as an 8 bit RGBA PNG. Rows are filtered and
+	// deflated with the fixed Huffman codes, which keeps the flat colors of
+	// rendered frames small without a zlib dependency. bottomUp takes rows
+	// in glReadPixels order. Throws std::runtime_error if the file cannot
+	// be written.
+	void writePng(std::ostream& out, int width, int height, const unsigned char* rgba, bool bottomUp = false);
+	void writePng(const std::string& path, int width, int height, const unsigned char* rgba, bool bottomUp = false);
+
+} // common
\ No newline at end of file
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace common {
+
+	class JobSystem;
+
+	struct SortItem {
+		std::uint64_t key;
+		std::uint32_t index;
+	};
+
+	// Stable LSD radix sort on the 64-bit keys, one byte per pass. Passes over
+	// bytes that are the same in every key are skipped. With a job system the
+	// histogram and scatter of each pass are split across its threads.
+	void radixSort(std::vector<SortItem>& items, std::vector<SortItem>& scratch, JobSystem* jobs = nullptr);
+
+} // common
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <radix_sort.hpp>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace common {
+	class JobSystem;
+}
+
+namespace glsl {
+
+	// Everything needed to issue one draw call. indexType GL_NONE draws with
+	// glDrawArrays from first, anything else with glDrawElementsBaseVertex at
+	// byte offset first. A modelLocation of -1 skips the model matrix upload.
+	struct DrawPacket {
+		GLuint program = 0;
+		GLuint vao = 0;
+		std::array<GLuint, 2> textures{};
+		float depth = 0.0f;
+		bool translucent = false;
+
+		GLenum mode = GL_TRIANGLES;
+		GLint first = 0;
+		GLsizei count = 0;
+		GLenum indexType = GL_NONE;
+		GLint baseVertex = 0;
+
+		GLint modelLocation = -1;
+		glm::mat4 model{ 1.0f };
+	};
+
+	struct RenderQueueStats {
+		std::uint32_t draws = 0;
+		std::uint32_t programBinds = 0;
+		std::uint32_t programBindsSkipped = 0;
+		std::uint32_t vaoBinds = 0;
+		std::uint32_t vaoBindsSkipped = 0;
+		std::uint32_t textureBinds = 0;
+		std::uint32_t textureBindsSkipped = 0;
+	};
+
+	// Collects a frame's draws, orders them by a 64-bit key and submits them
+	// binding only what changed between consecutive draws.
+	//
+	// Key layout, most significant bit first:
+	//   opaque:      0 | program:10 | texture:10 | vao:10 | depth:24 | 9 unused
+	//   translucent: 1 | ~depth:24  | program:10 | texture:10 | vao:10 | 9 unused
+	// Opaque draws are grouped by state and go front to back within a group,
+	// translucent ones go back to front. GL names are folded to their low bits,
+	// which only costs ordering quality if two live names collide.
+	class RenderQueue {
+	public:
+		RenderQueue() = default;
+		explicit RenderQueue(common::JobSystem* jobs);
+
+		void clear() noexcept;
+		void push(const DrawPacket& packet);
+
+		std::size_t size() const noexcept
+		{
+			return mPackets.size();
+		}
+
+		static std::uint64_t makeKey(const DrawPacket& packet) noexcept;
+
+		// Orders the packets by key. Sorting is separate from submit() so it can
+		// run on another thread than the one that owns the GL context.
+		void sort();
+
+		// Issues the draws in the current order (push order if sort() was not
+		// called) and returns this submission's counters. Leaves the last
+		// program, VAO and textures bound.
+		RenderQueueStats submit() const;
+
+	private:
+		common::JobSystem* mJobs = nullptr;
+		std::vector<DrawPacket> mPackets;
+		std::vector<common::SortItem> mOrder;
+		std::vector<common::SortItem> mScratch;
+		bool mSorted = true;
+	};
+
+} // glsl
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <bounds.hpp>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace common {
+
+	class JobSystem;
+
+	// Loose uniform grid: every object lives in exactly one cell, chosen by the
+	// center of its bounds, and queries are widened by the largest half extent
+	// seen so far. Moving an object is a swap-remove from one bucket and a push
+	// into another, so there is no tree to rebuild when everything moves.
+	// Once the largest objects are gone or have shrunk, flushUpdates() narrows
+	// the widening back down.
+	class SpatialHash {
+	public:
+		using Handle = std::uint32_t;
+		using Pair = std::pair<Handle, Handle>;
+
+		static constexpr Handle invalid_handle = ~Handle{ 0 };
+
+		// bucketCount is rounded up to the next power of two. Without a
+		// JobSystem findPairs() runs on the calling thread.
+		explicit SpatialHash(float cellSize, std::size_t bucketCount = 4096, JobSystem* jobs = nullptr);
+
+		Handle insert(const Aabb& bounds, std::uint32_t userData = 0);
+
+		// Removing a handle that is already gone does nothing.
+		void remove(Handle handle);
+
+		// Moves the object right away, O(1). Throws std::invalid_argument for
+		// a removed handle, as does queueUpdate().
+		void update(Handle handle, const Aabb& bounds);
+
+		// Records a move to be applied by flushUpdates(). The pending moves are
+		// sorted by destination bucket so that a frame's worth of reinsertions
+		// walks the bucket array in order instead of jumping around.
+		void queueUpdate(Handle handle, const Aabb& bounds);
+		void flushUpdates();
+
+		const Aabb& bounds(Handle handle) const
+		{
+			return mObjects[handle].bounds;
+		}
+
+		std::uint32_t userData(Handle handle) const
+		{
+			return mObjects[handle].userData;
+		}
+
+		std::size_t size() const noexcept
+		{
+			return mObjects.size() - mFreeHandles.size();
+		}
+
+		// Replaces handles with every object whose bounds overlap the box, in no
+		// particular order. Passing the same vector every time keeps queries
+		// from allocating once it has grown.
+		void query(const Aabb& box, std::vector<Handle>& handles) const;
+
+		// Broad phase: replaces pairs with every overlapping pair (a < b),
+		// sorted. The objects are split into chunks run on the JobSystem, each
+		// worker with scratch space kept from call to call. Not to be called
+		// from two threads at once.
+		void findPairs(std::vector<Pair>& pairs) const;
+
+	private:
+		struct Object {
+			Aabb bounds;
+			std::uint32_t bucket;
+			std::uint32_t slot;
+			std::uint32_t userData;
+		};
+
+		struct PendingUpdate {
+			Handle handle;
+			std::uint32_t bucket;
+			Aabb bounds;
+		};
+
+		struct Scratch {
+			std::vector<Handle> handles;
+			std::vector<Pair> pairs;
+		};
+
+		std::uint32_t bucketOf(const glm::vec3& point) const noexcept;
+		void link(Handle handle, std::uint32_t bucket);
+		void unlink(Handle handle);
+		void move(Handle handle, std::uint32_t bucket, const Aabb& bounds);
+		void checkHandle(Handle handle) const;
+		// Notes that an object that set mMaxHalfExtent may have shrunk to after.
+		void shrink(const Aabb& before, const glm::vec3& after) noexcept;
+		void refit();
+		void findPairsRange(std::size_t first, std::size_t last, Scratch& scratch) const;
+
+	private:
+		JobSystem* mJobs;
+		float mInvCellSize;
+		std::uint32_t mBucketMask;
+		glm::vec3 mMaxHalfExtent;
+		bool mExtentStale = false;      // an object that set mMaxHalfExtent left or shrank
+		std::vector<std::vector<Handle>> mBuckets;
+		std::vector<Object> mObjects;
+		std::vector<Handle> mFreeHandles;
+		std::vector<PendingUpdate> mPending;
+
+		// one per worker, the last for the other threads under mScratchMutex
+		mutable std::vector<Scratch> mScratch;
+		mutable std::mutex mScratchMutex;
+	};
+
+} // common
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <gl_objects.hpp>
+#include <glsl.hpp>
+#include <glm/glm.hpp>
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace glsl {
+
+	struct Sprite {
+		glm::vec2 position;             // center
+		glm::vec2 size;
+		float rotation = 0.0f;          // radians, around the center
+		glm::vec4 uvRect{ 0.0f, 0.0f, 1.0f, 1.0f };
+		glm::vec4 color{ 1.0f };
+		std::uint32_t layer = 0;
+		GLuint texture = 0;             // a GL_TEXTURE_2D_ARRAY atlas
+	};
+
+	struct SpriteBatchStats {
+		std::uint64_t sprites = 0;
+		std::uint64_t draws = 0;
+		std::uint64_t flushes = 0;
+		std::uint64_t fenceWaits = 0;
+	};
+
+	// Collects sprites as 48-byte instances and draws them as instanced
+	// four-vertex strips whose corners the vertex shader derives from
+	// gl_VertexID, so there is no index buffer and no per-vertex data.
+	//
+	// Instances are streamed through one persistently mapped, coherent buffer
+	// split into region_count regions; each flush fills the next region after
+	// waiting on the fence of its previous use. flush() groups the sprites by
+	// atlas with a counting sort that scatters straight into the mapped region,
+	// then issues one glDrawArraysInstancedBaseInstance per atlas. Sprites of
+	// one atlas keep their draw() order. draw() flushes on its own when the
+	// region is full. GlCapture cannot see the writes into the coherent
+	// mapping, so the constructor throws while capturing.
+	class SpriteBatch {
+	public:
+		static constexpr std::uint32_t region_count = 3;
+
+		explicit SpriteBatch(std::uint32_t capacity = 1 << 20,
+			const std::string& vertexShader = "resources/shaders/sprite.vs",
+			const std::string& fragmentShader = "resources/shaders/sprite.fs");
+
+		SpriteBatch(const SpriteBatch&) = delete;
+		SpriteBatch& operator = (const SpriteBatch&) = delete;
+
+		~SpriteBatch();
+
+		void setProjection(const glm::mat4& projection);
+
+		void draw(const Sprite& sprite);
+		void flush();
+
+		std::size_t pending() const noexcept
+		{
+			return mInstances.size();
+		}
+
+		const SpriteBatchStats& stats() const noexcept
+		{
+			return mStats;
+		}
+
+		void resetStats() noexcept
+		{
+			mStats = {};
+		}
+
+	private:
+		struct Instance {
+			glm::vec4 rect;
+			glm::vec4 uvRect;
+			std::uint32_t color;
+			float rotation;
+			float layer;
+			float padding;
+		};
+
+		static_assert(sizeof(Instance) == 48, "sprite instances are laid out for the shader");
+
+		std::uint16_t bucketOf(GLuint texture);
+
+	private:
+		std::uint32_t mCapacity;
+		Program mProgram;
+		GLint mProjectionLocation;
+		Buffer mStream;
+		VertexArray mVao;
+		Instance* mMapped;
+		std::uint32_t mRegion = 0;
+		std::array<GLsync, region_count> mFences{};
+
+		std::vector<Instance> mInstances;
+		std::vector<std::uint16_t> mBuckets;
+		std::vector<GLuint> mTextures;
+		std::vector<std::uint32_t> mOffsets;
+		std::size_t mLastBucket = 0;
+
+		SpriteBatchStats mStats;
+	};
+
+} // glsl
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <bounds.hpp>
+#include <geometry_arena.hpp>
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace glsl {
+
+	// A run of merged static geometry of one material, in world space.
+	struct StaticChunk {
+		std::uint32_t material;
+		MeshRange mesh;
+		common::Aabb bounds;
+	};
+
+	// Bakes objects that never move into a few large world-space meshes. add()
+	// copies an object's vertices with its model matrix applied; build() groups
+	// the objects by material, orders each group along a Morton curve of the
+	// object centers so chunks stay spatially compact, and cuts the groups into
+	// chunks of at most maxChunkVertices vertices, each one arena mesh with
+	// its own bounds. Drawing a whole static scene is then one draw per visible
+	// chunk with an identity model matrix.
+	//
+	// Positions are the float attribute at location 0 (3 or 4 components). If
+	// normalLocation is a float attribute of the layout it is transformed by
+	// the inverse transpose and renormalized; other attributes are copied.
+	// Indices are triangle lists; a mirroring model matrix has each
+	// triangle's winding reversed so culling still sees the front faces.
+	class StaticBatch {
+	public:
+		StaticBatch(GeometryArena& arena, std::uint32_t maxChunkVertices = 1 << 16, GLint normalLocation = -1);
+
+		StaticBatch(const StaticBatch&) = delete;
+		StaticBatch& operator = (const StaticBatch&) = delete;
+
+		~StaticBatch();
+
+		// material is the caller's key for program and textures.
+		void add(std::uint32_t material, const void* vertices, GLsizei vertexCount,
+			const GLuint* indices, GLsizei indexCount, const glm::mat4& model);
+
+		template <typename Vertices, typename Indices>
+		void add(std::uint32_t material, const Vertices& vertices, const Indices& indices, const glm::mat4& model)
+		{
+			add(material, std::data(vertices), static_cast<GLsizei>(std::size(vertices)),
+				std::data(indices), static_cast<GLsizei>(std::size(indices)), model);
+		}
+
+		// Merges everything added since the last build() into new chunks.
+		void build();
+
+		const std::vector<StaticChunk>& chunks() const noexcept
+		{
+			return mChunks;
+		}
+
+		std::size_t objectCount() const noexcept
+		{
+			return mObjectCount;
+		}
+
+	private:
+		struct Pending {
+			std::uint32_t material;
+			std::uint64_t morton;
+			std::vector<unsigned char> vertices;
+			std::vector<GLuint> indices;
+			common::Aabb bounds;
+		};
+
+	private:
+		GeometryArena& mArena;
+		std::uint32_t mMaxChunkVertices;
+		GLuint mPositionOffset;
+		GLint mPositionComponents;
+		GLint mNormalOffset = -1;
+		std::vector<Pending> mPending;
+		std::vector<StaticChunk> mChunks;
+		std::size_t mObjectCount = 0;
+	};
+
+} // glsl
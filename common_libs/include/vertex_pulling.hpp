@@ -0,0 +1,93 @@
+#pragma once
+
+#include <gl_objects.hpp>
+#include <indirect_draw.hpp>
+#include <offset_allocator.hpp>
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace glsl {
+
+	// Where a mesh landed inside a PulledGeometry.
+	struct PulledMesh {
+		std::uint32_t format = 0;
+		std::uint32_t firstWord = 0;
+		GLuint firstIndex = 0;
+		GLsizei indexCount = 0;
+		GLsizei vertexCount = 0;
+		common::OffsetAllocator::Allocation words;
+		common::OffsetAllocator::Allocation indices;
+	};
+
+	// GLSL declarations that let a vertex shader fetch its own vertices:
+	//
+	//   struct PulledVertex { vec4 location0; ... };  // one per layout location
+	//   PulledVertex pullVertex();
+	//   mat4 pulledModel();
+	//
+	// pullVertex() looks up the draw's DrawData through the draw index
+	// attribute of IndirectDrawBatch, takes the format index from params.x
+	// and the first 32-bit word of the mesh from params.y, and decodes vertex
+	// gl_VertexID of that format from the word SSBO at vertexBinding.
+	// Attributes a format lacks read as (0, 0, 0, 1). Needs #version 430.
+	//
+	// Supported attribute types are float, half float and 8/16-bit integers,
+	// normalized or not; floats must be 4-byte aligned and strides a multiple
+	// of 4. Throws std::invalid_argument for anything else.
+	std::string vertexPullingSource(const std::vector<VertexLayout>& formats, GLuint vertexBinding = 1, GLuint drawBinding = 0);
+
+	// Vertices of any of several layouts packed into one SSBO, with one shared
+	// index buffer and a VAO that has no attributes at all. Meshes of different
+	// formats go into the same IndirectDrawBatch and draw in one multi-draw:
+	// the shader decodes each draw's vertices by itself, so there are no VAO or
+	// format switches. Indices stay relative to their own mesh.
+	class PulledGeometry {
+	public:
+		PulledGeometry(std::vector<VertexLayout> formats, std::uint32_t words = 1 << 22, std::uint32_t indices = 1 << 22);
+
+		// Throws std::length_error when the buffers are full.
+		PulledMesh add(std::uint32_t format, const void* vertices, GLsizei vertexCount, const GLuint* indices, GLsizei indexCount);
+
+		template <typename Vertices, typename Indices>
+		PulledMesh add(std::uint32_t format, const Vertices& vertices, const Indices& indices)
+		{
+			return add(format, std::data(vertices), static_cast<GLsizei>(std::size(vertices)),
+				std::data(indices), static_cast<GLsizei>(std::size(indices)));
+		}
+
+		void remove(const PulledMesh& mesh);
+
+		// Adds one draw of mesh with params set up for pullVertex().
+		std::uint32_t addDraw(IndirectDrawBatch& batch, const PulledMesh& mesh, const glm::mat4& model) const;
+
+		// Binds the vertex words for the shaders built from shaderSource().
+		void bind(GLuint vertexBinding = 1) const;
+
+		std::string shaderSource(GLuint vertexBinding = 1, GLuint drawBinding = 0) const
+		{
+			return vertexPullingSource(mFormats, vertexBinding, drawBinding);
+		}
+
+		const VertexArray& vertexArray() const noexcept
+		{
+			return mVao;
+		}
+
+		const std::vector<VertexLayout>& formats() const noexcept
+		{
+			return mFormats;
+		}
+
+	private:
+		std::vector<VertexLayout> mFormats;
+		Buffer mWords;
+		Buffer mIndices;
+		VertexArray mVao;
+		common::OffsetAllocator mWordSpace;
+		common::OffsetAllocator mIndexSpace;
+	};
+
+} // glsl
@@ -0,0 +1,807 @@
+#include <allocation_tracker.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <new>
+#include <ostream>
+
+#if defined(_WIN32)
+#	define WIN32_LEAN_AND_MEAN
+#	define NOMINMAX
+#	include <windows.h>
+#	include <intrin.h>
+#elif defined(__GLIBC__)
+#	include <cxxabi.h>
+#	include <execinfo.h>
+#	include <link.h>
+#	define ALLOCATION_TRACKER_BACKTRACE
+#endif
+
+// glibc lets a program define the malloc family itself, the sanitizers
+// bring their own
+#if defined(COMMON_LIBS_ALLOCATION_TRACKER) && defined(__GLIBC__) && !defined(__SANITIZE_ADDRESS__) && !defined(__SANITIZE_THREAD__)
+#	define ALLOCATION_TRACKER_HOOK_MALLOC
+#endif
+
+#if defined(_MSC_VER)
+#	define ALLOCATION_TRACKER_NOINLINE __declspec(noinline)
+#	define ALLOCATION_TRACKER_CALLER _ReturnAddress()
+#else
+#	define ALLOCATION_TRACKER_NOINLINE __attribute__((noinline))
+#	define ALLOCATION_TRACKER_CALLER __builtin_return_address(0)
+#endif
+
+namespace common {
+
+using namespace std;
+
+namespace {
+
+	constexpr size_t site_slots = 4096;
+	// recordSite, record and the operator new or malloc that called it
+	constexpr size_t hook_frames = 3;
+	// site keys are odd, a slot being filled in holds this one
+	constexpr uint64_t busy_key = 2;
+
+	struct SiteSlot {
+		atomic<uint64_t> key{ 0 };
+		void* callers[AllocationSite::depth]{};
+		atomic<uint64_t> count{ 0 };
+		atomic<uint64_t> bytes{ 0 };
+	};
+
+	atomic<bool> g_enabled{ false };
+	atomic<bool> g_sites{ false };
+	atomic<uint64_t> g_count{ 0 };
+	atomic<uint64_t> g_bytes{ 0 };
+	atomic<uint64_t> g_unsited{ 0 };
+	atomic<uint64_t> g_libraryCount{ 0 };
+	atomic<uint64_t> g_libraryBytes{ 0 };
+	SiteSlot g_siteTable[site_slots];
+
+	// the program's mapped segments, empty where callers are not told apart
+	atomic<uintptr_t> g_programBegin{ 0 };
+	atomic<uintptr_t> g_programEnd{ 0 };
+
+	// libc, libstdc++ and the like: they allocate on behalf of whoever called
+	// them, so they are looked through when finding who asked
+	constexpr size_t runtime_slots = 8;
+	atomic<uintptr_t> g_runtimeBegin[runtime_slots];
+	atomic<uintptr_t> g_runtimeEnd[runtime_slots];
+	atomic<size_t> g_runtimeCount{ 0 };
+
+	// set while the tracker allocates for itself
+	thread_local bool tlsInside = false;
+
+	class Untracked {
+	public:
+		Untracked() noexcept
+			: mOuter{ tlsInside }
+		{
+			tlsInside = true;
+		}
+
+		~Untracked()
+		{
+			tlsInside = mOuter;
+		}
+
+	private:
+		bool mOuter;
+	};
+
+	bool inRuntime(uintptr_t address) noexcept
+	{
+		const auto count = g_runtimeCount.load(memory_order_relaxed);
+		for (size_t i = 0; i < count; ++i)
+		{
+			if (address >= g_runtimeBegin[i].load(memory_order_relaxed) && address < g_runtimeEnd[i].load(memory_order_relaxed))
+				return true;
+		}
+		return false;
+	}
+
+	// Callers innermost first. The first one outside the runtime libraries
+	// decides: the program, or a library such as the GL driver. A string the
+	// program builds is allocated by libstdc++ but still the program's.
+	bool fromLibrary(void* const* callers, size_t count) noexcept
+	{
+		const auto begin = g_programBegin.load(memory_order_relaxed);
+		const auto end = g_programEnd.load(memory_order_relaxed);
+		if (!end)
+			return false;
+
+		for (size_t i = 0; i < count && callers[i]; ++i)
+		{
+			const auto address = reinterpret_cast<uintptr_t>(callers[i]);
+			if (address >= begin && address < end)
+				return false;
+
+			if (!inRuntime(address))
+				return true;
+		}
+
+		// nothing but the runtime, as far as the walk went
+		return true;
+	}
+
+	void findProgram() noexcept
+	{
+#if defined(ALLOCATION_TRACKER_HOOK_MALLOC)
+		g_runtimeCount.store(0, memory_order_relaxed);
+
+		// the program comes first
+		auto first = true;
+		dl_iterate_phdr([](dl_phdr_info* info, size_t, void* data)
+		{
+			auto& first = *static_cast<bool*>(data);
+
+			auto begin = UINTPTR_MAX;
+			uintptr_t end = 0;
+			for (ElfW(Half) i = 0; i < info->dlpi_phnum; ++i)
+			{
+				const auto& segment = info->dlpi_phdr[i];
+				if (segment.p_type != PT_LOAD)
+					continue;
+
+				begin = min<uintptr_t>(begin, info->dlpi_addr + segment.p_vaddr);
+				end = max<uintptr_t>(end, info->dlpi_addr + segment.p_vaddr + segment.p_memsz);
+			}
+
+			if (!end)
+				return 0;
+
+			if (first)
+			{
+				first = false;
+				g_programBegin.store(begin, memory_order_relaxed);
+				g_programEnd.store(end, memory_order_relaxed);
+				return 0;
+			}
+
+			const auto slash = info->dlpi_name ? strrchr(info->dlpi_name, '/') : nullptr;
+			const auto name = slash ? slash + 1 : info->dlpi_name;
+			if (!name)
+				return 0;
+
+			const auto runtime = !strncmp(name, "libc.", 5) || !strncmp(name, "libc-", 5)
+				|| !strncmp(name, "libm.", 5) || !strncmp(name, "libm-", 5)
+				|| !strncmp(name, "libstdc++", 9) || !strncmp(name, "libgcc_s", 8);
+
+			const auto slot = g_runtimeCount.load(memory_order_relaxed);
+			if (runtime && slot < runtime_slots)
+			{
+				g_runtimeBegin[slot].store(begin, memory_order_relaxed);
+				g_runtimeEnd[slot].store(end, memory_order_relaxed);
+				g_runtimeCount.store(slot + 1, memory_order_relaxed);
+			}
+			return 0;
+		}, &first);
+#endif
+	}
+
+	// Returns whether a library made the allocation.
+	ALLOCATION_TRACKER_NOINLINE bool recordSite(size_t bytes) noexcept
+	{
+		void* frames[hook_frames + AllocationSite::depth];
+		size_t frameCount = 0;
+#if defined(_WIN32)
+		frameCount = CaptureStackBackTrace(0, static_cast<DWORD>(size(frames)), frames, nullptr);
+#elif defined(ALLOCATION_TRACKER_BACKTRACE)
+		frameCount = static_cast<size_t>(max(0, backtrace(frames, static_cast<int>(size(frames)))));
+#endif
+
+		void* callers[AllocationSite::depth] = {};
+		for (auto i = hook_frames; i < frameCount; ++i)
+			callers[i - hook_frames] = frames[i];
+
+		uint64_t key = 14695981039346656037ull;
+		for (const auto caller : callers)
+			key = (key ^ reinterpret_cast<uintptr_t>(caller)) * 1099511628211ull;
+		key |= 1;
+
+		const auto library = fromLibrary(callers, AllocationSite::depth);
+
+		for (size_t probe = 0; probe < site_slots; ++probe)
+		{
+			auto& slot = g_siteTable[(key + probe) % site_slots];
+
+			auto current = slot.key.load(memory_order_acquire);
+			if (current == 0 && slot.key.compare_exchange_strong(current, busy_key, memory_order_acquire))
+			{
+				copy(begin(callers), end(callers), slot.callers);
+				slot.key.store(key, memory_order_release);
+				current = key;
+			}
+
+			while (current == busy_key)
+				current = slot.key.load(memory_order_acquire);
+
+			if (current == key)
+			{
+				slot.count.fetch_add(1, memory_order_relaxed);
+				slot.bytes.fetch_add(bytes, memory_order_relaxed);
+				return library;
+			}
+		}
+
+		g_unsited.fetch_add(1, memory_order_relaxed);
+		return library;
+	}
+
+#if defined(ALLOCATION_TRACKER_BACKTRACE)
+	// "module(mangled+0x1a) [0x..]" to "demangled+0x1a"; functions the
+	// executable does not export (no -rdynamic) keep the module and offset
+	string symbolName(const char* symbol)
+	{
+		const auto open = strchr(symbol, '(');
+		const auto plus = open ? strchr(open, '+') : nullptr;
+		const auto close = plus ? strchr(plus, ')') : nullptr;
+		if (!close || plus == open + 1)
+			return symbol;
+
+		const string mangled{ open + 1, plus };
+		int status = 0;
+		const auto demangled = abi::__cxa_demangle(mangled.c_str(), nullptr, nullptr, &status);
+		auto name = status == 0 && demangled ? string{ demangled } : mangled;
+		free(demangled);
+
+		return name.append(plus, close);
+	}
+#endif
+}
+
+AllocationTracker& AllocationTracker::instance()
+{
+	static AllocationTracker tracker;
+	return tracker;
+}
+
+bool AllocationTracker::available() noexcept
+{
+#if defined(COMMON_LIBS_ALLOCATION_TRACKER)
+	return true;
+#else
+	return false;
+#endif
+}
+
+void AllocationTracker::enable(bool sites)
+{
+#if defined(ALLOCATION_TRACKER_BACKTRACE)
+	// the first backtrace loads the unwinder
+	if (sites)
+	{
+		Untracked untracked;
+		void* frame;
+		backtrace(&frame, 1);
+	}
+#endif
+
+	findProgram();
+
+	{
+		Untracked untracked;
+		mPerFrameCount.reserve(history_frames);
+		mPerFrameBytes.reserve(history_frames);
+		mPerFrameLibrary.reserve(history_frames);
+	}
+
+	g_sites.store(sites, memory_order_relaxed);
+	g_enabled.store(true, memory_order_release);
+}
+
+void AllocationTracker::disable()
+{
+	g_enabled.store(false, memory_order_release);
+	g_sites.store(false, memory_order_relaxed);
+}
+
+bool AllocationTracker::enabled() const noexcept
+{
+	return g_enabled.load(memory_order_relaxed);
+}
+
+ALLOCATION_TRACKER_NOINLINE void AllocationTracker::record(size_t bytes, const void* caller) noexcept
+{
+	if (!g_enabled.load(memory_order_relaxed) || tlsInside)
+		return;
+
+	g_count.fetch_add(1, memory_order_relaxed);
+	g_bytes.fetch_add(bytes, memory_order_relaxed);
+
+	bool library;
+	if (g_sites.load(memory_order_relaxed))
+	{
+		// the unwinder may allocate
+		Untracked untracked;
+		library = recordSite(bytes);
+	}
+	else
+	{
+		void* const callers[] = { const_cast<void*>(caller) };
+		library = fromLibrary(callers, 1);
+	}
+
+	if (library)
+	{
+		g_libraryCount.fetch_add(1, memory_order_relaxed);
+		g_libraryBytes.fetch_add(bytes, memory_order_relaxed);
+	}
+}
+
+void AllocationTracker::frameEnd()
+{
+	if (!enabled())
+		return;
+
+	Untracked untracked;
+
+	const auto now = total();
+	mLastFrame = { now.count - mClosed.count, now.bytes - mClosed.bytes,
+		now.libraryCount - mClosed.libraryCount, now.libraryBytes - mClosed.libraryBytes };
+	mClosed = now;
+
+	const double row[] = { static_cast<double>(mLastFrame.count), static_cast<double>(mLastFrame.bytes),
+		static_cast<double>(mLastFrame.libraryCount) };
+	vector<double>* columns[] = { &mPerFrameCount, &mPerFrameBytes, &mPerFrameLibrary };
+
+	// past the window the oldest frame makes way
+	for (size_t i = 0; i < size(columns); ++i)
+	{
+		if (columns[i]->size() < history_frames)
+			columns[i]->push_back(row[i]);
+		else
+			(*columns[i])[mFrames % history_frames] = row[i];
+	}
+	++mFrames;
+}
+
+AllocationCount AllocationTracker::total() const noexcept
+{
+	return { g_count.load(memory_order_relaxed), g_bytes.load(memory_order_relaxed),
+		g_libraryCount.load(memory_order_relaxed), g_libraryBytes.load(memory_order_relaxed) };
+}
+
+TimingSummary AllocationTracker::countHistogram() const
+{
+	Untracked untracked;
+	return summarize(mPerFrameCount);
+}
+
+TimingSummary AllocationTracker::byteHistogram() const
+{
+	Untracked untracked;
+	return summarize(mPerFrameBytes);
+}
+
+TimingSummary AllocationTracker::libraryHistogram() const
+{
+	Untracked untracked;
+	return summarize(mPerFrameLibrary);
+}
+
+vector<AllocationSite> AllocationTracker::busiest(size_t count) const
+{
+	Untracked untracked;
+
+	vector<AllocationSite> sites;
+	for (const auto& slot : g_siteTable)
+	{
+		const auto key = slot.key.load(memory_order_acquire);
+		const auto calls = slot.count.load(memory_order_relaxed);
+		if (!(key & 1) || !calls)
+			continue;
+
+		AllocationSite site;
+		copy(begin(slot.callers), end(slot.callers), site.callers);
+		site.count = calls;
+		site.bytes = slot.bytes.load(memory_order_relaxed);
+		site.library = fromLibrary(site.callers, AllocationSite::depth);
+		sites.push_back(site);
+	}
+
+	sort(sites.begin(), sites.end(), [](const AllocationSite& a, const AllocationSite& b)
+	{
+		return a.count > b.count;
+	});
+
+	if (sites.size() > count)
+		sites.resize(count);
+
+	return sites;
+}
+
+void AllocationTracker::reset()
+{
+	Untracked untracked;
+
+	g_count.store(0, memory_order_relaxed);
+	g_bytes.store(0, memory_order_relaxed);
+	g_unsited.store(0, memory_order_relaxed);
+	g_libraryCount.store(0, memory_order_relaxed);
+	g_libraryBytes.store(0, memory_order_relaxed);
+
+	for (auto& slot : g_siteTable)
+	{
+		slot.count.store(0, memory_order_relaxed);
+		slot.bytes.store(0, memory_order_relaxed);
+		slot.key.store(0, memory_order_release);
+	}
+
+	mFrames = 0;
+	mLastFrame = {};
+	mClosed = {};
+	mPerFrameCount.clear();
+	mPerFrameBytes.clear();
+	mPerFrameLibrary.clear();
+}
+
+string AllocationTracker::describe(const AllocationSite& site)
+{
+	Untracked untracked;
+
+	const auto depth = static_cast<size_t>(find(begin(site.callers), end(site.callers), nullptr) - begin(site.callers));
+	if (!depth)
+		return "unknown";
+
+	string text;
+#if defined(ALLOCATION_TRACKER_BACKTRACE)
+	const auto symbols = backtrace_symbols(site.callers, static_cast<int>(depth));
+#endif
+
+	for (size_t i = 0; i < depth; ++i)
+	{
+		if (i)
+			text += " <- ";
+
+#if defined(ALLOCATION_TRACKER_BACKTRACE)
+		if (symbols)
+		{
+			text += symbolName(symbols[i]);
+			continue;
+		}
+#endif
+
+		char address[32];
+		snprintf(address, sizeof(address), "%p", site.callers[i]);
+		text += address;
+	}
+
+#if defined(ALLOCATION_TRACKER_BACKTRACE)
+	free(symbols);
+#endif
+
+	return text;
+}
+
+void AllocationTracker::writeReport(ostream& out, size_t siteCount) const
+{
+	Untracked untracked;
+	char text[160];
+
+	snprintf(text, sizeof(text), "heap allocations per frame over %llu frames:\n", static_cast<unsigned long long>(mFrames));
+	out << text;
+
+	const pair<const char*, TimingSummary> rows[] = {
+		{ "count", countHistogram() }, { "bytes", byteHistogram() }, { "library", libraryHistogram() } };
+	for (const auto& row : rows)
+	{
+		snprintf(text, sizeof(text), "  %-8s min %8.0f  mean %10.1f  p50 %8.0f  p95 %8.0f  max %8.0f\n",
+			row.first, row.second.min, row.second.mean, row.second.p50, row.second.p95, row.second.max);
+		out << text;
+	}
+
+	const auto all = total();
+	snprintf(text, sizeof(text), "  %llu allocations, %llu bytes in total, %llu allocations by libraries\n",
+		static_cast<unsigned long long>(all.count), static_cast<unsigned long long>(all.bytes),
+		static_cast<unsigned long long>(all.libraryCount));
+	out << text;
+
+	for (const auto& site : busiest(siteCount))
+	{
+		snprintf(text, sizeof(text), "  %10llu allocations %12llu bytes  ",
+			static_cast<unsigned long long>(site.count), static_cast<unsigned long long>(site.bytes));
+		out << text << describe(site) << '\n';
+	}
+
+	if (const auto unsited = g_unsited.load(memory_order_relaxed))
+	{
+		snprintf(text, sizeof(text), "  %llu allocations from sites past the table's size\n", static_cast<unsigned long long>(unsited));
+		out << text;
+	}
+}
+
+} // common
+
+#if defined(COMMON_LIBS_ALLOCATION_TRACKER)
+
+#if defined(ALLOCATION_TRACKER_HOOK_MALLOC)
+
+extern "C" {
+	void* __libc_malloc(std::size_t size);
+	void* __libc_calloc(std::size_t count, std::size_t size);
+	void* __libc_realloc(void* p, std::size_t size);
+	void* __libc_memalign(std::size_t alignment, std::size_t size);
+	void* __libc_valloc(std::size_t size);
+	void* __libc_pvalloc(std::size_t size);
+	void __libc_free(void* p);
+}
+
+#endif
+
+// The replacements count, then allocate the way the standard ones do.
+
+namespace {
+
+	// malloc without counting a second time
+	void* untrackedMalloc(std::size_t size) noexcept
+	{
+#if defined(ALLOCATION_TRACKER_HOOK_MALLOC)
+		return __libc_malloc(size);
+#else
+		return std::malloc(size);
+#endif
+	}
+
+	void* allocate(std::size_t size)
+	{
+		for (;;)
+		{
+			if (auto p = untrackedMalloc(size ? size : 1))
+				return p;
+
+			auto handler = std::get_new_handler();
+			if (!handler)
+				throw std::bad_alloc{};
+
+			handler();
+		}
+	}
+
+	void* allocate(std::size_t size, std::align_val_t alignment)
+	{
+		const auto align = static_cast<std::size_t>(alignment);
+		for (;;)
+		{
+#if defined(_MSC_VER)
+			auto p = _aligned_malloc(size ? size : 1, align);
+#else
+#	if defined(ALLOCATION_TRACKER_HOOK_MALLOC)
+			auto p = __libc_memalign(align, size ? size : 1);
+#	else
+			// aligned_alloc wants a multiple of the alignment
+			auto p = std::aligned_alloc(align, (std::max<std::size_t>(size, 1) + align - 1) / align * align);
+#	endif
+#endif
+			if (p)
+				return p;
+
+			auto handler = std::get_new_handler();
+			if (!handler)
+				throw std::bad_alloc{};
+
+			handler();
+		}
+	}
+
+	void release(void* p, std::align_val_t) noexcept
+	{
+#if defined(_MSC_VER)
+		_aligned_free(p);
+#else
+		std::free(p);
+#endif
+	}
+}
+
+void* operator new(std::size_t size)
+{
+	common::AllocationTracker::record(size, ALLOCATION_TRACKER_CALLER);
+	return allocate(size);
+}
+
+void* operator new[](std::size_t size)
+{
+	common::AllocationTracker::record(size, ALLOCATION_TRACKER_CALLER);
+	return allocate(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+	common::AllocationTracker::record(size, ALLOCATION_TRACKER_CALLER);
+	try
+	{
+		return allocate(size);
+	}
+	catch (...)
+	{
+		return nullptr;
+	}
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+	common::AllocationTracker::record(size, ALLOCATION_TRACKER_CALLER);
+	try
+	{
+		return allocate(size);
+	}
+	catch (...)
+	{
+		return nullptr;
+	}
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+	common::AllocationTracker::record(size, ALLOCATION_TRACKER_CALLER);
+	return allocate(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+	common::AllocationTracker::record(size, ALLOCATION_TRACKER_CALLER);
+	return allocate(size, alignment);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	common::AllocationTracker::record(size, ALLOCATION_TRACKER_CALLER);
+	try
+	{
+		return allocate(size, alignment);
+	}
+	catch (...)
+	{
+		return nullptr;
+	}
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	common::AllocationTracker::record(size, ALLOCATION_TRACKER_CALLER);
+	try
+	{
+		return allocate(size, alignment);
+	}
+	catch (...)
+	{
+		return nullptr;
+	}
+}
+
+void operator delete(void* p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+	std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept
+{
+	std::free(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void* p, std::align_val_t alignment) noexcept
+{
+	release(p, alignment);
+}
+
+void operator delete[](void* p, std::align_val_t alignment) noexcept
+{
+	release(p, alignment);
+}
+
+void operator delete(void* p, std::size_t, std::align_val_t alignment) noexcept
+{
+	release(p, alignment);
+}
+
+void operator delete[](void* p, std::size_t, std::align_val_t alignment) noexcept
+{
+	release(p, alignment);
+}
+
+void operator delete(void* p, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	release(p, alignment);
+}
+
+void operator delete[](void* p, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	release(p, alignment);
+}
+
+#endif
+
+#if defined(ALLOCATION_TRACKER_HOOK_MALLOC)
+
+// Every library of the process calls these instead of glibc's own: the GL
+// driver, stb_image, libstdc++. A realloc counts as an allocation.
+
+extern "C" void* malloc(std::size_t size) noexcept
+{
+	common::AllocationTracker::record(size, ALLOCATION_TRACKER_CALLER);
+	return __libc_malloc(size);
+}
+
+extern "C" void* calloc(std::size_t count, std::size_t size) noexcept
+{
+	common::AllocationTracker::record(count * size, ALLOCATION_TRACKER_CALLER);
+	return __libc_calloc(count, size);
+}
+
+extern "C" void* realloc(void* p, std::size_t size) noexcept
+{
+	common::AllocationTracker::record(size, ALLOCATION_TRACKER_CALLER);
+	return __libc_realloc(p, size);
+}
+
+extern "C" void* memalign(std::size_t alignment, std::size_t size) noexcept
+{
+	common::AllocationTracker::record(size, ALLOCATION_TRACKER_CALLER);
+	return __libc_memalign(alignment, size);
+}
+
+extern "C" void* aligned_alloc(std::size_t alignment, std::size_t size) noexcept
+{
+	common::AllocationTracker::record(size, ALLOCATION_TRACKER_CALLER);
+	return __libc_memalign(alignment, size);
+}
+
+extern "C" int posix_memalign(void** out, std::size_t alignment, std::size_t size) noexcept
+{
+	if (!alignment || (alignment & (alignment - 1)) || alignment % sizeof(void*))
+		return EINVAL;
+
+	common::AllocationTracker::record(size, ALLOCATION_TRACKER_CALLER);
+	const auto p = __libc_memalign(alignment, size);
+	if (!p)
+		return ENOMEM;
+
+	*out = p;
+	return 0;
+}
+
+extern "C" void* valloc(std::size_t size) noexcept
+{
+	common::AllocationTracker::record(size, ALLOCATION_TRACKER_CALLER);
+	return __libc_valloc(size);
+}
+
+extern "C" void* pvalloc(std::size_t size) noexcept
+{
+	common::AllocationTracker::record(size, ALLOCATION_TRACKER_CALLER);
+	return __libc_pvalloc(size);
+}
+
+extern "C" void free(void* p) noexcept
+{
+	__libc_free(p);
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,795 @@
+#include <app_context.hpp>
+#include <allocation_tracker.hpp>
+#include <cpu_profiler.hpp>
+#include <frame_benchmark.hpp>
+#include <gl_capture.hpp>
+#include <gl_trace.hpp>
+#include <gpu_profiler.hpp>
+#include <png_writer.hpp>
+#include <GLFW/glfw3.h>
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <cwchar>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+#if defined(_WIN32)
+#	define WIN32_LEAN_AND_MEAN
+#	define NOMINMAX
+#	include <windows.h>
+#	include <shellapi.h>
+#endif
+
+#if defined(COMMON_LIBS_HAS_EGL)
+#	define EGL_NO_X11
+#	define MESA_EGL_NO_X11_HEADERS
+#	include <EGL/egl.h>
+#	include <EGL/eglext.h>
+#endif
+
+#if defined(COMMON_LIBS_HAS_OSMESA)
+#	if !defined(GLAPIENTRY)
+#		define GLAPIENTRY APIENTRY
+#	endif
+#	include <GL/osmesa.h>
+#endif
+
+namespace glsl {
+
+using namespace std;
+
+namespace {
+
+	constexpr uint64_t default_headless_frames = 60;
+	constexpr uint64_t default_bench_frames = 300;
+	constexpr double headless_frame_time = 1.0 / 60.0;
+	constexpr uint64_t title_interval = 30;
+
+	ContextBackend parseBackend(const char* name)
+	{
+		if (!strcmp(name, "egl"))
+			return ContextBackend::egl;
+
+		if (!strcmp(name, "osmesa"))
+			return ContextBackend::osmesa;
+
+		throw invalid_argument{ string{ "unknown headless backend: " } + name };
+	}
+
+	// strtoull alone would take "-1", "10x" or "" without complaint
+	uint64_t parseCount(const char* option, const char* text)
+	{
+		char* end = nullptr;
+		errno = 0;
+		const auto count = isdigit(static_cast<unsigned char>(*text)) ? strtoull(text, &end, 10) : 0;
+
+		if (!end || *end || errno == ERANGE)
+			throw invalid_argument{ string{ option } + " needs a whole number, not \"" + text + "\"" };
+
+		return count;
+	}
+
+	const char* backendName(ContextBackend backend) noexcept
+	{
+		switch (backend)
+		{
+		case ContextBackend::egl:
+			return "egl";
+
+		case ContextBackend::osmesa:
+			return "osmesa";
+
+		default:
+			return "window";
+		}
+	}
+
+	string glString(GLenum name)
+	{
+		const auto text = reinterpret_cast<const char*>(glGetString(name));
+		return text ? text : "";
+	}
+
+#if defined(COMMON_LIBS_HAS_EGL)
+	bool hasExtension(const char* extensions, const char* name)
+	{
+		const auto length = strlen(name);
+		for (auto p = extensions; p && (p = strstr(p, name)); p += length)
+		{
+			if ((p == extensions || p[-1] == ' ') && (p[length] == ' ' || p[length] == '\0'))
+				return true;
+		}
+		return false;
+	}
+
+	void* eglLoader(const char* name)
+	{
+		return reinterpret_cast<void*>(eglGetProcAddress(name));
+	}
+#endif
+
+#if defined(COMMON_LIBS_HAS_OSMESA)
+	void* osMesaLoader(const char* name)
+	{
+		return reinterpret_cast<void*>(OSMesaGetProcAddress(name));
+	}
+#endif
+}
+
+ContextOptions ContextOptions::fromCommandLine(int argc, char** argv, ContextOptions defaults)
+{
+	auto options = move(defaults);
+
+	for (int i = 1; argv && i < argc; ++i)
+	{
+		const auto arg = argv[i];
+		auto value = [&]
+		{
+			if (i + 1 >= argc)
+				throw invalid_argument{ string{ arg } + " needs a value" };
+
+			return argv[++i];
+		};
+
+		if (!strcmp(arg, "--headless"))
+			options.backend = ContextBackend::egl;
+		else if (!strncmp(arg, "--headless=", 11))
+			options.backend = parseBackend(arg + 11);
+		else if (!strcmp(arg, "--frames"))
+			options.frames = parseCount(arg, value());
+		else if (!strcmp(arg, "--bench"))
+			options.bench = true;
+		else if (!strcmp(arg, "--warmup"))
+			options.warmup = parseCount(arg, value());
+		else if (!strcmp(arg, "--bench-out"))
+			options.benchOutput = value();
+		else if (!strcmp(arg, "--no-vsync"))
+			options.vsync = false;
+		else if (!strcmp(arg, "--gpu-title"))
+			options.gpuTitle = true;
+		else if (!strcmp(arg, "--trace"))
+			options.traceOutput = value();
+		else if (!strcmp(arg, "--gl-trace"))
+			options.glTrace = true;
+		else if (!strcmp(arg, "--gl-trace=timing"))
+			options.glTrace = options.glTraceTiming = true;
+		else if (!strcmp(arg, "--capture"))
+			options.captureOutput = value();
+		else if (!strcmp(arg, "--screenshot"))
+			options.screenshotOutput = value();
+		else if (!strcmp(arg, "--alloc-trace"))
+			options.allocTrace = true;
+		else if (!strcmp(arg, "--alloc-trace=sites"))
+			options.allocTrace = options.allocSites = true;
+		else if (!strcmp(arg, "--alloc-check"))
+			options.allocCheck = true;
+		else if (!strncmp(arg, "--", 2))
+			throw invalid_argument{ string{ "unknown option " } + arg };
+	}
+
+	if (options.frames == 0)
+	{
+		if (options.bench)
+			options.frames = default_bench_frames;
+		else if (options.backend != ContextBackend::window)
+			options.frames = default_headless_frames;
+	}
+
+	return options;
+}
+
+#if defined(_WIN32)
+CommandLine::CommandLine()
+{
+	int argc = 0;
+	const auto argv = CommandLineToArgvW(GetCommandLineW(), &argc);
+	if (!argv)
+		throw runtime_error{ "cannot read the command line" };
+
+	for (int i = 0; i < argc; ++i)
+	{
+		const auto length = static_cast<int>(wcslen(argv[i]));
+		const auto size = length ? WideCharToMultiByte(CP_UTF8, 0, argv[i], length, nullptr, 0, nullptr, nullptr) : 0;
+
+		string arg(static_cast<size_t>(size), '\0');
+		if (size > 0)
+			WideCharToMultiByte(CP_UTF8, 0, argv[i], length, arg.data(), size, nullptr, nullptr);
+
+		mArgs.push_back(move(arg));
+	}
+
+	LocalFree(argv);
+
+	for (auto& arg : mArgs)
+		mPointers.push_back(arg.data());
+	mPointers.push_back(nullptr);
+}
+#endif
+
+AppContext::AppContext(const ContextOptions& options)
+	: mOptions{ options }
+{
+	if (options.width <= 0 || options.height <= 0)
+		throw invalid_argument{ "AppContext needs a positive size" };
+
+	if (options.bench && !options.captureOutput.empty())
+		throw invalid_argument{ "AppContext cannot capture a benchmark run" };
+
+	if (!options.screenshotOutput.empty() && !options.frames)
+		throw invalid_argument{ "AppContext needs a frame count for a screenshot" };
+
+	if (options.allocCheck && (options.bench || options.gpuTitle || options.glTrace
+		|| !options.traceOutput.empty() || !options.captureOutput.empty()))
+		throw invalid_argument{ "AppContext cannot check the allocations of a recording run" };
+
+	if ((options.allocTrace || options.allocCheck) && !common::AllocationTracker::available())
+		throw invalid_argument{ "common_libs was built without USE_ALLOCATION_TRACKER" };
+
+	if (!options.traceOutput.empty())
+	{
+		auto& profiler = common::CpuProfiler::instance();
+		profiler.setThreadName("main");
+		profiler.enable(true);
+	}
+
+	COMMON_PROFILE_SCOPE("AppContext::create");
+
+	try
+	{
+		switch (options.backend)
+		{
+		case ContextBackend::window:
+			createWindow();
+			break;
+
+		case ContextBackend::egl:
+			createEgl();
+			break;
+
+		case ContextBackend::osmesa:
+			createOsMesa();
+			break;
+		}
+
+		if (headless())
+			createFramebuffer();
+
+		// after the FBO, which a replay makes for itself
+		if (!options.captureOutput.empty())
+			GlCapture::instance().start(options.captureOutput, options.width, options.height);
+
+		mGpuProfiler = make_unique<GpuProfiler>();
+
+		if (options.bench)
+		{
+			mBenchmark = make_unique<FrameBenchmark>(options.warmup, options.frames);
+			mGpuProfiler->setHistoryStart(mBenchmark->warmup(), options.frames);
+		}
+		else
+		{
+			// the history is for the benchmark report, and grows every frame
+			mGpuProfiler->setHistoryStart(numeric_limits<uint64_t>::max());
+		}
+
+		if (options.glTrace)
+			GlCallTrace::instance().enable(options.glTraceTiming);
+
+		if (options.allocTrace || options.allocCheck)
+			common::AllocationTracker::instance().enable(options.allocSites || options.allocCheck);
+
+		mFrameStart = common::CpuProfiler::now();
+	}
+	catch (...)
+	{
+		finishCapture();
+		release();
+		throw;
+	}
+}
+
+AppContext::~AppContext()
+{
+	finishAllocationTrace();
+	finishBenchmark();
+	finishTrace();
+	finishGlTrace();
+	finishCapture();
+	mGpuProfiler.reset();
+	release();
+}
+
+void AppContext::finishAllocationTrace() noexcept
+{
+	auto& allocations = common::AllocationTracker::instance();
+	if (!allocations.enabled())
+		return;
+
+	try
+	{
+		if (mOptions.allocTrace)
+			allocations.writeReport(cout);
+
+		if (mOptions.allocCheck)
+		{
+			cout << "allocation check: " << allocations.frames() << " frames without heap allocations, "
+				<< allocations.total().libraryCount << " made by libraries" << endl;
+		}
+	}
+	catch (const exception& e)
+	{
+		cerr << "allocation report failed: " << e.what() << endl;
+	}
+
+	allocations.disable();
+}
+
+void AppContext::checkAllocations()
+{
+	auto& allocations = common::AllocationTracker::instance();
+	if (!allocations.enabled())
+		return;
+
+	allocations.frameEnd();
+	if (!mOptions.allocCheck)
+		return;
+
+	// frame 0 holds the sample's setup
+	const auto warmup = max<uint64_t>(mOptions.warmup, 1);
+	if (mFrame + 1 == warmup)
+	{
+		// so the sites are those of the checked frames
+		allocations.reset();
+		return;
+	}
+
+	// what the GL driver and libc allocate for themselves is theirs
+	const auto frame = allocations.lastFrame();
+	if (mFrame < warmup || !frame.programCount())
+		return;
+
+	allocations.disable();
+
+	ostringstream message;
+	message << "frame " << mFrame << " made " << frame.programCount() << " heap allocations ("
+		<< frame.bytes - frame.libraryBytes << " bytes)";
+
+	size_t shown = 0;
+	for (const auto& site : allocations.busiest(64))
+	{
+		if (site.library)
+			continue;
+
+		message << "\n  " << site.count << "x " << common::AllocationTracker::describe(site);
+		if (++shown == 5)
+			break;
+	}
+
+	throw runtime_error{ message.str() };
+}
+
+void AppContext::finishGlTrace() noexcept
+{
+	auto& trace = GlCallTrace::instance();
+	if (!trace.enabled())
+		return;
+
+	// the benchmark report has it already
+	if (!mOptions.bench)
+	{
+		try
+		{
+			trace.writeReport(cout);
+		}
+		catch (const exception& e)
+		{
+			cerr << "GL call report failed: " << e.what() << endl;
+		}
+	}
+
+	trace.disable();
+}
+
+void AppContext::finishCapture() noexcept
+{
+	auto& capture = GlCapture::instance();
+	if (!capture.capturing())
+		return;
+
+	try
+	{
+		capture.stop();
+		capture.writeReport(cout);
+	}
+	catch (const exception& e)
+	{
+		cerr << "GL capture failed: " << e.what() << endl;
+	}
+}
+
+void AppContext::finishTrace() noexcept
+{
+	if (mOptions.traceOutput.empty())
+		return;
+
+	auto& profiler = common::CpuProfiler::instance();
+	profiler.enable(false);
+
+	try
+	{
+		ofstream out{ mOptions.traceOutput };
+		profiler.writeChromeTrace(out);
+		if (!out)
+			cerr << "Unable to write the trace to " << mOptions.traceOutput << endl;
+	}
+	catch (const exception& e)
+	{
+		cerr << "Trace export failed: " << e.what() << endl;
+	}
+}
+
+void AppContext::finishBenchmark() noexcept
+{
+	if (!mBenchmark)
+		return;
+
+	try
+	{
+		if (mOptions.benchOutput.empty())
+		{
+			writeBenchmarkReport(cout);
+		}
+		else
+		{
+			ofstream out{ mOptions.benchOutput };
+			writeBenchmarkReport(out);
+			if (!out)
+				cerr << "Unable to write the benchmark report to " << mOptions.benchOutput << endl;
+		}
+	}
+	catch (const exception& e)
+	{
+		cerr << "Benchmark report failed: " << e.what() << endl;
+	}
+
+	mBenchmark.reset();
+}
+
+void AppContext::writeBenchmarkReport(ostream& out)
+{
+	if (!mBenchmark)
+		throw logic_error{ "AppContext is not in benchmark mode" };
+
+	mBenchmark->finish();
+	mGpuProfiler->finish();
+
+	out << "{\"name\":";
+	common::writeJson(out, mOptions.title);
+	out << ",\"backend\":";
+	common::writeJson(out, backendName(mOptions.backend));
+	out << ",\"renderer\":";
+	common::writeJson(out, glString(GL_RENDERER));
+	out << ",\"version\":";
+	common::writeJson(out, glString(GL_VERSION));
+	out << ",\"width\":" << mOptions.width
+		<< ",\"height\":" << mOptions.height
+		<< ",\"vsync\":" << (mOptions.vsync ? "true" : "false")
+		<< ",\"warmup\":" << mBenchmark->warmup()
+		<< ",\"frames\":" << mBenchmark->cpuMs().size()
+		<< ",\"cpu_ms\":";
+	common::writeJson(out, common::summarize(mBenchmark->cpuMs()));
+	out << ",\"gpu_ms\":";
+	common::writeJson(out, common::summarize(mBenchmark->gpuMs()));
+	out << ",\"gpu_scopes\":";
+	mGpuProfiler->writeJson(out);
+
+	if (GlCallTrace::instance().enabled())
+	{
+		out << ",\"gl_calls\":";
+		GlCallTrace::instance().writeJson(out);
+	}
+
+	out << "}" << endl;
+}
+
+void AppContext::release() noexcept
+{
+	if (mFramebuffer)
+	{
+		glDeleteFramebuffers(1, &mFramebuffer);
+		glDeleteRenderbuffers(1, &mColorBuffer);
+		glDeleteRenderbuffers(1, &mDepthBuffer);
+		mFramebuffer = 0;
+	}
+
+#if defined(COMMON_LIBS_HAS_EGL)
+	if (mEglDisplay)
+	{
+		eglMakeCurrent(mEglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+		if (mEglContext)
+			eglDestroyContext(mEglDisplay, mEglContext);
+		eglTerminate(mEglDisplay);
+		mEglDisplay = mEglContext = nullptr;
+	}
+#endif
+
+#if defined(COMMON_LIBS_HAS_OSMESA)
+	if (mOsMesaContext)
+	{
+		OSMesaDestroyContext(static_cast<OSMesaContext>(mOsMesaContext));
+		mOsMesaContext = nullptr;
+	}
+#endif
+
+	if (mWindow)
+	{
+		glfwDestroyWindow(mWindow);
+		glfwTerminate();
+		mWindow = nullptr;
+	}
+}
+
+bool AppContext::backendAvailable(ContextBackend backend) noexcept
+{
+	switch (backend)
+	{
+	case ContextBackend::window:
+		return true;
+
+	case ContextBackend::egl:
+#if defined(COMMON_LIBS_HAS_EGL)
+		return true;
+#else
+		return false;
+#endif
+
+	case ContextBackend::osmesa:
+#if defined(COMMON_LIBS_HAS_OSMESA)
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	return false;
+}
+
+void AppContext::createWindow()
+{
+	if (!glfwInit())
+		throw runtime_error{ "Unable to initialize GLFW" };
+
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, mOptions.glMajor);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, mOptions.glMinor);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+	glfwWindowHint(GLFW_VISIBLE, mOptions.visible ? GLFW_TRUE : GLFW_FALSE);
+
+	mWindow = glfwCreateWindow(mOptions.width, mOptions.height, mOptions.title.c_str(), nullptr, nullptr);
+
+	if (!mWindow)
+	{
+		const char* error = nullptr;
+		glfwGetError(&error);
+		glfwTerminate();
+
+		throw runtime_error{ string{ "Unable to open the window: " } + (error ? error : "unknown error") };
+	}
+
+	glfwMakeContextCurrent(mWindow);
+
+	if (!gladLoadGLLoader(reinterpret_cast<GLADloadproc>(glfwGetProcAddress)))
+		throw runtime_error{ "Failed to initialize GLAD" };
+
+	glfwSwapInterval(mOptions.vsync ? 1 : 0);
+}
+
+void AppContext::createEgl()
+{
+#if defined(COMMON_LIBS_HAS_EGL)
+	EGLDisplay display = EGL_NO_DISPLAY;
+
+	// a surfaceless Mesa display needs neither X nor a GPU node
+	const auto clientExtensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+	if (hasExtension(clientExtensions, "EGL_MESA_platform_surfaceless"))
+	{
+		const auto getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+		if (getPlatformDisplay)
+			display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+	}
+
+	if (display == EGL_NO_DISPLAY)
+		display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+
+	if (display == EGL_NO_DISPLAY || !eglInitialize(display, nullptr, nullptr))
+		throw runtime_error{ "Unable to initialize an EGL display" };
+
+	mEglDisplay = display;
+
+	const auto extensions = eglQueryString(display, EGL_EXTENSIONS);
+	if (!hasExtension(extensions, "EGL_KHR_surfaceless_context"))
+		throw runtime_error{ "EGL display does not support surfaceless contexts" };
+
+	if (!eglBindAPI(EGL_OPENGL_API))
+		throw runtime_error{ "EGL display does not support desktop OpenGL" };
+
+	EGLConfig config = EGL_NO_CONFIG_KHR;
+	if (!hasExtension(extensions, "EGL_KHR_no_config_context"))
+	{
+		const EGLint configAttributes[] = {
+			EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+			EGL_NONE
+		};
+
+		EGLint count = 0;
+		if (!eglChooseConfig(display, configAttributes, &config, 1, &count) || count == 0)
+			throw runtime_error{ "No EGL config renders desktop OpenGL" };
+	}
+
+	const EGLint contextAttributes[] = {
+		EGL_CONTEXT_MAJOR_VERSION, mOptions.glMajor,
+		EGL_CONTEXT_MINOR_VERSION, mOptions.glMinor,
+		EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+		EGL_NONE
+	};
+
+	const auto context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttributes);
+	if (context == EGL_NO_CONTEXT)
+		throw runtime_error{ "Unable to create an OpenGL " + to_string(mOptions.glMajor) + "." + to_string(mOptions.glMinor) + " EGL context" };
+
+	mEglContext = context;
+
+	if (!eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context))
+		throw runtime_error{ "Unable to make the EGL context current" };
+
+	if (!gladLoadGLLoader(eglLoader))
+		throw runtime_error{ "Failed to initialize GLAD" };
+#else
+	throw runtime_error{ "common_libs was built without EGL (USE_EGL)" };
+#endif
+}
+
+void AppContext::createOsMesa()
+{
+#if defined(COMMON_LIBS_HAS_OSMESA)
+	const int attributes[] = {
+		OSMESA_FORMAT, OSMESA_RGBA,
+		OSMESA_DEPTH_BITS, 0,
+		OSMESA_PROFILE, OSMESA_CORE_PROFILE,
+		OSMESA_CONTEXT_MAJOR_VERSION, mOptions.glMajor,
+		OSMESA_CONTEXT_MINOR_VERSION, mOptions.glMinor,
+		0
+	};
+
+	const auto context = OSMesaCreateContextAttribs(attributes, nullptr);
+	if (!context)
+		throw runtime_error{ "Unable to create an OpenGL " + to_string(mOptions.glMajor) + "." + to_string(mOptions.glMinor) + " OSMesa context" };
+
+	mOsMesaContext = context;
+
+	// OSMesa wants a color buffer to be current; drawing goes to the FBO
+	mOsMesaBuffer.assign(4, 0);
+	if (!OSMesaMakeCurrent(context, mOsMesaBuffer.data(), GL_UNSIGNED_BYTE, 1, 1))
+		throw runtime_error{ "Unable to make the OSMesa context current" };
+
+	if (!gladLoadGLLoader(osMesaLoader))
+		throw runtime_error{ "Failed to initialize GLAD" };
+#else
+	throw runtime_error{ "common_libs was built without OSMesa (USE_OSMESA)" };
+#endif
+}
+
+void AppContext::createFramebuffer()
+{
+	glGenRenderbuffers(1, &mColorBuffer);
+	glBindRenderbuffer(GL_RENDERBUFFER, mColorBuffer);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, mOptions.width, mOptions.height);
+
+	glGenRenderbuffers(1, &mDepthBuffer);
+	glBindRenderbuffer(GL_RENDERBUFFER, mDepthBuffer);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, mOptions.width, mOptions.height);
+	glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+	glGenFramebuffers(1, &mFramebuffer);
+	glBindFramebuffer(GL_FRAMEBUFFER, mFramebuffer);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, mColorBuffer);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, mDepthBuffer);
+
+	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+		throw runtime_error{ "The headless framebuffer is incomplete" };
+
+	glViewport(0, 0, mOptions.width, mOptions.height);
+}
+
+uint64_t AppContext::frameLimit() const noexcept
+{
+	return mOptions.frames ? mOptions.frames + (mBenchmark ? mBenchmark->warmup() : 0) : 0;
+}
+
+bool AppContext::running() const
+{
+	if (mOptions.frames && mFrame >= frameLimit())
+		return false;
+
+	return !mWindow || !glfwWindowShouldClose(mWindow);
+}
+
+void AppContext::pollEvents()
+{
+	if (mWindow)
+		glfwPollEvents();
+}
+
+void AppContext::swapBuffers()
+{
+	COMMON_PROFILE_SCOPE("swapBuffers");
+
+	checkAllocations();
+
+	// before the swap leaves the back buffer undefined
+	if (!mOptions.screenshotOutput.empty() && mFrame + 1 == frameLimit())
+		writeScreenshot();
+
+	GlCapture::instance().frameEnd();
+
+	auto& glTrace = GlCallTrace::instance();
+	glTrace.frameEnd();
+	if (mBenchmark && mFrame + 1 == mBenchmark->warmup())
+		glTrace.reset();
+	mGpuProfiler->endFrame();
+	if (mBenchmark)
+		mBenchmark->frameEnd();
+
+	if (mWindow && mOptions.gpuTitle && mFrame % title_interval == 0)
+		glfwSetWindowTitle(mWindow, (mOptions.title + "  |  " + mGpuProfiler->summary()).c_str());
+
+	if (mWindow)
+		glfwSwapBuffers(mWindow);
+	else
+		glFlush();
+
+	// a frame runs from one swap to the next
+	auto& profiler = common::CpuProfiler::instance();
+	const auto now = common::CpuProfiler::now();
+	if (profiler.enabled())
+		profiler.record("frame", mFrameStart, now);
+	mFrameStart = now;
+
+	++mFrame;
+}
+
+double AppContext::time() const
+{
+	return mWindow ? glfwGetTime() : static_cast<double>(mFrame) * headless_frame_time;
+}
+
+void AppContext::writeScreenshot()
+{
+	int width = mOptions.width;
+	int height = mOptions.height;
+	if (mWindow)
+		glfwGetFramebufferSize(mWindow, &width, &height);
+
+	vector<unsigned char> rgba;
+	readPixels(rgba);
+	common::writePng(mOptions.screenshotOutput, width, height, rgba.data(), true);
+}
+
+void AppContext::readPixels(vector<unsigned char>& rgba) const
+{
+	int width = mOptions.width;
+	int height = mOptions.height;
+	if (mWindow)
+		glfwGetFramebufferSize(mWindow, &width, &height);
+
+	rgba.resize(static_cast<size_t>(width) * height * 4);
+
+	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+	glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, rgba.data());
+}
+
+} // glsl
@@ -0,0 +1,134 @@
+#include <camera.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace common {
+
+using namespace std;
+
+Camera::Camera(float fovY, int viewportWidth, int viewportHeight, float zNear, float zFar)
+	: mPosition{ 0.0f }
+	, mOrientation{ 1.0f, 0.0f, 0.0f, 0.0f }
+	, mFovY{ fovY }
+	, mAspect{ viewportHeight > 0 ? static_cast<float>(viewportWidth) / viewportHeight : 1.0f }
+	, mNear{ zNear }
+	, mFar{ zFar }
+	, mVersion{ 0 }
+	, mDirty{ dirty_all }
+{
+}
+
+void Camera::setPosition(const glm::vec3& position)
+{
+	if (position == mPosition)
+		return;
+
+	mPosition = position;
+	invalidate(dirty_view);
+}
+
+void Camera::setOrientation(const glm::quat& orientation)
+{
+	if (orientation == mOrientation)
+		return;
+
+	mOrientation = orientation;
+	invalidate(dirty_view);
+}
+
+void Camera::lookAt(const glm::vec3& eye, const glm::vec3& target, const glm::vec3& up)
+{
+	const auto orientation = glm::quatLookAt(glm::normalize(target - eye), up);
+	if (eye == mPosition && orientation == mOrientation)
+		return;
+
+	// one change, one version bump
+	mPosition = eye;
+	mOrientation = orientation;
+	invalidate(dirty_view);
+}
+
+void Camera::setFov(float fovY)
+{
+	if (fovY == mFovY)
+		return;
+
+	mFovY = fovY;
+	invalidate(dirty_projection);
+}
+
+void Camera::setClipPlanes(float zNear, float zFar)
+{
+	if (zNear == mNear && zFar == mFar)
+		return;
+
+	mNear = zNear;
+	mFar = zFar;
+	invalidate(dirty_projection);
+}
+
+void Camera::setViewport(int width, int height)
+{
+	if (width <= 0 || height <= 0)
+		return;
+
+	const auto aspect = static_cast<float>(width) / height;
+	if (aspect == mAspect)
+		return;
+
+	mAspect = aspect;
+	invalidate(dirty_projection);
+}
+
+const glm::mat4& Camera::view() const
+{
+	if (mDirty & dirty_view)
+	{
+		mView = glm::mat4_cast(glm::conjugate(mOrientation));
+		mView = glm::translate(mView, -mPosition);
+		mDirty &= ~dirty_view;
+	}
+
+	return mView;
+}
+
+const glm::mat4& Camera::projection() const
+{
+	if (mDirty & dirty_projection)
+	{
+		mProjection = glm::perspective(mFovY, mAspect, mNear, mFar);
+		mDirty &= ~dirty_projection;
+	}
+
+	return mProjection;
+}
+
+const glm::mat4& Camera::viewProjection() const
+{
+	if (mDirty & dirty_view_projection)
+	{
+		mViewProjection = projection() * view();
+		mDirty &= ~dirty_view_projection;
+	}
+
+	return mViewProjection;
+}
+
+const Frustum& Camera::frustum() const
+{
+	if (mDirty & dirty_frustum)
+	{
+		mFrustum = Frustum::fromMatrix(viewProjection());
+		mDirty &= ~dirty_frustum;
+	}
+
+	return mFrustum;
+}
+
+void Camera::invalidate(unsigned flags) noexcept
+{
+	// everything derived from the view or the projection goes stale with it
+	mDirty |= flags | dirty_view_projection | dirty_frustum;
+	++mVersion;
+}
+
+} // common
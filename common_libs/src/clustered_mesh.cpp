@@ -0,0 +1,65 @@
+#include <clustered_mesh.hpp>
+#include <algorithm>
+#include <stdexcept>
+
+namespace glsl {
+
+using namespace std;
+
+ClusteredMesh::ClusteredMesh(GeometryArena& arena, const void* vertices, GLsizei vertexCount,
+	const GLuint* indices, GLsizei indexCount, const common::MeshletLimits& limits)
+	: mArena{ arena }
+{
+	const auto& layout = arena.layout();
+	const auto position = find_if(layout.attributes.begin(), layout.attributes.end(), [](const VertexAttribute& a)
+	{
+		return a.location == 0;
+	});
+
+	if (position == layout.attributes.end() || position->type != GL_FLOAT || position->components < 3)
+		throw invalid_argument{ "ClusteredMesh needs float positions at location 0" };
+
+	auto clustered = common::buildMeshlets(static_cast<const unsigned char*>(vertices) + position->offset, layout.stride,
+		static_cast<size_t>(vertexCount), indices, static_cast<size_t>(indexCount), limits);
+
+	mRange = arena.add(vertices, vertexCount, clustered.indices.data(), static_cast<GLsizei>(clustered.indices.size()));
+	mMeshlets = move(clustered.meshlets);
+}
+
+ClusteredMesh::~ClusteredMesh()
+{
+	mArena.remove(mRange);
+}
+
+ClusterCullStats ClusteredMesh::cull(const glm::mat4& model, const glm::vec3& eye, const common::Frustum& frustum, IndirectDrawBatch& batch) const
+{
+	ClusterCullStats stats;
+	stats.clusters = static_cast<uint32_t>(mMeshlets.size());
+
+	for (const auto& meshlet : mMeshlets)
+	{
+		switch (common::cullMeshlet(meshlet, model, eye, frustum))
+		{
+		case common::MeshletVisibility::outside:
+			++stats.outside;
+			continue;
+
+		case common::MeshletVisibility::backfacing:
+			++stats.backfacing;
+			continue;
+
+		default:
+			break;
+		}
+
+		auto cluster = mRange;
+		cluster.firstIndex += meshlet.firstIndex;
+		cluster.indexCount = static_cast<GLsizei>(meshlet.triangleCount * 3);
+		batch.add(cluster, model);
+		stats.triangles += meshlet.triangleCount;
+	}
+
+	return stats;
+}
+
+} // glsl
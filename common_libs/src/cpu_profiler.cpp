@@ -0,0 +1,165 @@
+#include <cpu_profiler.hpp>
+#include <frame_stats.hpp>
+#include <chrono>
+#include <cstdio>
+#include <ostream>
+#include <string>
+
+namespace common {
+
+using namespace std;
+
+namespace {
+
+	thread_local void* tlsBuffer = nullptr;
+	thread_local const char* tlsName = nullptr;
+}
+
+CpuProfiler& CpuProfiler::instance()
+{
+	static CpuProfiler profiler;
+	return profiler;
+}
+
+uint64_t CpuProfiler::now() noexcept
+{
+	return static_cast<uint64_t>(chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+CpuProfiler::CpuProfiler()
+	: mStart{ now() }
+{
+}
+
+CpuProfiler::~CpuProfiler() = default;
+
+CpuProfiler::ThreadBuffer::~ThreadBuffer()
+{
+	for (auto chunk = head.next.load(memory_order_relaxed); chunk;)
+	{
+		const auto next = chunk->next.load(memory_order_relaxed);
+		delete chunk;
+		chunk = next;
+	}
+}
+
+CpuProfiler::ThreadBuffer& CpuProfiler::threadBuffer()
+{
+	if (!tlsBuffer)
+	{
+		lock_guard<mutex> lock{ mMutex };
+		mThreads.push_back(make_unique<ThreadBuffer>(static_cast<uint32_t>(mThreads.size() + 1)));
+		mThreads.back()->name.store(tlsName, memory_order_relaxed);
+		tlsBuffer = mThreads.back().get();
+	}
+
+	return *static_cast<ThreadBuffer*>(tlsBuffer);
+}
+
+void CpuProfiler::record(const char* name, uint64_t begin, uint64_t end)
+{
+	auto& buffer = threadBuffer();
+
+	auto chunk = buffer.tail;
+	auto count = chunk->count.load(memory_order_relaxed);
+	if (count == chunk_size)
+	{
+		auto next = new Chunk;
+		chunk->next.store(next, memory_order_release);
+		buffer.tail = chunk = next;
+		count = 0;
+	}
+
+	chunk->events[count] = { name, begin, end };
+	chunk->count.store(count + 1, memory_order_release);
+}
+
+void CpuProfiler::setThreadName(const char* name)
+{
+	// threads that never record get no buffer
+	tlsName = name;
+	if (tlsBuffer)
+		static_cast<ThreadBuffer*>(tlsBuffer)->name.store(name, memory_order_relaxed);
+}
+
+size_t CpuProfiler::eventCount() const
+{
+	lock_guard<mutex> lock{ mMutex };
+
+	size_t count = 0;
+	for (const auto& buffer : mThreads)
+	{
+		for (auto chunk = &buffer->head; chunk; chunk = chunk->next.load(memory_order_acquire))
+			count += chunk->count.load(memory_order_acquire);
+	}
+
+	return count;
+}
+
+void CpuProfiler::writeChromeTrace(ostream& out) const
+{
+	lock_guard<mutex> lock{ mMutex };
+
+	out << "{\"traceEvents\":[";
+
+	auto first = true;
+	auto separate = [&]
+	{
+		if (!first)
+			out << ",\n";
+		first = false;
+	};
+
+	char text[128];
+	for (const auto& buffer : mThreads)
+	{
+		if (auto name = buffer->name.load(memory_order_relaxed))
+		{
+			separate();
+			snprintf(text, sizeof(text), "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":", buffer->id);
+			out << text;
+			writeJson(out, string{ name });
+			out << "}}";
+		}
+
+		for (auto chunk = &buffer->head; chunk; chunk = chunk->next.load(memory_order_acquire))
+		{
+			const auto count = chunk->count.load(memory_order_acquire);
+			for (size_t i = 0; i < count; ++i)
+			{
+				const auto& event = chunk->events[i];
+
+				separate();
+				out << "{\"name\":";
+				writeJson(out, string{ event.name });
+				snprintf(text, sizeof(text), ",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u}",
+					static_cast<double>(event.begin - mStart) * 1e-3,
+					static_cast<double>(event.end - event.begin) * 1e-3,
+					buffer->id);
+				out << text;
+			}
+		}
+	}
+
+	out << "],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+void CpuProfiler::clear()
+{
+	lock_guard<mutex> lock{ mMutex };
+
+	for (auto& buffer : mThreads)
+	{
+		for (auto chunk = buffer->head.next.exchange(nullptr, memory_order_relaxed); chunk;)
+		{
+			const auto next = chunk->next.load(memory_order_relaxed);
+			delete chunk;
+			chunk = next;
+		}
+
+		buffer->head.count.store(0, memory_order_relaxed);
+		buffer->tail = &buffer->head;
+	}
+}
+
+} // common
@@ -0,0 +1,121 @@
+#include <frame_arena.hpp>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace common {
+
+using namespace std;
+
+namespace {
+
+	uintptr_t alignUp(uintptr_t address, size_t alignment) noexcept
+	{
+		return (address + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+	}
+}
+
+LinearArena::LinearArena(size_t capacity)
+	: mBuffer{ new unsigned char[capacity] }
+	, mCapacity{ capacity }
+{
+}
+
+LinearArena::~LinearArena() = default;
+
+void* LinearArena::allocate(size_t bytes, size_t alignment)
+{
+	const auto base = reinterpret_cast<uintptr_t>(mBuffer.get());
+
+	auto offset = mOffset.load(memory_order_relaxed);
+	for (;;)
+	{
+		// written so that a huge bytes cannot wrap around past the check
+		const auto begin = alignUp(base + offset, alignment) - base;
+		if (begin > mCapacity || bytes > mCapacity - begin)
+			return allocateOverflow(bytes, alignment);
+
+		// relaxed is enough: the bytes handed out are nobody else's
+		if (mOffset.compare_exchange_weak(offset, begin + bytes, memory_order_relaxed))
+			return mBuffer.get() + begin;
+	}
+}
+
+void* LinearArena::allocateOverflow(size_t bytes, size_t alignment)
+{
+	if (bytes > numeric_limits<size_t>::max() - (alignment - 1))
+		throw length_error{ "LinearArena allocation is too large" };
+
+	const auto size = bytes + alignment - 1;
+	// new[] rather than make_unique, which would zero the bytes
+	unique_ptr<unsigned char[]> block{ new unsigned char[size] };
+	const auto address = alignUp(reinterpret_cast<uintptr_t>(block.get()), alignment);
+
+	lock_guard<mutex> lock{ mOverflowMutex };
+	mOverflow.push_back(move(block));
+	mOverflowBytes.fetch_add(size, memory_order_relaxed);
+
+	return reinterpret_cast<void*>(address);
+}
+
+void LinearArena::reset()
+{
+	const auto bytes = used();
+	mHighWater = max(mHighWater, bytes);
+
+	if (!mOverflow.empty())
+	{
+		// the one heap allocation a steady frame makes, and only until it fits
+		mCapacity = max(mCapacity * 2, bytes);
+		mBuffer.reset(new unsigned char[mCapacity]);
+		mOverflow.clear();
+		mOverflowBytes.store(0, memory_order_relaxed);
+	}
+
+	mOffset.store(0, memory_order_relaxed);
+}
+
+size_t LinearArena::highWater() const noexcept
+{
+	return max(mHighWater, used());
+}
+
+size_t LinearArena::overflows() const
+{
+	lock_guard<mutex> lock{ mOverflowMutex };
+	return mOverflow.size();
+}
+
+FrameArena::FrameArena(size_t framesInFlight, size_t capacity)
+{
+	if (framesInFlight == 0)
+		throw invalid_argument{ "FrameArena needs at least one frame in flight" };
+
+	for (size_t i = 0; i < framesInFlight; ++i)
+		mFrames.push_back(make_unique<LinearArena>(capacity));
+}
+
+LinearArena& FrameArena::begin(uint64_t frame)
+{
+	auto& arena = (*this)[frame];
+	arena.reset();
+	return arena;
+}
+
+size_t FrameArena::highWater() const noexcept
+{
+	size_t bytes = 0;
+	for (const auto& arena : mFrames)
+		bytes = max(bytes, arena->highWater());
+	return bytes;
+}
+
+size_t FrameArena::capacity() const noexcept
+{
+	size_t bytes = 0;
+	for (const auto& arena : mFrames)
+		bytes += arena->capacity();
+	return bytes;
+}
+
+} // common
\ No newline at end of file
@@ -0,0 +1,74 @@
+#include <frame_benchmark.hpp>
+#include <algorithm>
+
+namespace glsl {
+
+using namespace std;
+
+FrameBenchmark::FrameBenchmark(uint64_t warmup, uint64_t frames)
+	: mWarmup{ max<uint64_t>(warmup, 1) }
+	, mFrameStart{ Clock::now() }
+{
+	mCpuMs.reserve(frames);
+	mGpuMs.reserve(frames);
+
+	glGenQueries(static_cast<GLsizei>(mQueries.size()), mQueries.data());
+	glBeginQuery(GL_TIME_ELAPSED, mQueries[mSlot]);
+}
+
+FrameBenchmark::~FrameBenchmark()
+{
+	if (!mFinished)
+		glEndQuery(GL_TIME_ELAPSED);
+
+	glDeleteQueries(static_cast<GLsizei>(mQueries.size()), mQueries.data());
+}
+
+void FrameBenchmark::frameEnd()
+{
+	if (mFinished)
+		return;
+
+	const auto now = Clock::now();
+	if (mFrame >= mWarmup)
+		mCpuMs.push_back(chrono::duration<double, milli>(now - mFrameStart).count());
+	mFrameStart = now;
+
+	glEndQuery(GL_TIME_ELAPSED);
+	mQueryFrames[mSlot] = mFrame;
+	mPending[mSlot] = true;
+
+	mSlot = (mSlot + 1) % mQueries.size();
+	collect(mSlot);
+	glBeginQuery(GL_TIME_ELAPSED, mQueries[mSlot]);
+
+	++mFrame;
+}
+
+void FrameBenchmark::finish()
+{
+	if (mFinished)
+		return;
+
+	// the query running now covers a frame that never ended
+	glEndQuery(GL_TIME_ELAPSED);
+	mFinished = true;
+
+	for (size_t i = 1; i <= mQueries.size(); ++i)
+		collect((mSlot + i) % mQueries.size());
+}
+
+void FrameBenchmark::collect(size_t slot)
+{
+	if (!mPending[slot])
+		return;
+
+	GLuint64 elapsed = 0;
+	glGetQueryObjectui64v(mQueries[slot], GL_QUERY_RESULT, &elapsed);
+	mPending[slot] = false;
+
+	if (mQueryFrames[slot] >= mWarmup)
+		mGpuMs.push_back(static_cast<double>(elapsed) * 1e-6);
+}
+
+} // glsl
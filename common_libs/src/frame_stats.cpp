@@ -0,0 +1,93 @@
+#include <frame_stats.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <ostream>
+
+namespace common {
+
+using namespace std;
+
+namespace {
+
+	// samples must be sorted and not empty
+	double percentile(const vector<double>& samples, double p) noexcept
+	{
+		const auto rank = p * static_cast<double>(samples.size() - 1);
+		const auto below = static_cast<size_t>(rank);
+		const auto above = min(below + 1, samples.size() - 1);
+		const auto t = rank - static_cast<double>(below);
+
+		return samples[below] + (samples[above] - samples[below]) * t;
+	}
+}
+
+TimingSummary summarize(vector<double> samples)
+{
+	TimingSummary summary;
+	if (samples.empty())
+		return summary;
+
+	sort(samples.begin(), samples.end());
+
+	auto sum = 0.0;
+	for (auto s : samples)
+		sum += s;
+
+	summary.count = samples.size();
+	summary.min = samples.front();
+	summary.mean = sum / static_cast<double>(samples.size());
+	summary.p50 = percentile(samples, 0.50);
+	summary.p95 = percentile(samples, 0.95);
+	summary.p99 = percentile(samples, 0.99);
+	summary.max = samples.back();
+
+	return summary;
+}
+
+void writeJson(ostream& out, const TimingSummary& summary)
+{
+	char text[256];
+	snprintf(text, sizeof(text),
+		"{\"count\":%zu,\"min\":%.6f,\"mean\":%.6f,\"p50\":%.6f,\"p95\":%.6f,\"p99\":%.6f,\"max\":%.6f}",
+		summary.count, summary.min, summary.mean, summary.p50, summary.p95, summary.p99, summary.max);
+
+	out << text;
+}
+
+void writeJson(ostream& out, const string& text)
+{
+	out << '"';
+	for (auto c : text)
+	{
+		switch (c)
+		{
+		case '"':
+			out << "\\\"";
+			break;
+
+		case '\\':
+			out << "\\\\";
+			break;
+
+		case '\n':
+			out << "\\n";
+			break;
+
+		default:
+			if (static_cast<unsigned char>(c) < 0x20)
+			{
+				char escaped[8];
+				snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+				out << escaped;
+			}
+			else
+			{
+				out << c;
+			}
+			break;
+		}
+	}
+	out << '"';
+}
+
+} // common
@@ -0,0 +1,122 @@
+#include <geometry_arena.hpp>
+#include <algorithm>
+#include <stdexcept>
+
+namespace glsl {
+
+using namespace std;
+
+GeometryArena::Page::Page(const VertexLayout& layout, uint32_t vertexCount, uint32_t indexCount)
+	: vertexBuffer{ static_cast<GLsizeiptr>(vertexCount) * layout.stride, nullptr, GL_DYNAMIC_STORAGE_BIT }
+	, indexBuffer{ static_cast<GLsizeiptr>(indexCount * sizeof(GLuint)), nullptr, GL_DYNAMIC_STORAGE_BIT }
+	, vertexSpace{ vertexCount }
+	, indexSpace{ indexCount }
+{
+	vao.vertexBuffer(0, vertexBuffer, 0, layout.stride);
+	vao.elementBuffer(indexBuffer);
+	vao.format(0, layout);
+}
+
+GeometryArena::GeometryArena(VertexLayout layout, uint32_t verticesPerPage, uint32_t indicesPerPage)
+	: mLayout{ move(layout) }
+	, mVerticesPerPage{ verticesPerPage }
+	, mIndicesPerPage{ indicesPerPage }
+{
+	if (mLayout.stride <= 0)
+		throw invalid_argument{ "GeometryArena needs a vertex stride" };
+}
+
+MeshRange GeometryArena::add(const void* vertices, GLsizei vertexCount, const GLuint* indices, GLsizei indexCount)
+{
+	if (vertexCount <= 0 || indexCount <= 0)
+		throw invalid_argument{ "GeometryArena::add of an empty mesh" };
+
+	if (static_cast<uint32_t>(vertexCount) > mVerticesPerPage || static_cast<uint32_t>(indexCount) > mIndicesPerPage)
+		throw length_error{ "mesh is larger than a GeometryArena page" };
+
+	MeshRange mesh;
+	mesh.vertexCount = vertexCount;
+	mesh.indexCount = indexCount;
+
+	auto placed = false;
+	for (uint32_t i = 0; i < mPages.size() && !placed; ++i)
+	{
+		auto& page = *mPages[i];
+
+		mesh.vertices = page.vertexSpace.allocate(vertexCount);
+		if (!mesh.vertices)
+			continue;
+
+		mesh.indices = page.indexSpace.allocate(indexCount);
+		if (!mesh.indices)
+		{
+			page.vertexSpace.free(mesh.vertices);
+			continue;
+		}
+
+		mesh.page = i;
+		placed = true;
+	}
+
+	if (!placed)
+	{
+		mPages.push_back(make_unique<Page>(mLayout, mVerticesPerPage, mIndicesPerPage));
+		auto& page = *mPages.back();
+
+		mesh.page = static_cast<uint32_t>(mPages.size() - 1);
+		mesh.vertices = page.vertexSpace.allocate(vertexCount);
+		mesh.indices = page.indexSpace.allocate(indexCount);
+	}
+
+	auto& page = *mPages[mesh.page];
+	mesh.baseVertex = static_cast<GLint>(mesh.vertices.offset);
+	mesh.firstIndex = mesh.indices.offset;
+
+	page.vertexBuffer.subData(static_cast<GLintptr>(mesh.vertices.offset) * mLayout.stride,
+		static_cast<GLsizeiptr>(vertexCount) * mLayout.stride, vertices);
+	page.indexBuffer.subData(static_cast<GLintptr>(mesh.indices.offset) * sizeof(GLuint),
+		static_cast<GLsizeiptr>(indexCount) * sizeof(GLuint), indices);
+
+	return mesh;
+}
+
+void GeometryArena::remove(const MeshRange& mesh)
+{
+	auto& page = *mPages.at(mesh.page);
+	page.vertexSpace.free(mesh.vertices);
+	page.indexSpace.free(mesh.indices);
+}
+
+void GeometryArena::draw(const MeshRange& mesh, GLenum mode) const
+{
+	mPages[mesh.page]->vao.bind();
+	glDrawElementsBaseVertex(mode, mesh.indexCount, GL_UNSIGNED_INT,
+		reinterpret_cast<const void*>(static_cast<uintptr_t>(mesh.firstIndex) * sizeof(GLuint)),
+		mesh.baseVertex);
+}
+
+GeometryArena::Stats GeometryArena::stats() const
+{
+	auto accumulate = [](common::OffsetAllocator::Stats& total, const common::OffsetAllocator::Stats& s)
+	{
+		total.capacity += s.capacity;
+		total.used += s.used;
+		total.free += s.free;
+		total.largestFree = max(total.largestFree, s.largestFree);
+		total.freeBlocks += s.freeBlocks;
+		total.allocations += s.allocations;
+	};
+
+	Stats stats;
+	stats.pages = static_cast<uint32_t>(mPages.size());
+
+	for (const auto& page : mPages)
+	{
+		accumulate(stats.vertices, page->vertexSpace.stats());
+		accumulate(stats.indices, page->indexSpace.stats());
+	}
+
+	return stats;
+}
+
+} // glsl
@@ -0,0 +1,1589 @@
+#include <gl_capture.hpp>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <ostream>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+namespace glsl {
+
+using namespace std;
+
+namespace {
+
+	// fn_ pastes the name before glad's #define turns it into glad_gl*
+	enum Function : size_t {
+#define GL_TRACE_FUNCTION(name) fn_##name,
+#include "gl_trace_functions.inl"
+#undef GL_TRACE_FUNCTION
+		function_count
+	};
+
+	const char* const function_names[] = {
+#define GL_TRACE_FUNCTION(name) #name,
+#include "gl_trace_functions.inl"
+#undef GL_TRACE_FUNCTION
+	};
+
+	// File layout: the magic, width and height as u32, frames and calls as
+	// u64 (little endian, patched by stop()), then records. Integers in
+	// records are LEB128 varints, signed ones zigzag encoded.
+	//   call:      record_call, function id, arguments, mapped data, results
+	//   frame:     record_frame
+	//   function:  record_function, function id, name length, name
+	// A function record names an id before its first call, so a replay
+	// built from another glad still finds the entry points.
+	constexpr char file_magic[8] = { 'G', 'L', 'C', 'A', 'P', 'T', '0', '1' };
+	constexpr size_t header_size = sizeof(file_magic) + 4 + 4 + 8 + 8;
+
+	enum Record : uint8_t { record_call, record_frame, record_function };
+
+	// pointer arguments start with a tag: null, an offset into a bound
+	// buffer (followed by the offset), or tag_data + the element count
+	constexpr uint64_t tag_null = 0;
+	constexpr uint64_t tag_offset = 1;
+	constexpr uint64_t tag_data = 2;
+
+	constexpr size_t max_arguments = 16;
+	constexpr size_t flush_size = size_t{ 1 } << 20;
+	constexpr size_t default_output_size = 64 * 1024;
+	constexpr size_t aligned_copy_size = 4096;
+
+	// dataSize() results that are not a size
+	constexpr size_t no_rule = SIZE_MAX;
+	constexpr size_t buffer_offset = SIZE_MAX - 1;
+
+	enum class ObjectKind : uint8_t {
+		none, buffer, texture, program, framebuffer, renderbuffer,
+		sampler, vertex_array, pipeline, query, transform_feedback
+	};
+
+	constexpr size_t object_kind_count = 11;
+
+	enum class Argument : uint8_t {
+		value,
+		name,                           // object name, mapped on replay
+		sync,                           // GLsync, mapped on replay
+		string,                         // NUL terminated
+		strings,                        // as many as the previous argument says
+		data,                           // sized by dataSize()
+		offset,                         // into a bound buffer
+		names,                          // array of object names
+		generated,                      // names written by glGen* / glCreate*
+		output,                         // written by GL; replay passes scratch
+		unsupported
+	};
+
+	enum class Result : uint8_t { none, name, sync, mapping };
+
+	struct NameArgument {
+		ObjectKind kind = ObjectKind::none;
+		int8_t count = -1;              // argument with the array length
+	};
+
+	struct FunctionArguments {
+		array<NameArgument, max_arguments> names{};
+		int8_t bufferSize = -1;
+		// uniform and vertex attribute arrays: the argument, the argument
+		// with their count (-1 for one) and the bytes of one element
+		int8_t vector = -1;
+		int8_t vectorCount = -1;
+		uint8_t vectorBytes = 0;
+	};
+
+	struct Signature {
+		size_t arity = 0;
+		bool supported = false;
+		Result result = Result::none;
+		array<Argument, max_arguments> arguments{};
+	};
+
+	struct PixelStore {
+		int64_t alignment = 4;
+		int64_t rowLength = 0;
+		int64_t imageHeight = 0;
+		int64_t skipPixels = 0;
+		int64_t skipRows = 0;
+		int64_t skipImages = 0;
+	};
+
+	struct PixelState {
+		PixelStore unpack;
+		PixelStore pack;
+		bool unpackBuffer = false;
+		bool packBuffer = false;
+	};
+
+	struct Mapping {
+		unsigned char* data;
+		size_t length;
+		bool write;
+	};
+
+	bool startsWith(const char* name, const char* prefix) noexcept
+	{
+		return !strncmp(name, prefix, strlen(prefix));
+	}
+
+	bool skip(const char*& name, const char* prefix) noexcept
+	{
+		if (!startsWith(name, prefix))
+			return false;
+
+		name += strlen(prefix);
+		return true;
+	}
+
+	size_t positive(int64_t value) noexcept
+	{
+		return value > 0 ? static_cast<size_t>(value) : 0;
+	}
+
+	template <typename T>
+	int64_t toRaw(T value) noexcept
+	{
+		if constexpr (is_pointer_v<T>)
+			return static_cast<int64_t>(reinterpret_cast<intptr_t>(value));
+		else if constexpr (is_floating_point_v<T>)
+			return isfinite(value) && fabs(value) < 4e18 ? static_cast<int64_t>(value) : 0;
+		else if constexpr (is_integral_v<T>)
+			return static_cast<int64_t>(value);
+		else
+			return 0;
+	}
+
+	// Bytes of the element type a vector entry point ends in: f, d, i, ui,
+	// i64, ui64, b, s, ub, us. Moves past it.
+	uint8_t elementBytes(const char*& name) noexcept
+	{
+		if (skip(name, "ui64") || skip(name, "i64") || skip(name, "d"))
+			return 8;
+
+		if (skip(name, "ui") || skip(name, "i") || skip(name, "f"))
+			return 4;
+
+		if (skip(name, "us") || skip(name, "s"))
+			return 2;
+
+		if (skip(name, "ub") || skip(name, "b"))
+			return 1;
+
+		return 0;
+	}
+
+	// glUniform4fv, glProgramUniformMatrix3x4dv, glVertexAttribI4uiv, ..
+	void parseVector(const char* name, FunctionArguments& arguments)
+	{
+		auto p = name + 2;
+		const auto program = skip(p, "Program");
+
+		if (skip(p, "Uniform"))
+		{
+			const auto matrix = skip(p, "Matrix");
+			if (*p < '1' || *p > '4')
+				return;
+
+			const auto rows = *p++ - '0';
+			auto columns = matrix ? rows : 1;
+			if (matrix && *p == 'x')
+			{
+				if (p[1] < '1' || p[1] > '4')
+					return;
+
+				columns = p[1] - '0';
+				p += 2;
+			}
+
+			const auto bytes = elementBytes(p);
+			if (!bytes || *p != 'v')
+				return;
+
+			const auto count = program ? 2 : 1;
+			arguments.vector = static_cast<int8_t>(count + (matrix ? 2 : 1));
+			arguments.vectorCount = static_cast<int8_t>(count);
+			arguments.vectorBytes = static_cast<uint8_t>(rows * columns * bytes);
+		}
+		else if (!program && skip(p, "VertexAttrib"))
+		{
+			if (!skip(p, "I"))
+				skip(p, "L");
+
+			if (*p < '1' || *p > '4')
+				return;
+
+			const auto components = *p++ - '0';
+			skip(p, "N");
+
+			const auto bytes = elementBytes(p);
+			if (!bytes || *p != 'v')
+				return;
+
+			arguments.vector = 1;
+			arguments.vectorBytes = static_cast<uint8_t>(components * bytes);
+		}
+	}
+
+	const array<FunctionArguments, function_count>& argumentTable()
+	{
+		static const auto table = []
+		{
+			array<FunctionArguments, function_count> table{};
+			for (size_t i = 0; i < function_count; ++i)
+				parseVector(function_names[i], table[i]);
+
+#define GL_CAPTURE_NAME(function, index, kind) table[fn_##function].names[index] = { ObjectKind::kind, -1 };
+#define GL_CAPTURE_NAMES(function, index, kind, count) table[fn_##function].names[index] = { ObjectKind::kind, count };
+#define GL_CAPTURE_BUFFER_SIZE(function, index) table[fn_##function].bufferSize = index;
+#include "gl_capture_arguments.inl"
+#undef GL_CAPTURE_NAME
+#undef GL_CAPTURE_NAMES
+#undef GL_CAPTURE_BUFFER_SIZE
+
+			return table;
+		}();
+
+		return table;
+	}
+
+	size_t pixelSize(int64_t format, int64_t type) noexcept
+	{
+		switch (type)
+		{
+		case GL_UNSIGNED_BYTE_3_3_2:
+		case GL_UNSIGNED_BYTE_2_3_3_REV:
+			return 1;
+
+		case GL_UNSIGNED_SHORT_5_6_5:
+		case GL_UNSIGNED_SHORT_5_6_5_REV:
+		case GL_UNSIGNED_SHORT_4_4_4_4:
+		case GL_UNSIGNED_SHORT_4_4_4_4_REV:
+		case GL_UNSIGNED_SHORT_5_5_5_1:
+		case GL_UNSIGNED_SHORT_1_5_5_5_REV:
+			return 2;
+
+		case GL_UNSIGNED_INT_8_8_8_8:
+		case GL_UNSIGNED_INT_8_8_8_8_REV:
+		case GL_UNSIGNED_INT_10_10_10_2:
+		case GL_UNSIGNED_INT_2_10_10_10_REV:
+		case GL_UNSIGNED_INT_24_8:
+		case GL_UNSIGNED_INT_10F_11F_11F_REV:
+		case GL_UNSIGNED_INT_5_9_9_9_REV:
+			return 4;
+
+		case GL_FLOAT_32_UNSIGNED_INT_24_8_REV:
+			return 8;
+		}
+
+		size_t component = 0;
+		switch (type)
+		{
+		case GL_BYTE:
+		case GL_UNSIGNED_BYTE:
+			component = 1;
+			break;
+
+		case GL_SHORT:
+		case GL_UNSIGNED_SHORT:
+		case GL_HALF_FLOAT:
+			component = 2;
+			break;
+
+		case GL_INT:
+		case GL_UNSIGNED_INT:
+		case GL_FLOAT:
+			component = 4;
+			break;
+		}
+
+		switch (format)
+		{
+		case GL_RED:
+		case GL_GREEN:
+		case GL_BLUE:
+		case GL_ALPHA:
+		case GL_RED_INTEGER:
+		case GL_GREEN_INTEGER:
+		case GL_BLUE_INTEGER:
+		case GL_DEPTH_COMPONENT:
+		case GL_STENCIL_INDEX:
+			return component;
+
+		case GL_RG:
+		case GL_RG_INTEGER:
+		case GL_DEPTH_STENCIL:
+			return component * 2;
+
+		case GL_RGB:
+		case GL_BGR:
+		case GL_RGB_INTEGER:
+		case GL_BGR_INTEGER:
+			return component * 3;
+
+		case GL_RGBA:
+		case GL_BGRA:
+		case GL_RGBA_INTEGER:
+		case GL_BGRA_INTEGER:
+			return component * 4;
+		}
+
+		return 0;
+	}
+
+	// Bytes GL reads (or writes) for an image under the pixel store state,
+	// up to the last byte of the last pixel.
+	size_t imageSize(const PixelStore& store, int64_t width, int64_t height, int64_t depth, int64_t format, int64_t type) noexcept
+	{
+		const auto pixel = pixelSize(format, type);
+		if (width <= 0 || height <= 0 || depth <= 0 || !pixel)
+			return 0;
+
+		const auto alignment = max<size_t>(positive(store.alignment), 1);
+		const auto rowPixels = store.rowLength > 0 ? positive(store.rowLength) : positive(width);
+		const auto row = (rowPixels * pixel + alignment - 1) / alignment * alignment;
+		const auto rows = store.imageHeight > 0 ? positive(store.imageHeight) : positive(height);
+
+		return ((positive(store.skipImages) + positive(depth) - 1) * rows + positive(store.skipRows) + positive(height) - 1) * row
+			+ (positive(store.skipPixels) + positive(width)) * pixel;
+	}
+
+	// Bytes behind a pointer argument, buffer_offset when the pointer is an
+	// offset into a bound pixel buffer, no_rule when there is no telling.
+	size_t dataSize(size_t function, size_t index, const int64_t* raw, const PixelState& pixels) noexcept
+	{
+		const auto count = [raw](size_t i)
+		{
+			return positive(raw[i]);
+		};
+
+		const auto unpack = [&pixels, raw](size_t width, size_t height, size_t depth, size_t format)
+		{
+			return pixels.unpackBuffer ? buffer_offset : imageSize(pixels.unpack,
+				raw[width], height ? raw[height] : 1, depth ? raw[depth] : 1, raw[format], raw[format + 1]);
+		};
+
+		const auto compressed = [&pixels, raw](size_t size)
+		{
+			return pixels.unpackBuffer ? buffer_offset : positive(raw[size]);
+		};
+
+		const auto vector4 = [raw](size_t i, int64_t value)
+		{
+			return size_t{ raw[i] == value ? 16u : 4u };
+		};
+
+		switch (function)
+		{
+		case fn_glBufferData:
+		case fn_glNamedBufferData:
+		case fn_glBufferStorage:
+		case fn_glNamedBufferStorage:
+			return index == 2 ? count(1) : no_rule;
+
+		case fn_glBufferSubData:
+		case fn_glNamedBufferSubData:
+		case fn_glGetBufferSubData:
+		case fn_glGetNamedBufferSubData:
+			return index == 3 ? count(2) : no_rule;
+
+		case fn_glClearBufferData:
+		case fn_glClearNamedBufferData:
+			return index == 4 ? pixelSize(raw[2], raw[3]) : no_rule;
+
+		case fn_glClearBufferSubData:
+		case fn_glClearNamedBufferSubData:
+			return index == 6 ? pixelSize(raw[4], raw[5]) : no_rule;
+
+		case fn_glClearTexImage:
+			return index == 4 ? pixelSize(raw[2], raw[3]) : no_rule;
+
+		case fn_glClearTexSubImage:
+			return index == 10 ? pixelSize(raw[8], raw[9]) : no_rule;
+
+		case fn_glTexImage1D:
+			return index == 7 ? unpack(3, 0, 0, 5) : no_rule;
+
+		case fn_glTexImage2D:
+			return index == 8 ? unpack(3, 4, 0, 6) : no_rule;
+
+		case fn_glTexImage3D:
+			return index == 9 ? unpack(3, 4, 5, 7) : no_rule;
+
+		case fn_glTexSubImage1D:
+		case fn_glTextureSubImage1D:
+			return index == 6 ? unpack(3, 0, 0, 4) : no_rule;
+
+		case fn_glTexSubImage2D:
+		case fn_glTextureSubImage2D:
+			return index == 8 ? unpack(4, 5, 0, 6) : no_rule;
+
+		case fn_glTexSubImage3D:
+		case fn_glTextureSubImage3D:
+			return index == 10 ? unpack(5, 6, 7, 8) : no_rule;
+
+		case fn_glCompressedTexImage1D:
+			return index == 6 ? compressed(5) : no_rule;
+
+		case fn_glCompressedTexImage2D:
+			return index == 7 ? compressed(6) : no_rule;
+
+		case fn_glCompressedTexImage3D:
+			return index == 8 ? compressed(7) : no_rule;
+
+		case fn_glCompressedTexSubImage1D:
+		case fn_glCompressedTextureSubImage1D:
+			return index == 6 ? compressed(5) : no_rule;
+
+		case fn_glCompressedTexSubImage2D:
+		case fn_glCompressedTextureSubImage2D:
+			return index == 8 ? compressed(7) : no_rule;
+
+		case fn_glCompressedTexSubImage3D:
+		case fn_glCompressedTextureSubImage3D:
+			return index == 10 ? compressed(9) : no_rule;
+
+		case fn_glReadPixels:
+			if (index != 6)
+				return no_rule;
+			return pixels.packBuffer ? buffer_offset : imageSize(pixels.pack, raw[2], raw[3], 1, raw[4], raw[5]);
+
+		case fn_glTexParameterfv:
+		case fn_glTexParameteriv:
+		case fn_glTexParameterIiv:
+		case fn_glTexParameterIuiv:
+		case fn_glTextureParameterfv:
+		case fn_glTextureParameteriv:
+		case fn_glTextureParameterIiv:
+		case fn_glTextureParameterIuiv:
+		case fn_glSamplerParameterfv:
+		case fn_glSamplerParameteriv:
+		case fn_glSamplerParameterIiv:
+		case fn_glSamplerParameterIuiv:
+			if (index != 2)
+				return no_rule;
+			return raw[1] == GL_TEXTURE_BORDER_COLOR || raw[1] == GL_TEXTURE_SWIZZLE_RGBA ? 16 : 4;
+
+		case fn_glClearBufferfv:
+		case fn_glClearBufferiv:
+		case fn_glClearBufferuiv:
+			return index == 2 ? vector4(0, GL_COLOR) : no_rule;
+
+		case fn_glClearNamedFramebufferfv:
+		case fn_glClearNamedFramebufferiv:
+		case fn_glClearNamedFramebufferuiv:
+			return index == 3 ? vector4(1, GL_COLOR) : no_rule;
+
+		case fn_glDrawBuffers:
+			return index == 1 ? count(0) * 4 : no_rule;
+
+		case fn_glNamedFramebufferDrawBuffers:
+		case fn_glInvalidateFramebuffer:
+		case fn_glInvalidateNamedFramebufferData:
+		case fn_glInvalidateSubFramebuffer:
+		case fn_glInvalidateNamedFramebufferSubData:
+			return index == 2 ? count(1) * 4 : no_rule;
+
+		case fn_glViewportArrayv:
+		case fn_glScissorArrayv:
+			return index == 2 ? count(1) * 16 : no_rule;
+
+		case fn_glViewportIndexedfv:
+		case fn_glScissorIndexedv:
+			return index == 1 ? 16 : no_rule;
+
+		case fn_glBindBuffersRange:
+			return index == 4 || index == 5 ? count(2) * 8 : no_rule;
+
+		case fn_glBindVertexBuffers:
+			return index == 3 ? count(1) * 8 : index == 4 ? count(1) * 4 : no_rule;
+
+		case fn_glVertexArrayVertexBuffers:
+			return index == 4 ? count(2) * 8 : index == 5 ? count(2) * 4 : no_rule;
+
+		case fn_glMultiDrawArrays:
+			return index == 1 || index == 2 ? count(3) * 4 : no_rule;
+
+		case fn_glMultiDrawElements:
+			return index == 1 ? count(4) * 4 : index == 3 ? count(4) * sizeof(void*) : no_rule;
+
+		case fn_glMultiDrawElementsBaseVertex:
+			return index == 1 || index == 5 ? count(4) * 4 : index == 3 ? count(4) * sizeof(void*) : no_rule;
+
+		case fn_glShaderSource:
+			return index == 3 ? count(1) * 4 : no_rule;
+
+		case fn_glGetActiveUniformsiv:
+		case fn_glUniformSubroutinesuiv:
+			return index == 2 ? count(1) * 4 : no_rule;
+		}
+
+		const auto& arguments = argumentTable()[function];
+		if (arguments.vector == static_cast<int8_t>(index))
+			return (arguments.vectorCount < 0 ? 1 : count(arguments.vectorCount)) * arguments.vectorBytes;
+
+		return no_rule;
+	}
+
+	Argument pointerKind(size_t function, size_t index, bool constant)
+	{
+		const auto name = function_names[function];
+		const auto& arguments = argumentTable()[function];
+		const int64_t raw[max_arguments + 1]{};
+		const auto sized = dataSize(function, index, raw, PixelState{}) != no_rule;
+
+		if (arguments.names[index].count >= 0)
+		{
+			if (constant)
+				return Argument::names;
+
+			return startsWith(name, "glGen") || startsWith(name, "glCreate") ? Argument::generated : Argument::unsupported;
+		}
+
+		if (!constant)
+		{
+			if (!startsWith(name, "glGet") && !startsWith(name, "glRead") && !startsWith(name, "glAre"))
+				return Argument::unsupported;
+
+			// image reads have no size to go by
+			if (!sized && arguments.bufferSize < 0 && strstr(name, "Image"))
+				return Argument::unsupported;
+
+			return Argument::output;
+		}
+
+		if (sized)
+			return Argument::data;
+
+		if (startsWith(name, "glDraw") || startsWith(name, "glMultiDraw") || (startsWith(name, "glVertexAttrib") && strstr(name, "Pointer")))
+			return Argument::offset;
+
+		return Argument::unsupported;
+	}
+
+	template <typename T>
+	Argument argumentKind(size_t function, size_t index)
+	{
+		if constexpr (is_same_v<T, GLsync>)
+			return Argument::sync;
+		else if constexpr (is_arithmetic_v<T>)
+			return argumentTable()[function].names[index].kind == ObjectKind::none ? Argument::value : Argument::name;
+		else if constexpr (is_same_v<T, const GLchar*>)
+			return Argument::string;
+		else if constexpr (is_same_v<T, const GLchar* const*>)
+			return Argument::strings;
+		else if constexpr (is_pointer_v<T> && !is_function_v<remove_pointer_t<T>>)
+			return pointerKind(function, index, is_const_v<remove_pointer_t<T>>);
+		else
+			return Argument::unsupported;
+	}
+
+	template <size_t Id, typename Fn>
+	struct Describe;
+
+	template <size_t Id, typename R, typename... Args>
+	struct Describe<Id, R (APIENTRY*)(Args...)> {
+		static_assert(sizeof...(Args) <= max_arguments, "GlCapture takes up to max_arguments arguments");
+
+		static Signature signature()
+		{
+			Signature signature;
+			signature.arity = sizeof...(Args);
+
+			[[maybe_unused]] size_t index = 0;
+			((signature.arguments[index] = argumentKind<Args>(Id, index), ++index), ...);
+
+			signature.supported = none_of(signature.arguments.begin(), signature.arguments.begin() + signature.arity, [](Argument argument)
+			{
+				return argument == Argument::unsupported;
+			});
+
+			if constexpr (is_same_v<R, GLsync>)
+				signature.result = Result::sync;
+			else if (Id == fn_glCreateShader || Id == fn_glCreateProgram || Id == fn_glCreateShaderProgramv)
+				signature.result = Result::name;
+			else if (Id == fn_glMapBuffer || Id == fn_glMapBufferRange || Id == fn_glMapNamedBuffer || Id == fn_glMapNamedBufferRange)
+				signature.result = Result::mapping;
+
+			return signature;
+		}
+	};
+
+	const array<Signature, function_count>& signatureTable()
+	{
+		static const auto table = []
+		{
+			array<Signature, function_count> table{};
+#define GL_TRACE_FUNCTION(name) table[fn_##name] = Describe<fn_##name, decltype(name)>::signature();
+#include "gl_trace_functions.inl"
+#undef GL_TRACE_FUNCTION
+			return table;
+		}();
+
+		return table;
+	}
+
+	bool isTargetMapping(size_t function) noexcept
+	{
+		return function == fn_glMapBuffer || function == fn_glMapBufferRange
+			|| function == fn_glUnmapBuffer || function == fn_glFlushMappedBufferRange;
+	}
+
+	// Mapped ranges are kept by buffer name, or by target for the non DSA
+	// entry points.
+	uint64_t mappingKey(size_t function, const int64_t* raw) noexcept
+	{
+		return static_cast<uint32_t>(raw[0]) | (isTargetMapping(function) ? uint64_t{ 1 } << 32 : 0);
+	}
+
+	class Writer {
+	public:
+		void byte(uint8_t value)
+		{
+			mBytes.push_back(value);
+		}
+
+		void varint(uint64_t value)
+		{
+			while (value >= 0x80)
+			{
+				mBytes.push_back(static_cast<uint8_t>(value | 0x80));
+				value >>= 7;
+			}
+			mBytes.push_back(static_cast<uint8_t>(value));
+		}
+
+		void zigzag(int64_t value)
+		{
+			varint((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+		}
+
+		void raw(const void* data, size_t size)
+		{
+			const auto bytes = static_cast<const unsigned char*>(data);
+			mBytes.insert(mBytes.end(), bytes, bytes + size);
+		}
+
+		vector<unsigned char>& bytes() noexcept
+		{
+			return mBytes;
+		}
+
+	private:
+		vector<unsigned char> mBytes;
+	};
+
+	class Reader {
+	public:
+		void reset(const unsigned char* data, size_t size) noexcept
+		{
+			mData = data;
+			mSize = size;
+			mPosition = 0;
+		}
+
+		bool done() const noexcept
+		{
+			return mPosition == mSize;
+		}
+
+		uint8_t byte()
+		{
+			return *take(1);
+		}
+
+		uint64_t varint()
+		{
+			uint64_t value = 0;
+			for (unsigned shift = 0; shift < 64; shift += 7)
+			{
+				const auto next = byte();
+				value |= static_cast<uint64_t>(next & 0x7f) << shift;
+				if (!(next & 0x80))
+					return value;
+			}
+			throw runtime_error{ "The GL capture is damaged" };
+		}
+
+		int64_t zigzag()
+		{
+			const auto value = varint();
+			return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+		}
+
+		const unsigned char* take(size_t size)
+		{
+			if (size > mSize - mPosition)
+				throw runtime_error{ "The GL capture is truncated" };
+
+			const auto data = mData + mPosition;
+			mPosition += size;
+			return data;
+		}
+
+	private:
+		const unsigned char* mData = nullptr;
+		size_t mSize = 0;
+		size_t mPosition = 0;
+	};
+
+	struct Capture {
+		bool active = false;
+		string path;
+		ofstream file;
+		Writer out;
+		const Signature* signatures = nullptr;
+		const FunctionArguments* arguments = nullptr;
+		PixelState pixels;
+		unordered_map<uint64_t, Mapping> mappings;
+		array<bool, function_count> defined{};
+		array<uint64_t, function_count> skipped{};
+		uint64_t frames = 0;
+		uint64_t calls = 0;
+		uint64_t written = 0;
+	};
+
+	Capture g_capture;
+
+	void flush()
+	{
+		auto& bytes = g_capture.out.bytes();
+		g_capture.file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<streamsize>(bytes.size()));
+		g_capture.written += bytes.size();
+		bytes.clear();
+	}
+
+	void beginCall(size_t function)
+	{
+		auto& out = g_capture.out;
+
+		if (!g_capture.defined[function])
+		{
+			const auto name = function_names[function];
+			const auto length = strlen(name);
+
+			out.byte(record_function);
+			out.varint(function);
+			out.varint(length);
+			out.raw(name, length);
+			g_capture.defined[function] = true;
+		}
+
+		out.byte(record_call);
+		out.varint(function);
+	}
+
+	void encodePointer(size_t function, size_t index, const void* pointer, const int64_t* raw)
+	{
+		auto& out = g_capture.out;
+		const auto kind = g_capture.signatures[function].arguments[index];
+
+		if (!pointer)
+		{
+			out.varint(tag_null);
+			return;
+		}
+
+		switch (kind)
+		{
+		case Argument::string:
+		{
+			const auto length = strlen(static_cast<const char*>(pointer)) + 1;
+			out.varint(tag_data + length);
+			out.raw(pointer, length);
+			break;
+		}
+
+		case Argument::strings:
+		{
+			const auto strings = static_cast<const GLchar* const*>(pointer);
+			const auto lengths = function == fn_glShaderSource ? reinterpret_cast<const GLint*>(raw[index + 1]) : nullptr;
+			const auto count = positive(raw[index - 1]);
+
+			out.varint(tag_data + count);
+			for (size_t i = 0; i < count; ++i)
+			{
+				const auto length = lengths && lengths[i] >= 0 ? static_cast<size_t>(lengths[i]) : strlen(strings[i]);
+				out.varint(length + 1);
+				out.raw(strings[i], length);
+				out.byte(0);
+			}
+			break;
+		}
+
+		case Argument::names:
+		case Argument::generated:
+		{
+			const auto count = positive(raw[g_capture.arguments[function].names[index].count]);
+			out.varint(tag_data + count);
+
+			// generated names are written once GL has made them
+			if (kind == Argument::names)
+			{
+				const auto names = static_cast<const GLuint*>(pointer);
+				for (size_t i = 0; i < count; ++i)
+					out.varint(names[i]);
+			}
+			break;
+		}
+
+		case Argument::offset:
+			out.varint(tag_offset);
+			out.varint(reinterpret_cast<uintptr_t>(pointer));
+			break;
+
+		case Argument::data:
+		case Argument::output:
+		{
+			auto size = dataSize(function, index, raw, g_capture.pixels);
+			if (size == buffer_offset)
+			{
+				out.varint(tag_offset);
+				out.varint(reinterpret_cast<uintptr_t>(pointer));
+				break;
+			}
+
+			if (kind == Argument::data)
+			{
+				out.varint(tag_data + size);
+				out.raw(pointer, size);
+				break;
+			}
+
+			// the replay only needs room for what GL writes
+			if (size == no_rule)
+			{
+				const auto bufferSize = g_capture.arguments[function].bufferSize;
+				size = bufferSize < 0 ? default_output_size : max(default_output_size, positive(raw[bufferSize]) * 8);
+			}
+			out.varint(tag_data + size);
+			break;
+		}
+
+		default:
+			break;
+		}
+	}
+
+	template <typename T>
+	void encode(size_t function, size_t index, T value, const int64_t* raw)
+	{
+		auto& out = g_capture.out;
+
+		if constexpr (is_same_v<T, GLsync>)
+			out.varint(reinterpret_cast<uintptr_t>(value));
+		else if constexpr (is_floating_point_v<T>)
+			out.raw(&value, sizeof(value));
+		else if constexpr (is_integral_v<T> && is_signed_v<T>)
+			out.zigzag(value);
+		else if constexpr (is_integral_v<T>)
+			out.varint(value);
+		else if constexpr (is_pointer_v<T> && !is_function_v<remove_pointer_t<T>>)
+			encodePointer(function, index, value, raw);
+	}
+
+	// Writes what a mapped range holds before it is flushed or unmapped.
+	void beforeCall(size_t function, const int64_t* raw)
+	{
+		if (function != fn_glUnmapBuffer && function != fn_glUnmapNamedBuffer
+			&& function != fn_glFlushMappedBufferRange && function != fn_glFlushMappedNamedBufferRange)
+			return;
+
+		auto& out = g_capture.out;
+
+		const auto mapping = g_capture.mappings.find(mappingKey(function, raw));
+		if (mapping == g_capture.mappings.end() || !mapping->second.write || !mapping->second.data)
+		{
+			out.varint(tag_null);
+			return;
+		}
+
+		size_t offset = 0;
+		auto length = mapping->second.length;
+		if (function == fn_glFlushMappedBufferRange || function == fn_glFlushMappedNamedBufferRange)
+		{
+			offset = min(positive(raw[1]), length);
+			length = min(positive(raw[2]), length - offset);
+		}
+
+		out.varint(tag_data + length);
+		out.raw(mapping->second.data + offset, length);
+	}
+
+	void afterCall(size_t function, const int64_t* raw, int64_t result);
+
+	// Writes through a coherent persistent mapping, or a persistent one the
+	// caller never flushes, reach GL without any call to record them.
+	void rejectUnseenWrites(int64_t access)
+	{
+		if ((access & GL_MAP_PERSISTENT_BIT) && (access & GL_MAP_WRITE_BIT)
+			&& ((access & GL_MAP_COHERENT_BIT) || !(access & GL_MAP_FLUSH_EXPLICIT_BIT)))
+			throw runtime_error{ "GlCapture cannot record writes through a persistent mapping without GL_MAP_FLUSH_EXPLICIT_BIT" };
+	}
+
+	template <size_t Id, typename Fn>
+	struct Hook;
+
+	template <size_t Id, typename R, typename... Args>
+	struct Hook<Id, R (APIENTRY*)(Args...)> {
+		static inline R (APIENTRY* original)(Args...) = nullptr;
+
+		static R APIENTRY call(Args... args)
+		{
+			if (!g_capture.active)
+				return original(args...);
+
+			if (!g_capture.signatures[Id].supported)
+			{
+				++g_capture.skipped[Id];
+				return original(args...);
+			}
+
+			const int64_t raw[] = { toRaw(args)..., 0 };
+			if constexpr (Id == fn_glMapBufferRange || Id == fn_glMapNamedBufferRange)
+				rejectUnseenWrites(raw[3]);
+
+			beginCall(Id);
+
+			[[maybe_unused]] size_t index = 0;
+			(encode(Id, index++, args, raw), ...);
+			beforeCall(Id, raw);
+
+			if constexpr (is_void_v<R>)
+			{
+				original(args...);
+				afterCall(Id, raw, 0);
+			}
+			else
+			{
+				const auto result = original(args...);
+				afterCall(Id, raw, toRaw(result));
+				return result;
+			}
+		}
+	};
+
+	size_t mappedLength(size_t function, const int64_t* raw)
+	{
+		GLint64 length = 0;
+
+		if (function == fn_glMapBuffer)
+		{
+			if (const auto get = Hook<fn_glGetBufferParameteri64v, decltype(glGetBufferParameteri64v)>::original)
+				get(static_cast<GLenum>(raw[0]), GL_BUFFER_MAP_LENGTH, &length);
+		}
+		else if (function == fn_glMapNamedBuffer)
+		{
+			if (const auto get = Hook<fn_glGetNamedBufferParameteri64v, decltype(glGetNamedBufferParameteri64v)>::original)
+				get(static_cast<GLuint>(raw[0]), GL_BUFFER_MAP_LENGTH, &length);
+		}
+		else
+		{
+			length = raw[2];
+		}
+
+		return positive(length);
+	}
+
+	void storePixels(int64_t name, int64_t value) noexcept
+	{
+		auto& pixels = g_capture.pixels;
+
+		switch (name)
+		{
+		case GL_UNPACK_ALIGNMENT: pixels.unpack.alignment = value; break;
+		case GL_UNPACK_ROW_LENGTH: pixels.unpack.rowLength = value; break;
+		case GL_UNPACK_IMAGE_HEIGHT: pixels.unpack.imageHeight = value; break;
+		case GL_UNPACK_SKIP_PIXELS: pixels.unpack.skipPixels = value; break;
+		case GL_UNPACK_SKIP_ROWS: pixels.unpack.skipRows = value; break;
+		case GL_UNPACK_SKIP_IMAGES: pixels.unpack.skipImages = value; break;
+		case GL_PACK_ALIGNMENT: pixels.pack.alignment = value; break;
+		case GL_PACK_ROW_LENGTH: pixels.pack.rowLength = value; break;
+		case GL_PACK_IMAGE_HEIGHT: pixels.pack.imageHeight = value; break;
+		case GL_PACK_SKIP_PIXELS: pixels.pack.skipPixels = value; break;
+		case GL_PACK_SKIP_ROWS: pixels.pack.skipRows = value; break;
+		case GL_PACK_SKIP_IMAGES: pixels.pack.skipImages = value; break;
+		}
+	}
+
+	// Writes what GL handed back that later calls refer to, and follows the
+	// state the sizes of later calls depend on.
+	void afterCall(size_t function, const int64_t* raw, int64_t result)
+	{
+		auto& out = g_capture.out;
+		const auto& signature = g_capture.signatures[function];
+
+		for (size_t i = 0; i < signature.arity; ++i)
+		{
+			if (signature.arguments[i] != Argument::generated || !raw[i])
+				continue;
+
+			const auto names = reinterpret_cast<const GLuint*>(raw[i]);
+			const auto count = positive(raw[g_capture.arguments[function].names[i].count]);
+			for (size_t n = 0; n < count; ++n)
+				out.varint(names[n]);
+		}
+
+		switch (signature.result)
+		{
+		case Result::name:
+			out.varint(static_cast<uint32_t>(result));
+			break;
+
+		case Result::sync:
+			out.varint(static_cast<uint64_t>(result));
+			break;
+
+		case Result::mapping:
+		{
+			const auto access = function == fn_glMapBuffer || function == fn_glMapNamedBuffer ? raw[1] : raw[3];
+			const auto write = function == fn_glMapBuffer || function == fn_glMapNamedBuffer
+				? access != GL_READ_ONLY
+				: (access & GL_MAP_WRITE_BIT) != 0;
+
+			g_capture.mappings[mappingKey(function, raw)] = {
+				reinterpret_cast<unsigned char*>(result),
+				result ? mappedLength(function, raw) : 0,
+				write
+			};
+			break;
+		}
+
+		default:
+			break;
+		}
+
+		switch (function)
+		{
+		case fn_glBindBuffer:
+			if (raw[0] == GL_PIXEL_UNPACK_BUFFER)
+				g_capture.pixels.unpackBuffer = raw[1] != 0;
+			else if (raw[0] == GL_PIXEL_PACK_BUFFER)
+				g_capture.pixels.packBuffer = raw[1] != 0;
+			break;
+
+		case fn_glPixelStorei:
+		case fn_glPixelStoref:
+			storePixels(raw[0], raw[1]);
+			break;
+
+		case fn_glUnmapBuffer:
+		case fn_glUnmapNamedBuffer:
+			g_capture.mappings.erase(mappingKey(function, raw));
+			break;
+		}
+
+		++g_capture.calls;
+		if (out.bytes().size() >= flush_size)
+			flush();
+	}
+
+	void install()
+	{
+#define GL_TRACE_FUNCTION(name) \
+		if (name && name != Hook<fn_##name, decltype(name)>::call) \
+		{ \
+			Hook<fn_##name, decltype(name)>::original = name; \
+			name = Hook<fn_##name, decltype(name)>::call; \
+		}
+#include "gl_trace_functions.inl"
+#undef GL_TRACE_FUNCTION
+	}
+
+	void uninstall()
+	{
+#define GL_TRACE_FUNCTION(name) \
+		if (name == Hook<fn_##name, decltype(name)>::call) \
+			name = Hook<fn_##name, decltype(name)>::original;
+#include "gl_trace_functions.inl"
+#undef GL_TRACE_FUNCTION
+	}
+
+	void writeU32(unsigned char* out, uint32_t value) noexcept
+	{
+		for (int i = 0; i < 4; ++i)
+			out[i] = static_cast<unsigned char>(value >> (i * 8));
+	}
+
+	void writeU64(unsigned char* out, uint64_t value) noexcept
+	{
+		for (int i = 0; i < 8; ++i)
+			out[i] = static_cast<unsigned char>(value >> (i * 8));
+	}
+
+	uint32_t readU32(const unsigned char* in) noexcept
+	{
+		uint32_t value = 0;
+		for (int i = 0; i < 4; ++i)
+			value |= static_cast<uint32_t>(in[i]) << (i * 8);
+		return value;
+	}
+
+	uint64_t readU64(const unsigned char* in) noexcept
+	{
+		uint64_t value = 0;
+		for (int i = 0; i < 8; ++i)
+			value |= static_cast<uint64_t>(in[i]) << (i * 8);
+		return value;
+	}
+}
+
+struct GlReplayState {
+	Reader in;
+	const Signature* signatures = nullptr;
+	const FunctionArguments* arguments = nullptr;
+	GLuint defaultFramebuffer = 0;
+
+	unordered_map<string, size_t> functionIds;
+	vector<size_t> functions;          // file id to Function
+
+	array<unordered_map<GLuint, GLuint>, object_kind_count> names;
+	unordered_map<uint64_t, GLsync> syncs;
+	unordered_map<uint64_t, unsigned char*> mappings;
+
+	array<int64_t, max_arguments + 1> raw{};
+	array<vector<unsigned char>, max_arguments> scratch;
+	array<vector<GLuint>, max_arguments> nameScratch;
+	vector<const GLchar*> strings;
+
+	GLuint translate(ObjectKind kind, GLuint name) const
+	{
+		if (kind == ObjectKind::framebuffer && name == 0)
+			return defaultFramebuffer;
+
+		const auto& map = names[static_cast<size_t>(kind)];
+		const auto found = map.find(name);
+		return found == map.end() ? name : found->second;
+	}
+};
+
+namespace {
+
+	void* decodePointer(GlReplayState& state, size_t function, size_t index)
+	{
+		auto& in = state.in;
+		const auto kind = state.signatures[function].arguments[index];
+
+		state.raw[index] = 0;
+		if (kind == Argument::generated)
+			state.nameScratch[index].clear();
+
+		const auto tag = in.varint();
+		if (tag == tag_null)
+			return nullptr;
+
+		if (tag == tag_offset)
+			return reinterpret_cast<void*>(static_cast<uintptr_t>(in.varint()));
+
+		const auto count = tag - tag_data;
+
+		switch (kind)
+		{
+		case Argument::string:
+		case Argument::data:
+		{
+			const auto data = in.take(count);
+
+			// small arrays (uniforms, parameters) are read as their type
+			if (reinterpret_cast<uintptr_t>(data) % alignof(max_align_t) && count <= aligned_copy_size)
+			{
+				auto& scratch = state.scratch[index];
+				scratch.assign(data, data + count);
+				return scratch.data();
+			}
+
+			return const_cast<unsigned char*>(data);
+		}
+
+		case Argument::strings:
+			state.strings.clear();
+			for (size_t i = 0; i < count; ++i)
+			{
+				const auto length = in.varint();
+				state.strings.push_back(reinterpret_cast<const GLchar*>(in.take(length)));
+			}
+			return state.strings.data();
+
+		case Argument::names:
+		{
+			const auto kindOfName = state.arguments[function].names[index].kind;
+			auto& names = state.nameScratch[index];
+			names.resize(count);
+			for (auto& name : names)
+				name = state.translate(kindOfName, static_cast<GLuint>(in.varint()));
+			return names.data();
+		}
+
+		case Argument::generated:
+			state.nameScratch[index].assign(count, 0);
+			return state.nameScratch[index].data();
+
+		case Argument::output:
+		{
+			auto& scratch = state.scratch[index];
+			if (scratch.size() < count)
+				scratch.resize(count);
+			return scratch.data();
+		}
+
+		default:
+			throw runtime_error{ "The GL capture is damaged" };
+		}
+	}
+
+	template <typename T>
+	T decode(GlReplayState& state, size_t function, size_t index)
+	{
+		auto& in = state.in;
+
+		if constexpr (is_same_v<T, GLsync>)
+		{
+			const auto sync = state.syncs.find(in.varint());
+			return sync == state.syncs.end() ? nullptr : sync->second;
+		}
+		else if constexpr (is_floating_point_v<T>)
+		{
+			T value;
+			memcpy(&value, in.take(sizeof(value)), sizeof(value));
+			state.raw[index] = toRaw(value);
+			return value;
+		}
+		else if constexpr (is_integral_v<T>)
+		{
+			T value;
+			if constexpr (is_signed_v<T>)
+				value = static_cast<T>(in.zigzag());
+			else
+				value = static_cast<T>(in.varint());
+
+			state.raw[index] = static_cast<int64_t>(value);
+			if (state.signatures[function].arguments[index] == Argument::name)
+				return static_cast<T>(state.translate(state.arguments[function].names[index].kind, static_cast<GLuint>(value)));
+
+			return value;
+		}
+		else if constexpr (is_pointer_v<T> && !is_function_v<remove_pointer_t<T>>)
+		{
+			return static_cast<T>(decodePointer(state, function, index));
+		}
+		else
+		{
+			return T{};
+		}
+	}
+
+	void beforePlay(GlReplayState& state, size_t function)
+	{
+		if (function != fn_glUnmapBuffer && function != fn_glUnmapNamedBuffer
+			&& function != fn_glFlushMappedBufferRange && function != fn_glFlushMappedNamedBufferRange)
+			return;
+
+		const auto tag = state.in.varint();
+		if (tag < tag_data)
+			return;
+
+		const auto length = tag - tag_data;
+		const auto data = state.in.take(length);
+
+		const auto mapping = state.mappings.find(mappingKey(function, state.raw.data()));
+		if (mapping == state.mappings.end() || !mapping->second)
+			return;
+
+		const auto offset = function == fn_glFlushMappedBufferRange || function == fn_glFlushMappedNamedBufferRange
+			? positive(state.raw[1])
+			: 0;
+		memcpy(mapping->second + offset, data, length);
+	}
+
+	void afterPlay(GlReplayState& state, size_t function, int64_t result)
+	{
+		auto& in = state.in;
+		const auto& signature = state.signatures[function];
+
+		for (size_t i = 0; i < signature.arity; ++i)
+		{
+			if (signature.arguments[i] != Argument::generated)
+				continue;
+
+			auto& names = state.names[static_cast<size_t>(state.arguments[function].names[i].kind)];
+			for (const auto name : state.nameScratch[i])
+				names[static_cast<GLuint>(in.varint())] = name;
+		}
+
+		switch (signature.result)
+		{
+		case Result::name:
+			state.names[static_cast<size_t>(ObjectKind::program)][static_cast<GLuint>(in.varint())] = static_cast<GLuint>(result);
+			break;
+
+		case Result::sync:
+			state.syncs[in.varint()] = reinterpret_cast<GLsync>(result);
+			break;
+
+		case Result::mapping:
+			state.mappings[mappingKey(function, state.raw.data())] = reinterpret_cast<unsigned char*>(result);
+			break;
+
+		default:
+			break;
+		}
+
+		if (function == fn_glUnmapBuffer || function == fn_glUnmapNamedBuffer)
+			state.mappings.erase(mappingKey(function, state.raw.data()));
+	}
+
+	template <size_t Id, typename Fn>
+	struct Player;
+
+	template <size_t Id, typename R, typename... Args>
+	struct Player<Id, R (APIENTRY*)(Args...)> {
+		static void play(GlReplayState& state, R (APIENTRY* function)(Args...))
+		{
+			if (!function)
+				throw runtime_error{ string{ function_names[Id] } + " is missing from the replay context" };
+
+			play(state, function, index_sequence_for<Args...>{});
+		}
+
+		template <size_t... I>
+		static void play(GlReplayState& state, R (APIENTRY* function)(Args...), index_sequence<I...>)
+		{
+			// braces decode the arguments in order
+			[[maybe_unused]] tuple<Args...> args{ decode<Args>(state, Id, I)... };
+			beforePlay(state, Id);
+
+			if constexpr (is_void_v<R>)
+			{
+				function(get<I>(args)...);
+				afterPlay(state, Id, 0);
+			}
+			else
+			{
+				afterPlay(state, Id, toRaw(function(get<I>(args)...)));
+			}
+		}
+	};
+
+	using PlayFunction = void (*)(GlReplayState&);
+
+	const PlayFunction players[] = {
+#define GL_TRACE_FUNCTION(name) [](GlReplayState& state) { Player<fn_##name, decltype(name)>::play(state, name); },
+#include "gl_trace_functions.inl"
+#undef GL_TRACE_FUNCTION
+	};
+}
+
+GlCapture& GlCapture::instance()
+{
+	static GlCapture capture;
+	return capture;
+}
+
+GlCapture::~GlCapture()
+{
+	if (g_capture.active)
+	{
+		try
+		{
+			stop();
+		}
+		catch (...)
+		{
+		}
+	}
+}
+
+void GlCapture::start(const string& path, int width, int height)
+{
+	if (g_capture.active)
+		throw logic_error{ "GlCapture is already capturing" };
+
+	g_capture.file = ofstream{ path, ios::binary | ios::trunc };
+	if (!g_capture.file)
+		throw runtime_error{ "Unable to write the GL capture to " + path };
+
+	g_capture.path = path;
+	g_capture.signatures = signatureTable().data();
+	g_capture.arguments = argumentTable().data();
+	g_capture.pixels = {};
+	g_capture.mappings.clear();
+	g_capture.defined.fill(false);
+	g_capture.skipped.fill(0);
+	g_capture.frames = g_capture.calls = g_capture.written = 0;
+
+	unsigned char header[header_size] = {};
+	memcpy(header, file_magic, sizeof(file_magic));
+	writeU32(header + 8, static_cast<uint32_t>(width));
+	writeU32(header + 12, static_cast<uint32_t>(height));
+
+	auto& out = g_capture.out;
+	out.bytes().clear();
+	out.raw(header, sizeof(header));
+
+	install();
+	g_capture.active = true;
+}
+
+void GlCapture::stop()
+{
+	if (!g_capture.active)
+		return;
+
+	uninstall();
+	g_capture.active = false;
+	g_capture.mappings.clear();
+
+	auto& file = g_capture.file;
+	flush();
+
+	unsigned char counts[16];
+	writeU64(counts, g_capture.frames);
+	writeU64(counts + 8, g_capture.calls);
+	file.seekp(16);
+	file.write(reinterpret_cast<const char*>(counts), sizeof(counts));
+	file.close();
+
+	if (!file)
+		throw runtime_error{ "Unable to write the GL capture to " + g_capture.path };
+}
+
+bool GlCapture::capturing() const noexcept
+{
+	return g_capture.active;
+}
+
+void GlCapture::frameEnd()
+{
+	if (!g_capture.active)
+		return;
+
+	g_capture.out.byte(record_frame);
+	++g_capture.frames;
+}
+
+uint64_t GlCapture::frames() const noexcept
+{
+	return g_capture.frames;
+}
+
+uint64_t GlCapture::calls() const noexcept
+{
+	return g_capture.calls;
+}
+
+uint64_t GlCapture::bytes() const noexcept
+{
+	return g_capture.written + g_capture.out.bytes().size();
+}
+
+uint64_t GlCapture::skipped() const noexcept
+{
+	uint64_t skipped = 0;
+	for (const auto calls : g_capture.skipped)
+		skipped += calls;
+	return skipped;
+}
+
+void GlCapture::writeReport(ostream& out) const
+{
+	char text[160];
+
+	snprintf(text, sizeof(text), "GL capture %s: %llu frames, %llu calls, %.2f MiB\n", g_capture.path.c_str(),
+		static_cast<unsigned long long>(frames()), static_cast<unsigned long long>(calls()),
+		static_cast<double>(bytes()) / (1024.0 * 1024.0));
+	out << text;
+
+	for (size_t i = 0; i < function_count; ++i)
+	{
+		if (!g_capture.skipped[i])
+			continue;
+
+		snprintf(text, sizeof(text), "  not captured: %-36s %12llu calls\n", function_names[i],
+			static_cast<unsigned long long>(g_capture.skipped[i]));
+		out << text;
+	}
+}
+
+GlReplay::GlReplay(const string& path)
+	: mState{ make_unique<GlReplayState>() }
+{
+	ifstream file{ path, ios::binary };
+	if (!file)
+		throw runtime_error{ "Unable to open the GL capture " + path };
+
+	mFile.assign(istreambuf_iterator<char>{ file }, istreambuf_iterator<char>{});
+
+	if (mFile.size() < header_size || memcmp(mFile.data(), file_magic, sizeof(file_magic)))
+		throw runtime_error{ path + " is not a GL capture" };
+
+	const auto header = mFile.data();
+	mWidth = static_cast<int>(readU32(header + 8));
+	mHeight = static_cast<int>(readU32(header + 12));
+	mFrames = readU64(header + 16);
+	mCalls = readU64(header + 24);
+
+	auto& state = *mState;
+	state.signatures = signatureTable().data();
+	state.arguments = argumentTable().data();
+	state.in.reset(mFile.data() + header_size, mFile.size() - header_size);
+	for (size_t i = 0; i < function_count; ++i)
+		state.functionIds.emplace(function_names[i], i);
+}
+
+GlReplay::~GlReplay() = default;
+
+bool GlReplay::playFrame()
+{
+	auto& state = *mState;
+	auto& in = state.in;
+
+	state.defaultFramebuffer = mDefaultFramebuffer;
+	if (in.done())
+		return false;
+
+	while (!in.done())
+	{
+		const auto record = in.byte();
+
+		if (record == record_frame)
+			break;
+
+		if (record == record_function)
+		{
+			const auto id = in.varint();
+			const auto length = in.varint();
+			const string name{ reinterpret_cast<const char*>(in.take(length)), length };
+
+			const auto function = state.functionIds.find(name);
+			if (function == state.functionIds.end())
+				throw runtime_error{ "The GL capture calls " + name + ", which this build does not know" };
+
+			if (id >= function_count * 4)
+				throw runtime_error{ "The GL capture is damaged" };
+
+			if (state.functions.size() <= id)
+				state.functions.resize(id + 1, function_count);
+			state.functions[id] = function->second;
+			continue;
+		}
+
+		if (record != record_call)
+			throw runtime_error{ "The GL capture is damaged" };
+
+		const auto id = in.varint();
+		if (id >= state.functions.size() || state.functions[id] == function_count)
+			throw runtime_error{ "The GL capture is damaged" };
+
+		players[state.functions[id]](state);
+		++mPlayed;
+	}
+
+	return true;
+}
+
+} // glsl
\ No newline at end of file
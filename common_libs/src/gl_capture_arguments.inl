@@ -0,0 +1,369 @@
+// Arguments of the entry points in gl_trace_functions.inl that GlCapture
+// cannot tell from their type, taken from the parameter names in glad.h:
+//   GL_CAPTURE_NAME(function, index, kind)          an object name
+//   GL_CAPTURE_NAMES(function, index, kind, count)  an array of them, count
+//                                                   names it in argument count
+//   GL_CAPTURE_BUFFER_SIZE(function, index)         the size of an output buffer
+GL_CAPTURE_NAME(glBindTexture, 1, texture)
+GL_CAPTURE_NAMES(glDeleteTextures, 1, texture, 0)
+GL_CAPTURE_NAMES(glGenTextures, 1, texture, 0)
+GL_CAPTURE_NAME(glIsTexture, 0, texture)
+GL_CAPTURE_NAMES(glAreTexturesResident, 1, texture, 0)
+GL_CAPTURE_NAMES(glPrioritizeTextures, 1, texture, 0)
+GL_CAPTURE_NAMES(glGenQueries, 1, query, 0)
+GL_CAPTURE_NAMES(glDeleteQueries, 1, query, 0)
+GL_CAPTURE_NAME(glIsQuery, 0, query)
+GL_CAPTURE_NAME(glBeginQuery, 1, query)
+GL_CAPTURE_NAME(glGetQueryObjectiv, 0, query)
+GL_CAPTURE_NAME(glGetQueryObjectuiv, 0, query)
+GL_CAPTURE_NAME(glBindBuffer, 1, buffer)
+GL_CAPTURE_NAMES(glDeleteBuffers, 1, buffer, 0)
+GL_CAPTURE_NAMES(glGenBuffers, 1, buffer, 0)
+GL_CAPTURE_NAME(glIsBuffer, 0, buffer)
+GL_CAPTURE_NAME(glAttachShader, 0, program)
+GL_CAPTURE_NAME(glAttachShader, 1, program)
+GL_CAPTURE_NAME(glBindAttribLocation, 0, program)
+GL_CAPTURE_NAME(glCompileShader, 0, program)
+GL_CAPTURE_NAME(glDeleteProgram, 0, program)
+GL_CAPTURE_NAME(glDeleteShader, 0, program)
+GL_CAPTURE_NAME(glDetachShader, 0, program)
+GL_CAPTURE_NAME(glDetachShader, 1, program)
+GL_CAPTURE_NAME(glGetActiveAttrib, 0, program)
+GL_CAPTURE_BUFFER_SIZE(glGetActiveAttrib, 2)
+GL_CAPTURE_NAME(glGetActiveUniform, 0, program)
+GL_CAPTURE_BUFFER_SIZE(glGetActiveUniform, 2)
+GL_CAPTURE_NAME(glGetAttachedShaders, 0, program)
+GL_CAPTURE_BUFFER_SIZE(glGetAttachedShaders, 1)
+GL_CAPTURE_NAME(glGetAttribLocation, 0, program)
+GL_CAPTURE_NAME(glGetProgramiv, 0, program)
+GL_CAPTURE_NAME(glGetProgramInfoLog, 0, program)
+GL_CAPTURE_BUFFER_SIZE(glGetProgramInfoLog, 1)
+GL_CAPTURE_NAME(glGetShaderiv, 0, program)
+GL_CAPTURE_NAME(glGetShaderInfoLog, 0, program)
+GL_CAPTURE_BUFFER_SIZE(glGetShaderInfoLog, 1)
+GL_CAPTURE_NAME(glGetShaderSource, 0, program)
+GL_CAPTURE_BUFFER_SIZE(glGetShaderSource, 1)
+GL_CAPTURE_NAME(glGetUniformLocation, 0, program)
+GL_CAPTURE_NAME(glGetUniformfv, 0, program)
+GL_CAPTURE_NAME(glGetUniformiv, 0, program)
+GL_CAPTURE_NAME(glIsProgram, 0, program)
+GL_CAPTURE_NAME(glIsShader, 0, program)
+GL_CAPTURE_NAME(glLinkProgram, 0, program)
+GL_CAPTURE_NAME(glShaderSource, 0, program)
+GL_CAPTURE_NAME(glUseProgram, 0, program)
+GL_CAPTURE_NAME(glValidateProgram, 0, program)
+GL_CAPTURE_NAME(glBindBufferRange, 2, buffer)
+GL_CAPTURE_NAME(glBindBufferBase, 2, buffer)
+GL_CAPTURE_NAME(glTransformFeedbackVaryings, 0, program)
+GL_CAPTURE_NAME(glGetTransformFeedbackVarying, 0, program)
+GL_CAPTURE_BUFFER_SIZE(glGetTransformFeedbackVarying, 2)
+GL_CAPTURE_NAME(glGetUniformuiv, 0, program)
+GL_CAPTURE_NAME(glBindFragDataLocation, 0, program)
+GL_CAPTURE_NAME(glGetFragDataLocation, 0, program)
+GL_CAPTURE_NAME(glIsRenderbuffer, 0, renderbuffer)
+GL_CAPTURE_NAME(glBindRenderbuffer, 1, renderbuffer)
+GL_CAPTURE_NAMES(glDeleteRenderbuffers, 1, renderbuffer, 0)
+GL_CAPTURE_NAMES(glGenRenderbuffers, 1, renderbuffer, 0)
+GL_CAPTURE_NAME(glIsFramebuffer, 0, framebuffer)
+GL_CAPTURE_NAME(glBindFramebuffer, 1, framebuffer)
+GL_CAPTURE_NAMES(glDeleteFramebuffers, 1, framebuffer, 0)
+GL_CAPTURE_NAMES(glGenFramebuffers, 1, framebuffer, 0)
+GL_CAPTURE_NAME(glFramebufferTexture1D, 3, texture)
+GL_CAPTURE_NAME(glFramebufferTexture2D, 3, texture)
+GL_CAPTURE_NAME(glFramebufferTexture3D, 3, texture)
+GL_CAPTURE_NAME(glFramebufferRenderbuffer, 3, renderbuffer)
+GL_CAPTURE_NAME(glFramebufferTextureLayer, 2, texture)
+GL_CAPTURE_NAME(glBindVertexArray, 0, vertex_array)
+GL_CAPTURE_NAMES(glDeleteVertexArrays, 1, vertex_array, 0)
+GL_CAPTURE_NAMES(glGenVertexArrays, 1, vertex_array, 0)
+GL_CAPTURE_NAME(glIsVertexArray, 0, vertex_array)
+GL_CAPTURE_NAME(glTexBuffer, 2, buffer)
+GL_CAPTURE_NAME(glGetUniformIndices, 0, program)
+GL_CAPTURE_NAME(glGetActiveUniformsiv, 0, program)
+GL_CAPTURE_NAME(glGetActiveUniformName, 0, program)
+GL_CAPTURE_BUFFER_SIZE(glGetActiveUniformName, 2)
+GL_CAPTURE_NAME(glGetUniformBlockIndex, 0, program)
+GL_CAPTURE_NAME(glGetActiveUniformBlockiv, 0, program)
+GL_CAPTURE_NAME(glGetActiveUniformBlockName, 0, program)
+GL_CAPTURE_BUFFER_SIZE(glGetActiveUniformBlockName, 2)
+GL_CAPTURE_NAME(glUniformBlockBinding, 0, program)
+GL_CAPTURE_BUFFER_SIZE(glGetSynciv, 2)
+GL_CAPTURE_NAME(glFramebufferTexture, 2, texture)
+GL_CAPTURE_NAME(glBindFragDataLocationIndexed, 0, program)
+GL_CAPTURE_NAME(glGetFragDataIndex, 0, program)
+GL_CAPTURE_NAMES(glGenSamplers, 1, sampler, 0)
+GL_CAPTURE_NAMES(glDeleteSamplers, 1, sampler, 0)
+GL_CAPTURE_NAME(glIsSampler, 0, sampler)
+GL_CAPTURE_NAME(glBindSampler, 1, sampler)
+GL_CAPTURE_NAME(glSamplerParameteri, 0, sampler)
+GL_CAPTURE_NAME(glSamplerParameteriv, 0, sampler)
+GL_CAPTURE_NAME(glSamplerParameterf, 0, sampler)
+GL_CAPTURE_NAME(glSamplerParameterfv, 0, sampler)
+GL_CAPTURE_NAME(glSamplerParameterIiv, 0, sampler)
+GL_CAPTURE_NAME(glSamplerParameterIuiv, 0, sampler)
+GL_CAPTURE_NAME(glGetSamplerParameteriv, 0, sampler)
+GL_CAPTURE_NAME(glGetSamplerParameterIiv, 0, sampler)
+GL_CAPTURE_NAME(glGetSamplerParameterfv, 0, sampler)
+GL_CAPTURE_NAME(glGetSamplerParameterIuiv, 0, sampler)
+GL_CAPTURE_NAME(glQueryCounter, 0, query)
+GL_CAPTURE_NAME(glGetQueryObjecti64v, 0, query)
+GL_CAPTURE_NAME(glGetQueryObjectui64v, 0, query)
+GL_CAPTURE_NAME(glGetUniformdv, 0, program)
+GL_CAPTURE_NAME(glGetSubroutineUniformLocation, 0, program)
+GL_CAPTURE_NAME(glGetSubroutineIndex, 0, program)
+GL_CAPTURE_NAME(glGetActiveSubroutineUniformiv, 0, program)
+GL_CAPTURE_NAME(glGetActiveSubroutineUniformName, 0, program)
+GL_CAPTURE_BUFFER_SIZE(glGetActiveSubroutineUniformName, 3)
+GL_CAPTURE_NAME(glGetActiveSubroutineName, 0, program)
+GL_CAPTURE_BUFFER_SIZE(glGetActiveSubroutineName, 3)
+GL_CAPTURE_NAME(glGetProgramStageiv, 0, program)
+GL_CAPTURE_NAME(glBindTransformFeedback, 1, transform_feedback)
+GL_CAPTURE_NAMES(glDeleteTransformFeedbacks, 1, transform_feedback, 0)
+GL_CAPTURE_NAMES(glGenTransformFeedbacks, 1, transform_feedback, 0)
+GL_CAPTURE_NAME(glIsTransformFeedback, 0, transform_feedback)
+GL_CAPTURE_NAME(glDrawTransformFeedback, 1, transform_feedback)
+GL_CAPTURE_NAME(glDrawTransformFeedbackStream, 1, transform_feedback)
+GL_CAPTURE_NAME(glBeginQueryIndexed, 2, query)
+GL_CAPTURE_NAMES(glShaderBinary, 1, program, 0)
+GL_CAPTURE_NAME(glGetProgramBinary, 0, program)
+GL_CAPTURE_BUFFER_SIZE(glGetProgramBinary, 1)
+GL_CAPTURE_NAME(glProgramBinary, 0, program)
+GL_CAPTURE_NAME(glProgramParameteri, 0, program)
+GL_CAPTURE_NAME(glUseProgramStages, 0, pipeline)
+GL_CAPTURE_NAME(glUseProgramStages, 2, program)
+GL_CAPTURE_NAME(glActiveShaderProgram, 0, pipeline)
+GL_CAPTURE_NAME(glActiveShaderProgram, 1, program)
+GL_CAPTURE_NAME(glBindProgramPipeline, 0, pipeline)
+GL_CAPTURE_NAMES(glDeleteProgramPipelines, 1, pipeline, 0)
+GL_CAPTURE_NAMES(glGenProgramPipelines, 1, pipeline, 0)
+GL_CAPTURE_NAME(glIsProgramPipeline, 0, pipeline)
+GL_CAPTURE_NAME(glGetProgramPipelineiv, 0, pipeline)
+GL_CAPTURE_NAME(glProgramUniform1i, 0, program)
+GL_CAPTURE_NAME(glProgramUniform1iv, 0, program)
+GL_CAPTURE_NAME(glProgramUniform1f, 0, program)
+GL_CAPTURE_NAME(glProgramUniform1fv, 0, program)
+GL_CAPTURE_NAME(glProgramUniform1d, 0, program)
+GL_CAPTURE_NAME(glProgramUniform1dv, 0, program)
+GL_CAPTURE_NAME(glProgramUniform1ui, 0, program)
+GL_CAPTURE_NAME(glProgramUniform1uiv, 0, program)
+GL_CAPTURE_NAME(glProgramUniform2i, 0, program)
+GL_CAPTURE_NAME(glProgramUniform2iv, 0, program)
+GL_CAPTURE_NAME(glProgramUniform2f, 0, program)
+GL_CAPTURE_NAME(glProgramUniform2fv, 0, program)
+GL_CAPTURE_NAME(glProgramUniform2d, 0, program)
+GL_CAPTURE_NAME(glProgramUniform2dv, 0, program)
+GL_CAPTURE_NAME(glProgramUniform2ui, 0, program)
+GL_CAPTURE_NAME(glProgramUniform2uiv, 0, program)
+GL_CAPTURE_NAME(glProgramUniform3i, 0, program)
+GL_CAPTURE_NAME(glProgramUniform3iv, 0, program)
+GL_CAPTURE_NAME(glProgramUniform3f, 0, program)
+GL_CAPTURE_NAME(glProgramUniform3fv, 0, program)
+GL_CAPTURE_NAME(glProgramUniform3d, 0, program)
+GL_CAPTURE_NAME(glProgramUniform3dv, 0, program)
+GL_CAPTURE_NAME(glProgramUniform3ui, 0, program)
+GL_CAPTURE_NAME(glProgramUniform3uiv, 0, program)
+GL_CAPTURE_NAME(glProgramUniform4i, 0, program)
+GL_CAPTURE_NAME(glProgramUniform4iv, 0, program)
+GL_CAPTURE_NAME(glProgramUniform4f, 0, program)
+GL_CAPTURE_NAME(glProgramUniform4fv, 0, program)
+GL_CAPTURE_NAME(glProgramUniform4d, 0, program)
+GL_CAPTURE_NAME(glProgramUniform4dv, 0, program)
+GL_CAPTURE_NAME(glProgramUniform4ui, 0, program)
+GL_CAPTURE_NAME(glProgramUniform4uiv, 0, program)
+GL_CAPTURE_NAME(glProgramUniformMatrix2fv, 0, program)
+GL_CAPTURE_NAME(glProgramUniformMatrix3fv, 0, program)
+GL_CAPTURE_NAME(glProgramUniformMatrix4fv, 0, program)
+GL_CAPTURE_NAME(glProgramUniformMatrix2dv, 0, program)
+GL_CAPTURE_NAME(glProgramUniformMatrix3dv, 0, program)
+GL_CAPTURE_NAME(glProgramUniformMatrix4dv, 0, program)
+GL_CAPTURE_NAME(glProgramUniformMatrix2x3fv, 0, program)
+GL_CAPTURE_NAME(glProgramUniformMatrix3x2fv, 0, program)
+GL_CAPTURE_NAME(glProgramUniformMatrix2x4fv, 0, program)
+GL_CAPTURE_NAME(glProgramUniformMatrix4x2fv, 0, program)
+GL_CAPTURE_NAME(glProgramUniformMatrix3x4fv, 0, program)
+GL_CAPTURE_NAME(glProgramUniformMatrix4x3fv, 0, program)
+GL_CAPTURE_NAME(glProgramUniformMatrix2x3dv, 0, program)
+GL_CAPTURE_NAME(glProgramUniformMatrix3x2dv, 0, program)
+GL_CAPTURE_NAME(glProgramUniformMatrix2x4dv, 0, program)
+GL_CAPTURE_NAME(glProgramUniformMatrix4x2dv, 0, program)
+GL_CAPTURE_NAME(glProgramUniformMatrix3x4dv, 0, program)
+GL_CAPTURE_NAME(glProgramUniformMatrix4x3dv, 0, program)
+GL_CAPTURE_NAME(glValidateProgramPipeline, 0, pipeline)
+GL_CAPTURE_NAME(glGetProgramPipelineInfoLog, 0, pipeline)
+GL_CAPTURE_BUFFER_SIZE(glGetProgramPipelineInfoLog, 1)
+GL_CAPTURE_BUFFER_SIZE(glGetInternalformativ, 3)
+GL_CAPTURE_NAME(glGetActiveAtomicCounterBufferiv, 0, program)
+GL_CAPTURE_NAME(glBindImageTexture, 1, texture)
+GL_CAPTURE_NAME(glDrawTransformFeedbackInstanced, 1, transform_feedback)
+GL_CAPTURE_NAME(glDrawTransformFeedbackStreamInstanced, 1, transform_feedback)
+GL_CAPTURE_BUFFER_SIZE(glGetInternalformati64v, 3)
+GL_CAPTURE_NAME(glInvalidateTexSubImage, 0, texture)
+GL_CAPTURE_NAME(glInvalidateTexImage, 0, texture)
+GL_CAPTURE_NAME(glInvalidateBufferSubData, 0, buffer)
+GL_CAPTURE_NAME(glInvalidateBufferData, 0, buffer)
+GL_CAPTURE_NAME(glGetProgramInterfaceiv, 0, program)
+GL_CAPTURE_NAME(glGetProgramResourceIndex, 0, program)
+GL_CAPTURE_NAME(glGetProgramResourceName, 0, program)
+GL_CAPTURE_BUFFER_SIZE(glGetProgramResourceName, 3)
+GL_CAPTURE_NAME(glGetProgramResourceiv, 0, program)
+GL_CAPTURE_BUFFER_SIZE(glGetProgramResourceiv, 5)
+GL_CAPTURE_NAME(glGetProgramResourceLocation, 0, program)
+GL_CAPTURE_NAME(glGetProgramResourceLocationIndex, 0, program)
+GL_CAPTURE_NAME(glShaderStorageBlockBinding, 0, program)
+GL_CAPTURE_NAME(glTexBufferRange, 2, buffer)
+GL_CAPTURE_NAME(glTextureView, 0, texture)
+GL_CAPTURE_NAME(glTextureView, 2, texture)
+GL_CAPTURE_NAME(glBindVertexBuffer, 1, buffer)
+GL_CAPTURE_BUFFER_SIZE(glGetDebugMessageLog, 1)
+GL_CAPTURE_BUFFER_SIZE(glGetObjectLabel, 2)
+GL_CAPTURE_BUFFER_SIZE(glGetObjectPtrLabel, 1)
+GL_CAPTURE_NAME(glClearTexImage, 0, texture)
+GL_CAPTURE_NAME(glClearTexSubImage, 0, texture)
+GL_CAPTURE_NAMES(glBindBuffersBase, 3, buffer, 2)
+GL_CAPTURE_NAMES(glBindBuffersRange, 3, buffer, 2)
+GL_CAPTURE_NAMES(glBindTextures, 2, texture, 1)
+GL_CAPTURE_NAMES(glBindSamplers, 2, sampler, 1)
+GL_CAPTURE_NAMES(glBindImageTextures, 2, texture, 1)
+GL_CAPTURE_NAMES(glBindVertexBuffers, 2, buffer, 1)
+GL_CAPTURE_NAMES(glCreateTransformFeedbacks, 1, transform_feedback, 0)
+GL_CAPTURE_NAME(glTransformFeedbackBufferBase, 0, transform_feedback)
+GL_CAPTURE_NAME(glTransformFeedbackBufferBase, 2, buffer)
+GL_CAPTURE_NAME(glTransformFeedbackBufferRange, 0, transform_feedback)
+GL_CAPTURE_NAME(glTransformFeedbackBufferRange, 2, buffer)
+GL_CAPTURE_NAME(glGetTransformFeedbackiv, 0, transform_feedback)
+GL_CAPTURE_NAME(glGetTransformFeedbacki_v, 0, transform_feedback)
+GL_CAPTURE_NAME(glGetTransformFeedbacki64_v, 0, transform_feedback)
+GL_CAPTURE_NAMES(glCreateBuffers, 1, buffer, 0)
+GL_CAPTURE_NAME(glNamedBufferStorage, 0, buffer)
+GL_CAPTURE_NAME(glNamedBufferData, 0, buffer)
+GL_CAPTURE_NAME(glNamedBufferSubData, 0, buffer)
+GL_CAPTURE_NAME(glCopyNamedBufferSubData, 0, buffer)
+GL_CAPTURE_NAME(glCopyNamedBufferSubData, 1, buffer)
+GL_CAPTURE_NAME(glClearNamedBufferData, 0, buffer)
+GL_CAPTURE_NAME(glClearNamedBufferSubData, 0, buffer)
+GL_CAPTURE_NAME(glMapNamedBuffer, 0, buffer)
+GL_CAPTURE_NAME(glMapNamedBufferRange, 0, buffer)
+GL_CAPTURE_NAME(glUnmapNamedBuffer, 0, buffer)
+GL_CAPTURE_NAME(glFlushMappedNamedBufferRange, 0, buffer)
+GL_CAPTURE_NAME(glGetNamedBufferParameteriv, 0, buffer)
+GL_CAPTURE_NAME(glGetNamedBufferParameteri64v, 0, buffer)
+GL_CAPTURE_NAME(glGetNamedBufferPointerv, 0, buffer)
+GL_CAPTURE_NAME(glGetNamedBufferSubData, 0, buffer)
+GL_CAPTURE_NAMES(glCreateFramebuffers, 1, framebuffer, 0)
+GL_CAPTURE_NAME(glNamedFramebufferRenderbuffer, 0, framebuffer)
+GL_CAPTURE_NAME(glNamedFramebufferRenderbuffer, 3, renderbuffer)
+GL_CAPTURE_NAME(glNamedFramebufferParameteri, 0, framebuffer)
+GL_CAPTURE_NAME(glNamedFramebufferTexture, 0, framebuffer)
+GL_CAPTURE_NAME(glNamedFramebufferTexture, 2, texture)
+GL_CAPTURE_NAME(glNamedFramebufferTextureLayer, 0, framebuffer)
+GL_CAPTURE_NAME(glNamedFramebufferTextureLayer, 2, texture)
+GL_CAPTURE_NAME(glNamedFramebufferDrawBuffer, 0, framebuffer)
+GL_CAPTURE_NAME(glNamedFramebufferDrawBuffers, 0, framebuffer)
+GL_CAPTURE_NAME(glNamedFramebufferReadBuffer, 0, framebuffer)
+GL_CAPTURE_NAME(glInvalidateNamedFramebufferData, 0, framebuffer)
+GL_CAPTURE_NAME(glInvalidateNamedFramebufferSubData, 0, framebuffer)
+GL_CAPTURE_NAME(glClearNamedFramebufferiv, 0, framebuffer)
+GL_CAPTURE_NAME(glClearNamedFramebufferuiv, 0, framebuffer)
+GL_CAPTURE_NAME(glClearNamedFramebufferfv, 0, framebuffer)
+GL_CAPTURE_NAME(glClearNamedFramebufferfi, 0, framebuffer)
+GL_CAPTURE_NAME(glBlitNamedFramebuffer, 0, framebuffer)
+GL_CAPTURE_NAME(glBlitNamedFramebuffer, 1, framebuffer)
+GL_CAPTURE_NAME(glCheckNamedFramebufferStatus, 0, framebuffer)
+GL_CAPTURE_NAME(glGetNamedFramebufferParameteriv, 0, framebuffer)
+GL_CAPTURE_NAME(glGetNamedFramebufferAttachmentParameteriv, 0, framebuffer)
+GL_CAPTURE_NAMES(glCreateRenderbuffers, 1, renderbuffer, 0)
+GL_CAPTURE_NAME(glNamedRenderbufferStorage, 0, renderbuffer)
+GL_CAPTURE_NAME(glNamedRenderbufferStorageMultisample, 0, renderbuffer)
+GL_CAPTURE_NAME(glGetNamedRenderbufferParameteriv, 0, renderbuffer)
+GL_CAPTURE_NAMES(glCreateTextures, 2, texture, 1)
+GL_CAPTURE_NAME(glTextureBuffer, 0, texture)
+GL_CAPTURE_NAME(glTextureBuffer, 2, buffer)
+GL_CAPTURE_NAME(glTextureBufferRange, 0, texture)
+GL_CAPTURE_NAME(glTextureBufferRange, 2, buffer)
+GL_CAPTURE_NAME(glTextureStorage1D, 0, texture)
+GL_CAPTURE_NAME(glTextureStorage2D, 0, texture)
+GL_CAPTURE_NAME(glTextureStorage3D, 0, texture)
+GL_CAPTURE_NAME(glTextureStorage2DMultisample, 0, texture)
+GL_CAPTURE_NAME(glTextureStorage3DMultisample, 0, texture)
+GL_CAPTURE_NAME(glTextureSubImage1D, 0, texture)
+GL_CAPTURE_NAME(glTextureSubImage2D, 0, texture)
+GL_CAPTURE_NAME(glTextureSubImage3D, 0, texture)
+GL_CAPTURE_NAME(glCompressedTextureSubImage1D, 0, texture)
+GL_CAPTURE_NAME(glCompressedTextureSubImage2D, 0, texture)
+GL_CAPTURE_NAME(glCompressedTextureSubImage3D, 0, texture)
+GL_CAPTURE_NAME(glCopyTextureSubImage1D, 0, texture)
+GL_CAPTURE_NAME(glCopyTextureSubImage2D, 0, texture)
+GL_CAPTURE_NAME(glCopyTextureSubImage3D, 0, texture)
+GL_CAPTURE_NAME(glTextureParameterf, 0, texture)
+GL_CAPTURE_NAME(glTextureParameterfv, 0, texture)
+GL_CAPTURE_NAME(glTextureParameteri, 0, texture)
+GL_CAPTURE_NAME(glTextureParameterIiv, 0, texture)
+GL_CAPTURE_NAME(glTextureParameterIuiv, 0, texture)
+GL_CAPTURE_NAME(glTextureParameteriv, 0, texture)
+GL_CAPTURE_NAME(glGenerateTextureMipmap, 0, texture)
+GL_CAPTURE_NAME(glBindTextureUnit, 1, texture)
+GL_CAPTURE_NAME(glGetTextureImage, 0, texture)
+GL_CAPTURE_BUFFER_SIZE(glGetTextureImage, 4)
+GL_CAPTURE_NAME(glGetCompressedTextureImage, 0, texture)
+GL_CAPTURE_BUFFER_SIZE(glGetCompressedTextureImage, 2)
+GL_CAPTURE_NAME(glGetTextureLevelParameterfv, 0, texture)
+GL_CAPTURE_NAME(glGetTextureLevelParameteriv, 0, texture)
+GL_CAPTURE_NAME(glGetTextureParameterfv, 0, texture)
+GL_CAPTURE_NAME(glGetTextureParameterIiv, 0, texture)
+GL_CAPTURE_NAME(glGetTextureParameterIuiv, 0, texture)
+GL_CAPTURE_NAME(glGetTextureParameteriv, 0, texture)
+GL_CAPTURE_NAMES(glCreateVertexArrays, 1, vertex_array, 0)
+GL_CAPTURE_NAME(glDisableVertexArrayAttrib, 0, vertex_array)
+GL_CAPTURE_NAME(glEnableVertexArrayAttrib, 0, vertex_array)
+GL_CAPTURE_NAME(glVertexArrayElementBuffer, 0, vertex_array)
+GL_CAPTURE_NAME(glVertexArrayElementBuffer, 1, buffer)
+GL_CAPTURE_NAME(glVertexArrayVertexBuffer, 0, vertex_array)
+GL_CAPTURE_NAME(glVertexArrayVertexBuffer, 2, buffer)
+GL_CAPTURE_NAME(glVertexArrayVertexBuffers, 0, vertex_array)
+GL_CAPTURE_NAMES(glVertexArrayVertexBuffers, 3, buffer, 2)
+GL_CAPTURE_NAME(glVertexArrayAttribBinding, 0, vertex_array)
+GL_CAPTURE_NAME(glVertexArrayAttribFormat, 0, vertex_array)
+GL_CAPTURE_NAME(glVertexArrayAttribIFormat, 0, vertex_array)
+GL_CAPTURE_NAME(glVertexArrayAttribLFormat, 0, vertex_array)
+GL_CAPTURE_NAME(glVertexArrayBindingDivisor, 0, vertex_array)
+GL_CAPTURE_NAME(glGetVertexArrayiv, 0, vertex_array)
+GL_CAPTURE_NAME(glGetVertexArrayIndexediv, 0, vertex_array)
+GL_CAPTURE_NAME(glGetVertexArrayIndexed64iv, 0, vertex_array)
+GL_CAPTURE_NAMES(glCreateSamplers, 1, sampler, 0)
+GL_CAPTURE_NAMES(glCreateProgramPipelines, 1, pipeline, 0)
+GL_CAPTURE_NAMES(glCreateQueries, 2, query, 1)
+GL_CAPTURE_NAME(glGetQueryBufferObjecti64v, 0, query)
+GL_CAPTURE_NAME(glGetQueryBufferObjecti64v, 1, buffer)
+GL_CAPTURE_NAME(glGetQueryBufferObjectiv, 0, query)
+GL_CAPTURE_NAME(glGetQueryBufferObjectiv, 1, buffer)
+GL_CAPTURE_NAME(glGetQueryBufferObjectui64v, 0, query)
+GL_CAPTURE_NAME(glGetQueryBufferObjectui64v, 1, buffer)
+GL_CAPTURE_NAME(glGetQueryBufferObjectuiv, 0, query)
+GL_CAPTURE_NAME(glGetQueryBufferObjectuiv, 1, buffer)
+GL_CAPTURE_NAME(glGetTextureSubImage, 0, texture)
+GL_CAPTURE_BUFFER_SIZE(glGetTextureSubImage, 10)
+GL_CAPTURE_NAME(glGetCompressedTextureSubImage, 0, texture)
+GL_CAPTURE_BUFFER_SIZE(glGetCompressedTextureSubImage, 8)
+GL_CAPTURE_BUFFER_SIZE(glGetnCompressedTexImage, 2)
+GL_CAPTURE_BUFFER_SIZE(glGetnTexImage, 4)
+GL_CAPTURE_NAME(glGetnUniformdv, 0, program)
+GL_CAPTURE_BUFFER_SIZE(glGetnUniformdv, 2)
+GL_CAPTURE_NAME(glGetnUniformfv, 0, program)
+GL_CAPTURE_BUFFER_SIZE(glGetnUniformfv, 2)
+GL_CAPTURE_NAME(glGetnUniformiv, 0, program)
+GL_CAPTURE_BUFFER_SIZE(glGetnUniformiv, 2)
+GL_CAPTURE_NAME(glGetnUniformuiv, 0, program)
+GL_CAPTURE_BUFFER_SIZE(glGetnUniformuiv, 2)
+GL_CAPTURE_BUFFER_SIZE(glReadnPixels, 6)
+GL_CAPTURE_BUFFER_SIZE(glGetnMapdv, 2)
+GL_CAPTURE_BUFFER_SIZE(glGetnMapfv, 2)
+GL_CAPTURE_BUFFER_SIZE(glGetnMapiv, 2)
+GL_CAPTURE_BUFFER_SIZE(glGetnPixelMapfv, 1)
+GL_CAPTURE_BUFFER_SIZE(glGetnPixelMapuiv, 1)
+GL_CAPTURE_BUFFER_SIZE(glGetnPixelMapusv, 1)
+GL_CAPTURE_BUFFER_SIZE(glGetnPolygonStipple, 0)
+GL_CAPTURE_BUFFER_SIZE(glGetnColorTable, 3)
+GL_CAPTURE_BUFFER_SIZE(glGetnConvolutionFilter, 3)
+GL_CAPTURE_BUFFER_SIZE(glGetnHistogram, 4)
+GL_CAPTURE_BUFFER_SIZE(glGetnMinmax, 4)
+GL_CAPTURE_NAME(glSpecializeShader, 0, program)
\ No newline at end of file
@@ -0,0 +1,236 @@
+#include <gl_objects.hpp>
+#include <gl_state.hpp>
+#include <utility>
+
+namespace glsl {
+
+using namespace std;
+
+Buffer::Buffer(GLsizeiptr size, const void* data, GLbitfield flags)
+	: mBuffer{ 0 }
+	, mSize{ size }
+{
+	glCreateBuffers(1, &mBuffer);
+	glNamedBufferStorage(mBuffer, size, data, flags);
+}
+
+Buffer::Buffer(Buffer&& rhs) noexcept
+	: mBuffer{ exchange(rhs.mBuffer, 0u) }
+	, mSize{ exchange(rhs.mSize, 0) }
+{
+}
+
+Buffer& Buffer::operator = (Buffer&& rhs) noexcept
+{
+	swap(mBuffer, rhs.mBuffer);
+	swap(mSize, rhs.mSize);
+	return *this;
+}
+
+Buffer::~Buffer()
+{
+	if (mBuffer)
+	{
+		GLState::current().forgetBuffer(mBuffer);
+		glDeleteBuffers(1, &mBuffer);
+	}
+}
+
+void Buffer::subData(GLintptr offset, GLsizeiptr size, const void* data)
+{
+	glNamedBufferSubData(mBuffer, offset, size, data);
+}
+
+void* Buffer::mapRange(GLintptr offset, GLsizeiptr length, GLbitfield access)
+{
+	return glMapNamedBufferRange(mBuffer, offset, length, access);
+}
+
+void Buffer::unmap()
+{
+	glUnmapNamedBuffer(mBuffer);
+}
+
+void Buffer::bind(GLenum target) const
+{
+	GLState::current().bindBuffer(target, mBuffer);
+}
+
+void Buffer::bindBase(GLenum target, GLuint index) const
+{
+	GLState::current().bindBufferBase(target, index, mBuffer);
+}
+
+VertexArray::VertexArray()
+	: mVao{ 0 }
+{
+	glCreateVertexArrays(1, &mVao);
+}
+
+VertexArray::VertexArray(VertexArray&& rhs) noexcept
+	: mVao{ exchange(rhs.mVao, 0u) }
+{
+}
+
+VertexArray& VertexArray::operator = (VertexArray&& rhs) noexcept
+{
+	swap(mVao, rhs.mVao);
+	return *this;
+}
+
+VertexArray::~VertexArray()
+{
+	if (mVao)
+	{
+		GLState::current().forgetVertexArray(mVao);
+		glDeleteVertexArrays(1, &mVao);
+	}
+}
+
+void VertexArray::vertexBuffer(GLuint binding, const Buffer& buffer, GLintptr offset, GLsizei stride)
+{
+	glVertexArrayVertexBuffer(mVao, binding, buffer, offset, stride);
+}
+
+void VertexArray::bindingDivisor(GLuint binding, GLuint divisor)
+{
+	glVertexArrayBindingDivisor(mVao, binding, divisor);
+}
+
+void VertexArray::elementBuffer(const Buffer& buffer)
+{
+	glVertexArrayElementBuffer(mVao, buffer);
+}
+
+void VertexArray::attribute(GLuint index, GLuint binding, GLint size, GLenum type, GLuint relativeOffset, bool normalized)
+{
+	glEnableVertexArrayAttrib(mVao, index);
+	glVertexArrayAttribFormat(mVao, index, size, type, normalized ? GL_TRUE : GL_FALSE, relativeOffset);
+	glVertexArrayAttribBinding(mVao, index, binding);
+}
+
+void VertexArray::format(GLuint binding, const VertexLayout& layout)
+{
+	for (const auto& a : layout.attributes)
+		attribute(a.location, binding, a.components, a.type, a.offset, a.normalized);
+}
+
+void VertexArray::bind() const
+{
+	GLState::current().bindVertexArray(mVao);
+}
+
+Texture::Texture(GLenum target)
+	: mTexture{ 0 }
+	, mTarget{ target }
+{
+	glCreateTextures(target, 1, &mTexture);
+}
+
+Texture::Texture(Texture&& rhs) noexcept
+	: mTexture{ exchange(rhs.mTexture, 0u) }
+	, mTarget{ rhs.mTarget }
+{
+}
+
+Texture& Texture::operator = (Texture&& rhs) noexcept
+{
+	swap(mTexture, rhs.mTexture);
+	swap(mTarget, rhs.mTarget);
+	return *this;
+}
+
+Texture::~Texture()
+{
+	if (mTexture)
+	{
+		GLState::current().forgetTexture(mTexture);
+		glDeleteTextures(1, &mTexture);
+	}
+}
+
+void Texture::storage2D(GLsizei levels, GLenum internalFormat, GLsizei width, GLsizei height)
+{
+	glTextureStorage2D(mTexture, levels, internalFormat, width, height);
+}
+
+void Texture::storage3D(GLsizei levels, GLenum internalFormat, GLsizei width, GLsizei height, GLsizei depth)
+{
+	glTextureStorage3D(mTexture, levels, internalFormat, width, height, depth);
+}
+
+void Texture::subImage2D(GLint level, GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, const void* pixels)
+{
+	glTextureSubImage2D(mTexture, level, x, y, width, height, format, type, pixels);
+}
+
+void Texture::generateMipmap()
+{
+	glGenerateTextureMipmap(mTexture);
+}
+
+void Texture::parameter(GLenum name, GLint value)
+{
+	glTextureParameteri(mTexture, name, value);
+}
+
+void Texture::parameter(GLenum name, GLfloat value)
+{
+	glTextureParameterf(mTexture, name, value);
+}
+
+void Texture::bind(GLuint unit) const
+{
+	GLState::current().bindTexture(unit, mTarget, mTexture);
+}
+
+Sampler::Sampler()
+	: mSampler{ 0 }
+{
+	glCreateSamplers(1, &mSampler);
+}
+
+Sampler::Sampler(Sampler&& rhs) noexcept
+	: mSampler{ exchange(rhs.mSampler, 0u) }
+{
+}
+
+Sampler& Sampler::operator = (Sampler&& rhs) noexcept
+{
+	swap(mSampler, rhs.mSampler);
+	return *this;
+}
+
+Sampler::~Sampler()
+{
+	if (mSampler)
+	{
+		GLState::current().forgetSampler(mSampler);
+		glDeleteSamplers(1, &mSampler);
+	}
+}
+
+void Sampler::parameter(GLenum name, GLint value)
+{
+	glSamplerParameteri(mSampler, name, value);
+}
+
+void Sampler::parameter(GLenum name, GLfloat value)
+{
+	glSamplerParameterf(mSampler, name, value);
+}
+
+void Sampler::bind(GLuint unit) const
+{
+	GLState::current().bindSampler(unit, mSampler);
+}
+
+GLsizei mipLevels(GLsizei width, GLsizei height) noexcept
+{
+	GLsizei levels = 1;
+	for (auto size = width > height ? width : height; size > 1; size >>= 1)
+		++levels;
+	return levels;
+}
+
+} // glsl
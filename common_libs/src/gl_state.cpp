@@ -0,0 +1,179 @@
+#include <gl_state.hpp>
+
+namespace glsl {
+
+using namespace std;
+
+GLState& GLState::current()
+{
+	thread_local GLState state;
+	return state;
+}
+
+GLState::GLState()
+{
+	invalidate();
+}
+
+void GLState::invalidate() noexcept
+{
+	mProgram = unknown;
+	mVertexArray = unknown;
+	mActiveUnit = unknown;
+	mPolygonMode = unknown;
+	mBuffers.fill(unknown);
+	for (auto& unit : mTextures)
+		unit.fill(unknown);
+	mSamplers.fill(unknown);
+	mCaps.fill(Cap::unknown);
+}
+
+void GLState::useProgram(GLuint program)
+{
+	if (skip(mProgram == program))
+		return;
+
+	glUseProgram(program);
+	mProgram = program;
+}
+
+void GLState::bindVertexArray(GLuint vao)
+{
+	if (skip(mVertexArray == vao))
+		return;
+
+	glBindVertexArray(vao);
+	mVertexArray = vao;
+
+	// the element array binding is part of the VAO
+	mBuffers[indexOf(buffer_targets, GL_ELEMENT_ARRAY_BUFFER)] = unknown;
+}
+
+void GLState::bindBuffer(GLenum target, GLuint buffer)
+{
+	const auto index = indexOf(buffer_targets, target);
+	if (index >= 0 && skip(mBuffers[index] == buffer))
+		return;
+
+	glBindBuffer(target, buffer);
+	if (index >= 0)
+		mBuffers[index] = buffer;
+}
+
+void GLState::bindBufferBase(GLenum target, GLuint index, GLuint buffer)
+{
+	++mIssued;
+	glBindBufferBase(target, index, buffer);
+
+	const auto generic = indexOf(buffer_targets, target);
+	if (generic >= 0)
+		mBuffers[generic] = buffer;
+}
+
+void GLState::bindTexture(GLuint unit, GLenum target, GLuint texture)
+{
+	const auto index = unit < max_texture_units ? indexOf(texture_targets, target) : -1;
+	if (index >= 0 && skip(mTextures[unit][index] == texture))
+		return;
+
+	activeTexture(unit);
+	glBindTexture(target, texture);
+	if (index >= 0)
+		mTextures[unit][index] = texture;
+}
+
+void GLState::bindSampler(GLuint unit, GLuint sampler)
+{
+	const auto tracked = unit < max_texture_units;
+	if (tracked && skip(mSamplers[unit] == sampler))
+		return;
+
+	glBindSampler(unit, sampler);
+	if (tracked)
+		mSamplers[unit] = sampler;
+}
+
+void GLState::enable(GLenum cap)
+{
+	setEnabled(cap, true);
+}
+
+void GLState::disable(GLenum cap)
+{
+	setEnabled(cap, false);
+}
+
+void GLState::setEnabled(GLenum cap, bool enabled)
+{
+	const auto index = indexOf(caps, cap);
+	const auto value = enabled ? Cap::on : Cap::off;
+	if (index >= 0 && skip(mCaps[index] == value))
+		return;
+
+	if (enabled)
+		glEnable(cap);
+	else
+		glDisable(cap);
+
+	if (index >= 0)
+		mCaps[index] = value;
+}
+
+void GLState::polygonMode(GLenum mode)
+{
+	if (skip(mPolygonMode == mode))
+		return;
+
+	glPolygonMode(GL_FRONT_AND_BACK, mode);
+	mPolygonMode = mode;
+}
+
+void GLState::forgetProgram(GLuint program) noexcept
+{
+	// a deleted program stays in use until something else is bound
+	if (mProgram == program)
+		mProgram = unknown;
+}
+
+void GLState::forgetVertexArray(GLuint vao) noexcept
+{
+	if (mVertexArray != vao)
+		return;
+
+	// deleting the bound VAO falls back to VAO 0 and its element array binding
+	mVertexArray = 0;
+	mBuffers[indexOf(buffer_targets, GL_ELEMENT_ARRAY_BUFFER)] = unknown;
+}
+
+void GLState::forgetBuffer(GLuint buffer) noexcept
+{
+	for (auto& b : mBuffers)
+		if (b == buffer)
+			b = 0;
+}
+
+void GLState::forgetTexture(GLuint texture) noexcept
+{
+	for (auto& unit : mTextures)
+		for (auto& t : unit)
+			if (t == texture)
+				t = 0;
+}
+
+void GLState::forgetSampler(GLuint sampler) noexcept
+{
+	for (auto& s : mSamplers)
+		if (s == sampler)
+			s = 0;
+}
+
+void GLState::activeTexture(GLuint unit)
+{
+	if (skip(mActiveUnit == unit))
+		return;
+
+	glActiveTexture(GL_TEXTURE0 + unit);
+	mActiveUnit = unit;
+}
+
+} // glsl
@@ -0,0 +1,265 @@
+#include <gl_trace.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <ostream>
+
+namespace glsl {
+
+using namespace std;
+
+namespace {
+
+	// fn_ pastes the name before glad's #define turns it into glad_gl*
+	enum Function : size_t {
+#define GL_TRACE_FUNCTION(name) fn_##name,
+#include "gl_trace_functions.inl"
+#undef GL_TRACE_FUNCTION
+		function_count
+	};
+
+	const char* const function_names[] = {
+#define GL_TRACE_FUNCTION(name) #name,
+#include "gl_trace_functions.inl"
+#undef GL_TRACE_FUNCTION
+	};
+
+	array<uint64_t, function_count> g_calls{};
+	array<uint64_t, function_count> g_nanoseconds{};
+	array<GlCallCategory, function_count> g_categories{};
+	array<uint64_t, gl_call_category_count> g_categoryCalls{};
+	bool g_timing = false;
+
+	bool startsWith(const char* name, const char* prefix) noexcept
+	{
+		return !strncmp(name, prefix, strlen(prefix));
+	}
+
+	GlCallCategory categorize(const char* name) noexcept
+	{
+		if (startsWith(name, "glDraw") || startsWith(name, "glMultiDraw") || startsWith(name, "glDispatchCompute"))
+			return GlCallCategory::draw;
+
+		if (startsWith(name, "glBind") || !strcmp(name, "glUseProgram"))
+			return GlCallCategory::bind;
+
+		if (startsWith(name, "glUniform") || startsWith(name, "glProgramUniform"))
+			return GlCallCategory::uniform;
+
+		if (strstr(name, "BufferData") || strstr(name, "BufferSubData") || strstr(name, "BufferStorage")
+			|| startsWith(name, "glTexImage") || startsWith(name, "glTexSubImage")
+			|| startsWith(name, "glTextureSubImage") || startsWith(name, "glCompressedTex"))
+			return GlCallCategory::upload;
+
+		return GlCallCategory::other;
+	}
+
+	class CallTimer {
+	public:
+		explicit CallTimer(size_t id) noexcept
+			: mId{ id }
+			, mStart{ chrono::steady_clock::now() }
+		{
+		}
+
+		~CallTimer()
+		{
+			g_nanoseconds[mId] += static_cast<uint64_t>(chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - mStart).count());
+		}
+
+	private:
+		size_t mId;
+		chrono::steady_clock::time_point mStart;
+	};
+
+	template <size_t Id, typename Fn>
+	struct Hook;
+
+	template <size_t Id, typename R, typename... Args>
+	struct Hook<Id, R (APIENTRY*)(Args...)> {
+		static inline R (APIENTRY* original)(Args...) = nullptr;
+
+		static R APIENTRY call(Args... args)
+		{
+			++g_calls[Id];
+			++g_categoryCalls[static_cast<size_t>(g_categories[Id])];
+
+			if (!g_timing)
+				return original(args...);
+
+			CallTimer timer{ Id };
+			return original(args...);
+		}
+	};
+
+	void install()
+	{
+#define GL_TRACE_FUNCTION(name) \
+		if (name && name != Hook<fn_##name, decltype(name)>::call) \
+		{ \
+			Hook<fn_##name, decltype(name)>::original = name; \
+			name = Hook<fn_##name, decltype(name)>::call; \
+		}
+#include "gl_trace_functions.inl"
+#undef GL_TRACE_FUNCTION
+	}
+
+	void uninstall()
+	{
+#define GL_TRACE_FUNCTION(name) \
+		if (name == Hook<fn_##name, decltype(name)>::call) \
+			name = Hook<fn_##name, decltype(name)>::original;
+#include "gl_trace_functions.inl"
+#undef GL_TRACE_FUNCTION
+	}
+}
+
+GlCallTrace& GlCallTrace::instance()
+{
+	static GlCallTrace trace;
+	return trace;
+}
+
+const char* GlCallTrace::categoryName(GlCallCategory category) noexcept
+{
+	switch (category)
+	{
+	case GlCallCategory::draw:
+		return "draw";
+
+	case GlCallCategory::bind:
+		return "bind";
+
+	case GlCallCategory::uniform:
+		return "uniform";
+
+	case GlCallCategory::upload:
+		return "upload";
+
+	default:
+		return "other";
+	}
+}
+
+void GlCallTrace::enable(bool timing)
+{
+	for (size_t i = 0; i < function_count; ++i)
+		g_categories[i] = categorize(function_names[i]);
+
+	for (auto& frames : mPerFrame)
+		frames.reserve(history_frames);
+
+	g_timing = timing;
+	install();
+	mEnabled = true;
+}
+
+void GlCallTrace::disable()
+{
+	uninstall();
+	mEnabled = false;
+}
+
+void GlCallTrace::frameEnd()
+{
+	if (!mEnabled)
+		return;
+
+	for (size_t c = 0; c < gl_call_category_count; ++c)
+	{
+		mLastFrame[c] = g_categoryCalls[c];
+		g_categoryCalls[c] = 0;
+
+		// past the window the oldest frame makes way
+		auto& frames = mPerFrame[c];
+		if (frames.size() < history_frames)
+			frames.push_back(static_cast<double>(mLastFrame[c]));
+		else
+			frames[mFrames % history_frames] = static_cast<double>(mLastFrame[c]);
+	}
+
+	++mFrames;
+}
+
+common::TimingSummary GlCallTrace::histogram(GlCallCategory category) const
+{
+	return common::summarize(mPerFrame[static_cast<size_t>(category)]);
+}
+
+vector<GlCallCount> GlCallTrace::busiest(size_t count) const
+{
+	vector<GlCallCount> calls;
+	for (size_t i = 0; i < function_count; ++i)
+	{
+		if (g_calls[i])
+			calls.push_back({ function_names[i], g_calls[i], static_cast<double>(g_nanoseconds[i]) * 1e-6 });
+	}
+
+	sort(calls.begin(), calls.end(), [](const GlCallCount& a, const GlCallCount& b)
+	{
+		return a.calls > b.calls;
+	});
+
+	if (calls.size() > count)
+		calls.resize(count);
+
+	return calls;
+}
+
+void GlCallTrace::reset()
+{
+	g_calls.fill(0);
+	g_nanoseconds.fill(0);
+	g_categoryCalls.fill(0);
+	mLastFrame.fill(0);
+	for (auto& frames : mPerFrame)
+		frames.clear();
+	mFrames = 0;
+}
+
+void GlCallTrace::writeJson(ostream& out, size_t busiestCount) const
+{
+	out << "{\"frames\":" << mFrames;
+	for (size_t c = 0; c < gl_call_category_count; ++c)
+	{
+		out << ",\"" << categoryName(static_cast<GlCallCategory>(c)) << "\":";
+		common::writeJson(out, common::summarize(mPerFrame[c]));
+	}
+
+	out << ",\"busiest\":[";
+	const auto calls = busiest(busiestCount);
+	for (size_t i = 0; i < calls.size(); ++i)
+	{
+		char text[96];
+		snprintf(text, sizeof(text), "%s{\"name\":\"%s\",\"calls\":%llu,\"ms\":%.3f}", i ? "," : "",
+			calls[i].name, static_cast<unsigned long long>(calls[i].calls), calls[i].ms);
+		out << text;
+	}
+	out << "]}";
+}
+
+void GlCallTrace::writeReport(ostream& out, size_t busiestCount) const
+{
+	char text[160];
+
+	snprintf(text, sizeof(text), "GL calls per frame over %llu frames:\n", static_cast<unsigned long long>(mFrames));
+	out << text;
+
+	for (size_t c = 0; c < gl_call_category_count; ++c)
+	{
+		const auto summary = common::summarize(mPerFrame[c]);
+		snprintf(text, sizeof(text), "  %-8s min %8.0f  mean %10.1f  p50 %8.0f  p95 %8.0f  max %8.0f\n",
+			categoryName(static_cast<GlCallCategory>(c)), summary.min, summary.mean, summary.p50, summary.p95, summary.max);
+		out << text;
+	}
+
+	for (const auto& call : busiest(busiestCount))
+	{
+		snprintf(text, sizeof(text), "  %-36s %12llu calls %10.3f ms\n", call.name,
+			static_cast<unsigned long long>(call.calls), call.ms);
+		out << text;
+	}
+}
+
+} // glsl
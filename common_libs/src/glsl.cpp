@@ -10,8 +10,15 @@ using namespace std;
 using namespace std::string_literals;
 
 Shader::Shader(ShaderType type, const std::string& filename)
+	: Shader(type, filename, {})
+{
+}
+
+Shader::Shader(ShaderType type, const std::string& filename, const std::string& prelude)
 	: mShader{ glCreateShader(type) }
 {
+	COMMON_PROFILE_SCOPE("Shader::compile");
+
 	std::ifstream file(filename);
 
 	if (!file)
@@ -21,6 +28,16 @@ Shader::Shader(ShaderType type, const std::string& filename)
 	buffer << file.rdbuf();
 
 	auto srcData = buffer.str();
+
+	if (!prelude.empty())
+	{
+		// #line keeps the compiler's line numbers pointing into the file
+		const auto versionEnd = srcData.compare(0, 8, "#version") == 0 ? srcData.find('\n') : string::npos;
+		if (versionEnd == string::npos)
+			srcData = prelude + "\n#line 1\n" + srcData;
+		else
+			srcData.insert(versionEnd + 1, prelude + "\n#line 2\n");
+	}
 	auto ptr = srcData.c_str();
 	glShaderSource(mShader, 1, &ptr, nullptr);
 
@@ -65,6 +82,8 @@ Shader::~Shader()
 Program::Program(std::initializer_list<Shader> shaders)
 	: mProgram{ glCreateProgram() }
 {
+	COMMON_PROFILE_SCOPE("Program::link");
+
 	for_each(begin(shaders), end(shaders), [this](auto&& shader)
 	{
 		glAttachShader(mProgram, shader);
@@ -101,6 +120,7 @@ Program::Program(std::initializer_list<Shader> shaders)
 
 Program::Program(Program&& rhs)
 	: mProgram(rhs.mProgram)
+	, m_uniformMap(std::move(rhs.m_uniformMap))
 {
 	rhs.mProgram = 0;
 }
@@ -108,6 +128,7 @@ Program::Program(Program&& rhs)
 Program& Program::operator = (Program&& rhs)
 {
 	mProgram = rhs.mProgram;
+	m_uniformMap = std::move(rhs.m_uniformMap);
 	return *this;
 }
 
@@ -115,11 +136,26 @@ Program::~Program()
 {
 	if (mProgram)
 	{
-		unuse();
+		// only unbind when this program is actually the one in use
+		if (GLState::current().program() == mProgram)
+			unuse();
+
 		glDeleteProgram(mProgram);
 	}
 }
 
+GLint Program::location(std::string_view name)
+{
+	auto it = m_uniformMap.find(name);
+	if (it == m_uniformMap.end())
+	{
+		std::string key{ name };
+		const auto res = uniformLocation(key);
+		it = m_uniformMap.emplace(std::move(key), res).first;
+	}
+
+	return it->second;
+}
 
 GLint Program::uniformLocation(const std::string& str)
 {
@@ -0,0 +1,97 @@
+#include <gpu_culling.hpp>
+#include <stdexcept>
+
+namespace glsl {
+
+using namespace std;
+
+GpuCuller::GpuCuller(uint32_t maxDraws, const string& shader)
+	: mMaxDraws{ maxDraws }
+	, mCompact{ IndirectDrawBatch::indirectCountSupported() }
+	, mProgram{ { compute_shader, shader } }
+	, mPlanesLocation{ glGetUniformLocation(mProgram, "planes") }
+	, mDrawCountLocation{ glGetUniformLocation(mProgram, "drawCount") }
+	, mCompactLocation{ glGetUniformLocation(mProgram, "compact") }
+	, mBoundsBuffer{ static_cast<GLsizeiptr>(maxDraws * sizeof(CullBounds)), nullptr, GL_DYNAMIC_STORAGE_BIT }
+	, mVisibleBuffer{ static_cast<GLsizeiptr>(maxDraws * sizeof(DrawElementsIndirectCommand)), nullptr, 0 }
+	, mCountBuffer{ static_cast<GLsizeiptr>(sizeof(GLuint)), nullptr, GL_DYNAMIC_STORAGE_BIT }
+{
+	if (maxDraws == 0)
+		throw invalid_argument{ "GpuCuller needs room for at least one draw" };
+
+	mBounds.reserve(maxDraws);
+	glProgramUniform1i(mProgram, mCompactLocation, mCompact ? 1 : 0);
+}
+
+void GpuCuller::setBounds(const vector<common::Aabb>& bounds)
+{
+	if (bounds.size() > mMaxDraws)
+		throw length_error{ "more bounds than GpuCuller draws" };
+
+	mBounds.clear();
+	for (const auto& box : bounds)
+		mBounds.push_back({ glm::vec4{ box.center(), 1.0f }, glm::vec4{ box.halfExtent(), 0.0f } });
+
+	if (!mBounds.empty())
+		mBoundsBuffer.subData(0, static_cast<GLsizeiptr>(mBounds.size() * sizeof(CullBounds)), mBounds.data());
+}
+
+void GpuCuller::cull(const IndirectDrawBatch& batch, const common::Frustum& frustum)
+{
+	mCulled = batch.uploadedCount();
+	if (mCulled > mBounds.size())
+		throw invalid_argument{ "GpuCuller::cull without bounds for every draw" };
+
+	const GLuint zero = 0;
+	mCountBuffer.subData(0, sizeof(GLuint), &zero);
+
+	if (mCulled == 0)
+		return;
+
+	glProgramUniform4fv(mProgram, mPlanesLocation, static_cast<GLsizei>(frustum.planes.size()), &frustum.planes[0].x);
+	glProgramUniform1ui(mProgram, mDrawCountLocation, mCulled);
+
+	mProgram.use();
+	batch.commandBuffer().bindBase(GL_SHADER_STORAGE_BUFFER, 0);
+	mBoundsBuffer.bindBase(GL_SHADER_STORAGE_BUFFER, 1);
+	mVisibleBuffer.bindBase(GL_SHADER_STORAGE_BUFFER, 2);
+	mCountBuffer.bindBase(GL_SHADER_STORAGE_BUFFER, 3);
+
+	glDispatchCompute((mCulled + 63) / 64, 1, 1);
+
+	// the draw reads the results as commands and parameters, not as SSBOs
+	glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT);
+}
+
+void GpuCuller::submit(const GeometryArena& arena, const IndirectDrawBatch& batch, GLenum mode, GLuint dataBinding) const
+{
+	if (mCulled == 0)
+		return;
+
+	const auto& vao = arena.vertexArray(batch.uploadedPage());
+	batch.bindDrawIndex(vao);
+	vao.bind();
+	batch.drawDataBuffer().bindBase(GL_SHADER_STORAGE_BUFFER, dataBinding);
+	mVisibleBuffer.bind(GL_DRAW_INDIRECT_BUFFER);
+
+	if (mCompact)
+	{
+		mCountBuffer.bind(GL_PARAMETER_BUFFER);
+		glMultiDrawElementsIndirectCount(mode, GL_UNSIGNED_INT, nullptr, 0, static_cast<GLsizei>(mCulled), 0);
+	}
+	else
+	{
+		glMultiDrawElementsIndirect(mode, GL_UNSIGNED_INT, nullptr, static_cast<GLsizei>(mCulled), 0);
+	}
+}
+
+uint32_t GpuCuller::readVisibleCount() const
+{
+	glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+
+	GLuint count = 0;
+	glGetNamedBufferSubData(mCountBuffer, 0, sizeof(GLuint), &count);
+	return count;
+}
+
+} // glsl
@@ -0,0 +1,182 @@
+#include <gpu_profiler.hpp>
+#include <frame_stats.hpp>
+#include <cstdio>
+#include <cstring>
+#include <ostream>
+#include <stdexcept>
+
+namespace glsl {
+
+using namespace std;
+
+GpuProfiler::GpuProfiler(size_t latency)
+	: mFrames(latency)
+{
+	if (latency < 2)
+		throw invalid_argument{ "GpuProfiler needs at least two frames in flight" };
+}
+
+GpuProfiler::~GpuProfiler()
+{
+	for (auto& frame : mFrames)
+	{
+		if (!frame.queries.empty())
+			glDeleteQueries(static_cast<GLsizei>(frame.queries.size()), frame.queries.data());
+	}
+}
+
+void GpuProfiler::begin(const char* name)
+{
+	auto& frame = mFrames[mCurrent];
+
+	const auto query = static_cast<uint32_t>(frame.scopes.size() * 2);
+	if (frame.queries.size() < query + 2)
+	{
+		// grows once to the deepest frame seen, then the queries are reused
+		frame.queries.resize(query + 2);
+		glGenQueries(2, frame.queries.data() + query);
+	}
+
+	const auto parent = mOpen.empty() ? -1 : mOpen.back();
+	frame.scopes.push_back({
+		name,
+		parent,
+		static_cast<uint32_t>(mOpen.size()),
+		query,
+		pathIndex(name, parent < 0 ? -1 : static_cast<int32_t>(frame.scopes[parent].path))
+	});
+	mOpen.push_back(static_cast<int32_t>(frame.scopes.size() - 1));
+
+	glQueryCounter(frame.queries[query], GL_TIMESTAMP);
+}
+
+uint32_t GpuProfiler::pathIndex(const char* name, int32_t parentPath)
+{
+	for (size_t i = 0; i < mPathKeys.size(); ++i)
+	{
+		const auto& key = mPathKeys[i];
+		if (key.parent == parentPath && (key.name == name || strcmp(key.name, name) == 0))
+			return static_cast<uint32_t>(i);
+	}
+
+	// a new path: the only time one is built
+	auto path = parentPath < 0 ? string{} : mHistory[parentPath].path + '/';
+	path += name;
+
+	mPathKeys.push_back({ name, parentPath });
+	mHistory.push_back({ move(path), {} });
+	mHistory.back().ms.reserve(mHistoryFrames);
+
+	return static_cast<uint32_t>(mPathKeys.size() - 1);
+}
+
+void GpuProfiler::end()
+{
+	if (mOpen.empty())
+		throw logic_error{ "GpuProfiler::end without a matching begin" };
+
+	auto& frame = mFrames[mCurrent];
+	const auto& scope = frame.scopes[mOpen.back()];
+	glQueryCounter(frame.queries[scope.query + 1], GL_TIMESTAMP);
+
+	mOpen.pop_back();
+}
+
+void GpuProfiler::endFrame()
+{
+	if (!mOpen.empty())
+		throw logic_error{ "GpuProfiler frame ended inside a scope" };
+
+	auto& frame = mFrames[mCurrent];
+	frame.frame = mFrame++;
+	frame.pending = !frame.scopes.empty();
+
+	mCurrent = (mCurrent + 1) % mFrames.size();
+	collect(mFrames[mCurrent]);
+}
+
+void GpuProfiler::finish()
+{
+	for (size_t i = 1; i <= mFrames.size(); ++i)
+		collect(mFrames[(mCurrent + i) % mFrames.size()]);
+}
+
+void GpuProfiler::collect(Frame& frame)
+{
+	if (!frame.pending)
+	{
+		frame.scopes.clear();
+		return;
+	}
+
+	// the last end timestamp is the last to become available
+	GLint available = 0;
+	glGetQueryObjectiv(frame.queries[frame.scopes.size() * 2 - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+	if (!available)
+		++mStalls;
+
+	mResults.clear();
+	mResultPaths.clear();
+
+	for (size_t i = 0; i < frame.scopes.size(); ++i)
+	{
+		const auto& scope = frame.scopes[i];
+
+		GLuint64 begin = 0, end = 0;
+		glGetQueryObjectui64v(frame.queries[scope.query], GL_QUERY_RESULT, &begin);
+		glGetQueryObjectui64v(frame.queries[scope.query + 1], GL_QUERY_RESULT, &end);
+
+		const auto ms = end > begin ? static_cast<double>(end - begin) * 1e-6 : 0.0;
+		mResults.push_back({ scope.name, scope.parent, scope.depth, ms });
+		mResultPaths.push_back(scope.path);
+
+		if (frame.frame >= mHistoryStart)
+			mHistory[scope.path].ms.push_back(ms);
+	}
+
+	mResultFrame = frame.frame;
+	frame.scopes.clear();
+	frame.pending = false;
+}
+
+string GpuProfiler::summary() const
+{
+	string text;
+	char ms[32];
+
+	for (size_t i = 0; i < mResults.size(); ++i)
+	{
+		if (!text.empty())
+			text += ", ";
+
+		snprintf(ms, sizeof(ms), " %.2f ms", mResults[i].ms);
+		text += mHistory[mResultPaths[i]].path;
+		text += ms;
+	}
+
+	return text;
+}
+
+void GpuProfiler::writeJson(ostream& out) const
+{
+	out << '{';
+
+	auto first = true;
+	for (const auto& [path, samples] : mHistory)
+	{
+		if (samples.empty())
+			continue;
+
+		if (!first)
+			out << ',';
+		first = false;
+
+		common::writeJson(out, path);
+		out << ':';
+		common::writeJson(out, common::summarize(samples));
+	}
+
+	out << '}';
+}
+
+} // glsl
@@ -0,0 +1,92 @@
+#include <image_diff.hpp>
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define IMAGE_DIFF_USE_SSE2
+#endif
+
+namespace common {
+
+using namespace std;
+
+namespace {
+
+	// a madd lane gains at most 2 * 255^2 per block of 16 bytes, which fits
+	// 32 bits for this many blocks
+	constexpr size_t blocks_per_flush = 8192;
+
+	// set bits of a 4 bit movemask
+	constexpr unsigned mask_bits[16] = { 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4 };
+}
+
+ImageDiff diffRgba(const uint8_t* a, const uint8_t* b, size_t pixels, unsigned tolerance) noexcept
+{
+	ImageDiff diff;
+	diff.pixels = pixels;
+
+	const auto bytes = pixels * 4;
+	uint64_t squared = 0;
+	size_t i = 0;
+
+#if defined(IMAGE_DIFF_USE_SSE2)
+	const auto zero = _mm_setzero_si128();
+	const auto limit = _mm_set1_epi8(static_cast<char>(min(tolerance, 255u)));
+	auto maxDelta = zero;
+
+	while (i + 16 <= bytes)
+	{
+		auto sums = zero;
+		for (size_t block = 0; block < blocks_per_flush && i + 16 <= bytes; ++block, i += 16)
+		{
+			const auto va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+			const auto vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+			const auto delta = _mm_or_si128(_mm_subs_epu8(va, vb), _mm_subs_epu8(vb, va));
+
+			maxDelta = _mm_max_epu8(maxDelta, delta);
+
+			// a pixel is within tolerance when all four of its bytes are
+			const auto over = _mm_subs_epu8(delta, limit);
+			const auto within = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(over, zero)));
+			diff.differing += 4 - mask_bits[within];
+
+			const auto low = _mm_unpacklo_epi8(delta, zero);
+			const auto high = _mm_unpackhi_epi8(delta, zero);
+			sums = _mm_add_epi32(sums, _mm_add_epi32(_mm_madd_epi16(low, low), _mm_madd_epi16(high, high)));
+		}
+
+		alignas(16) uint32_t lanes[4];
+		_mm_store_si128(reinterpret_cast<__m128i*>(lanes), sums);
+		squared += uint64_t{ lanes[0] } + lanes[1] + lanes[2] + lanes[3];
+	}
+
+	alignas(16) uint8_t maxLanes[16];
+	_mm_store_si128(reinterpret_cast<__m128i*>(maxLanes), maxDelta);
+	diff.maxDelta = *max_element(begin(maxLanes), end(maxLanes));
+#endif
+
+	for (; i < bytes; i += 4)
+	{
+		auto differs = false;
+		for (size_t c = 0; c < 4; ++c)
+		{
+			const auto delta = static_cast<unsigned>(abs(int{ a[i + c] } - int{ b[i + c] }));
+			differs |= delta > tolerance;
+			diff.maxDelta = max(diff.maxDelta, delta);
+			squared += delta * delta;
+		}
+		diff.differing += differs;
+	}
+
+	if (bytes)
+		diff.mse = static_cast<double>(squared) / static_cast<double>(bytes);
+
+	diff.psnr = diff.mse > 0.0 ? 10.0 * log10(255.0 * 255.0 / diff.mse) : numeric_limits<double>::infinity();
+
+	return diff;
+}
+
+} // common
\ No newline at end of file
@@ -0,0 +1,118 @@
+#include <indirect_draw.hpp>
+#include <numeric>
+#include <stdexcept>
+
+namespace glsl {
+
+using namespace std;
+
+namespace {
+
+	vector<GLuint> drawIndices(uint32_t count)
+	{
+		vector<GLuint> indices(count);
+		iota(begin(indices), end(indices), 0u);
+		return indices;
+	}
+}
+
+IndirectDrawBatch::IndirectDrawBatch(uint32_t maxDraws)
+	: mMaxDraws{ maxDraws }
+	, mCommandBuffer{ static_cast<GLsizeiptr>(maxDraws * sizeof(DrawElementsIndirectCommand)), nullptr, GL_DYNAMIC_STORAGE_BIT }
+	, mDrawDataBuffer{ static_cast<GLsizeiptr>(maxDraws * sizeof(DrawData)), nullptr, GL_DYNAMIC_STORAGE_BIT }
+	, mCountBuffer{ static_cast<GLsizeiptr>(sizeof(GLuint)), nullptr, GL_DYNAMIC_STORAGE_BIT }
+	, mDrawIndexBuffer{ drawIndices(maxDraws) }
+{
+	if (maxDraws == 0)
+		throw invalid_argument{ "IndirectDrawBatch needs room for at least one draw" };
+
+	mCommands.reserve(maxDraws);
+	mDrawData.reserve(maxDraws);
+}
+
+void IndirectDrawBatch::clear() noexcept
+{
+	mCommands.clear();
+	mDrawData.clear();
+}
+
+uint32_t IndirectDrawBatch::add(const MeshRange& mesh, const glm::mat4& model)
+{
+	if (mCommands.empty())
+		mPage = mesh.page;
+	else if (mesh.page != mPage)
+		throw invalid_argument{ "IndirectDrawBatch mixes GeometryArena pages" };
+
+	const DrawElementsIndirectCommand command{ static_cast<GLuint>(mesh.indexCount), 1, mesh.firstIndex, mesh.baseVertex, 0 };
+	return add(command, DrawData{ model });
+}
+
+uint32_t IndirectDrawBatch::add(DrawElementsIndirectCommand command, const DrawData& data)
+{
+	if (mCommands.size() == mMaxDraws)
+		throw length_error{ "IndirectDrawBatch is full" };
+
+	const auto index = static_cast<uint32_t>(mCommands.size());
+	command.baseInstance = index;
+	mCommands.push_back(command);
+	mDrawData.push_back(data);
+	return index;
+}
+
+void IndirectDrawBatch::upload()
+{
+	mUploaded = size();
+	if (mUploaded == 0)
+		return;
+
+	mCommandBuffer.subData(0, static_cast<GLsizeiptr>(mUploaded * sizeof(DrawElementsIndirectCommand)), mCommands.data());
+	mDrawDataBuffer.subData(0, static_cast<GLsizeiptr>(mUploaded * sizeof(DrawData)), mDrawData.data());
+	mCountBuffer.subData(0, sizeof(GLuint), &mUploaded);
+	mUploadedPage = mPage;
+}
+
+void IndirectDrawBatch::submit(const GeometryArena& arena, GLenum mode, GLuint dataBinding) const
+{
+	if (mUploaded == 0)
+		return;
+
+	submit(arena.vertexArray(mUploadedPage), mode, dataBinding);
+}
+
+void IndirectDrawBatch::submit(const VertexArray& vao, GLenum mode, GLuint dataBinding) const
+{
+	if (mUploaded == 0)
+		return;
+
+	bindDrawIndex(vao);
+	vao.bind();
+	mDrawDataBuffer.bindBase(GL_SHADER_STORAGE_BUFFER, dataBinding);
+	mCommandBuffer.bind(GL_DRAW_INDIRECT_BUFFER);
+
+	if (mUseCount)
+	{
+		mCountBuffer.bind(GL_PARAMETER_BUFFER);
+		glMultiDrawElementsIndirectCount(mode, GL_UNSIGNED_INT, nullptr, 0, static_cast<GLsizei>(mMaxDraws), 0);
+	}
+	else
+	{
+		glMultiDrawElementsIndirect(mode, GL_UNSIGNED_INT, nullptr, static_cast<GLsizei>(mUploaded), 0);
+	}
+}
+
+void IndirectDrawBatch::bindDrawIndex(const VertexArray& vao) const
+{
+	// set every time: the arena's VAOs are shared by all the batches drawing from them
+	glVertexArrayVertexBuffer(vao, draw_index_binding, mDrawIndexBuffer, 0, sizeof(GLuint));
+	glVertexArrayBindingDivisor(vao, draw_index_binding, 1);
+	glVertexArrayAttribIFormat(vao, draw_index_location, 1, GL_UNSIGNED_INT, 0);
+	glVertexArrayAttribBinding(vao, draw_index_location, draw_index_binding);
+	glEnableVertexArrayAttrib(vao, draw_index_location);
+}
+
+bool IndirectDrawBatch::indirectCountSupported() noexcept
+{
+	return glMultiDrawElementsIndirectCount != nullptr;
+}
+
+} // glsl
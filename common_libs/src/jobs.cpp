@@ -0,0 +1,360 @@
+#include <jobs.hpp>
+#include <cpu_profiler.hpp>
+
+namespace common {
+
+using namespace std;
+
+namespace {
+
+	constexpr size_t deque_capacity = 4096;
+	constexpr unsigned not_a_worker = ~0u;
+
+	thread_local JobSystem* tlsSystem = nullptr;
+	thread_local unsigned tlsIndex = not_a_worker;
+}
+
+JobSystem::Deque::Deque(size_t capacity)
+	: mMask{ static_cast<int64_t>(capacity - 1) }
+	, mBuffer{ new atomic<Job*>[capacity] }
+{
+}
+
+bool JobSystem::Deque::push(Job* job) noexcept
+{
+	const auto b = mBottom.load(memory_order_relaxed);
+	const auto t = mTop.load(memory_order_acquire);
+
+	if (b - t > mMask)
+		return false;
+
+	// releasing the bottom publishes the job to thieves; pooled jobs are
+	// reused, so what they see has to be this job's contents
+	mBuffer[b & mMask].store(job, memory_order_relaxed);
+	mBottom.store(b + 1, memory_order_release);
+	return true;
+}
+
+Job* JobSystem::Deque::pop() noexcept
+{
+	const auto b = mBottom.load(memory_order_relaxed) - 1;
+	mBottom.store(b, memory_order_relaxed);
+	atomic_thread_fence(memory_order_seq_cst);
+	auto t = mTop.load(memory_order_relaxed);
+
+	if (t > b)
+	{
+		mBottom.store(b + 1, memory_order_relaxed);
+		return nullptr;
+	}
+
+	auto job = mBuffer[b & mMask].load(memory_order_relaxed);
+	if (t == b)
+	{
+		// last item, race the thieves for it
+		if (!mTop.compare_exchange_strong(t, t + 1, memory_order_seq_cst, memory_order_relaxed))
+			job = nullptr;
+
+		mBottom.store(b + 1, memory_order_relaxed);
+	}
+
+	return job;
+}
+
+Job* JobSystem::Deque::steal() noexcept
+{
+	auto t = mTop.load(memory_order_acquire);
+	atomic_thread_fence(memory_order_seq_cst);
+	const auto b = mBottom.load(memory_order_acquire);
+
+	if (t >= b)
+		return nullptr;
+
+	auto job = mBuffer[t & mMask].load(memory_order_relaxed);
+	if (!mTop.compare_exchange_strong(t, t + 1, memory_order_seq_cst, memory_order_relaxed))
+		return nullptr;
+
+	return job;
+}
+
+JobSystem::JobSystem(unsigned threadCount)
+{
+	if (threadCount == 0)
+		threadCount = max(1u, thread::hardware_concurrency());
+
+	for (unsigned i = 0; i < threadCount; ++i)
+		mQueues.push_back(make_unique<Deque>(deque_capacity));
+
+	mPool = make_unique<Job[]>(job_pool_size);
+	for (size_t i = 0; i < job_pool_size; ++i)
+	{
+		mPool[i].pooled = true;
+		mPool[i].next.store(i + 1 < job_pool_size ? &mPool[i + 1] : nullptr, memory_order_relaxed);
+	}
+	mFree.store(1, memory_order_relaxed);
+
+	tlsSystem = this;
+	tlsIndex = 0;
+
+	for (unsigned i = 1; i < threadCount; ++i)
+		mThreads.emplace_back(&JobSystem::workerLoop, this, i);
+}
+
+JobSystem::~JobSystem()
+{
+	mStop = true;
+	{
+		lock_guard<mutex> lock{ mSleepMutex };
+	}
+	mWake.notify_all();
+
+	for (auto& t : mThreads)
+		t.join();
+
+	// jobs nobody got to are dropped, their counters never reach zero
+	auto drop = [this](Job* job)
+	{
+		job->destroy(job->storage);
+		release(job);
+	};
+
+	for (auto& queue : mQueues)
+	{
+		while (auto job = queue->steal())
+			drop(job);
+	}
+
+	for (auto job : mShared)
+		drop(job);
+
+	// so are continuations whose counter never reached zero
+	while (mParked)
+	{
+		const auto job = mParked;
+		mParked = job->parkedNext;
+		drop(job);
+	}
+
+	if (tlsSystem == this)
+	{
+		tlsSystem = nullptr;
+		tlsIndex = not_a_worker;
+	}
+}
+
+Job* JobSystem::acquire()
+{
+	auto head = mFree.load(memory_order_acquire);
+	while (const auto index = static_cast<uint32_t>(head))
+	{
+		auto job = &mPool[index - 1];
+		const auto next = job->next.load(memory_order_relaxed);
+		const auto nextIndex = next ? static_cast<uint64_t>(next - mPool.get()) + 1 : 0;
+
+		// the tag makes the exchange fail if the job was taken and given back meanwhile
+		if (mFree.compare_exchange_weak(head, ((head >> 32) + 1) << 32 | nextIndex, memory_order_acquire, memory_order_acquire))
+			return job;
+	}
+
+	// every pooled job is in flight
+	return new Job;
+}
+
+void JobSystem::release(Job* job) noexcept
+{
+	if (!job->pooled)
+	{
+		delete job;
+		return;
+	}
+
+	const auto index = static_cast<uint64_t>(job - mPool.get()) + 1;
+	auto head = mFree.load(memory_order_relaxed);
+	do
+	{
+		const auto top = static_cast<uint32_t>(head);
+		job->next.store(top ? &mPool[top - 1] : nullptr, memory_order_relaxed);
+	}
+	while (!mFree.compare_exchange_weak(head, ((head >> 32) + 1) << 32 | index, memory_order_release, memory_order_relaxed));
+}
+
+void JobSystem::runAfter(JobCounter& dependency, Job* job)
+{
+	{
+		lock_guard<mutex> lock{ dependency.mMutex };
+		if (dependency.mValue.load(memory_order_acquire) > 0)
+		{
+			job->next.store(dependency.mContinuations, memory_order_relaxed);
+			dependency.mContinuations = job;
+			park(job);
+			return;
+		}
+	}
+
+	submit(job);
+}
+
+void JobSystem::park(Job* job) noexcept
+{
+	lock_guard<mutex> lock{ mParkedMutex };
+	job->parkedPrev = nullptr;
+	job->parkedNext = mParked;
+	if (mParked)
+		mParked->parkedPrev = job;
+	mParked = job;
+}
+
+void JobSystem::unpark(Job* job) noexcept
+{
+	lock_guard<mutex> lock{ mParkedMutex };
+	if (job->parkedPrev)
+		job->parkedPrev->parkedNext = job->parkedNext;
+	else
+		mParked = job->parkedNext;
+
+	if (job->parkedNext)
+		job->parkedNext->parkedPrev = job->parkedPrev;
+}
+
+unsigned JobSystem::workerIndex() const noexcept
+{
+	return tlsSystem == this ? tlsIndex : threadCount();
+}
+
+void JobSystem::wait(JobCounter& counter)
+{
+	const auto self = tlsSystem == this ? tlsIndex : not_a_worker;
+
+	while (!counter.done())
+	{
+		if (auto job = findJob(self))
+			execute(job);
+		else
+			this_thread::yield();
+	}
+
+	// the last job may still be inside the counter's critical section, make
+	// sure it has left before the caller is free to destroy the counter
+	lock_guard<mutex> lock{ counter.mMutex };
+}
+
+void JobSystem::submit(Job* job)
+{
+	if (tlsSystem == this)
+	{
+		if (!mQueues[tlsIndex]->push(job))
+		{
+			// deque is full, running inline is cheaper than growing it
+			execute(job);
+			return;
+		}
+	}
+	else
+	{
+		lock_guard<mutex> lock{ mSharedMutex };
+		mShared.push_back(job);
+	}
+
+	mQueued.fetch_add(1, memory_order_release);
+	{
+		lock_guard<mutex> lock{ mSleepMutex };
+	}
+	mWake.notify_one();
+}
+
+void JobSystem::execute(Job* job)
+{
+	{
+		COMMON_PROFILE_SCOPE("job");
+		job->run(job->storage);
+	}
+
+	const auto counter = job->counter;
+	release(job);
+
+	if (counter)
+	{
+		// only the job that takes the counter to zero needs the lock
+		auto value = counter->mValue.load(memory_order_relaxed);
+		while (value > 1)
+		{
+			if (counter->mValue.compare_exchange_weak(value, value - 1, memory_order_acq_rel, memory_order_relaxed))
+				break;
+		}
+
+		if (value <= 1)
+		{
+			Job* ready = nullptr;
+			{
+				lock_guard<mutex> lock{ counter->mMutex };
+				if (counter->mValue.fetch_sub(1, memory_order_acq_rel) == 1)
+					swap(ready, counter->mContinuations);
+			}
+
+			while (ready)
+			{
+				// submit may run the job inline and hand it back to the pool
+				const auto next = ready->next.load(memory_order_relaxed);
+				unpark(ready);
+				submit(ready);
+				ready = next;
+			}
+		}
+	}
+}
+
+Job* JobSystem::findJob(unsigned self)
+{
+	Job* job = nullptr;
+
+	if (self != not_a_worker)
+		job = mQueues[self]->pop();
+
+	if (!job && mQueued.load(memory_order_acquire) > 0)
+	{
+		unique_lock<mutex> lock{ mSharedMutex, try_to_lock };
+		if (lock && !mShared.empty())
+		{
+			job = mShared.back();
+			mShared.pop_back();
+		}
+	}
+
+	const auto count = static_cast<unsigned>(mQueues.size());
+	const auto start = self != not_a_worker ? self + 1 : 0;
+	for (unsigned i = 0; !job && i < count; ++i)
+	{
+		const auto victim = (start + i) % count;
+		if (victim != self)
+			job = mQueues[victim]->steal();
+	}
+
+	if (job)
+		mQueued.fetch_sub(1, memory_order_relaxed);
+
+	return job;
+}
+
+void JobSystem::workerLoop(unsigned index)
+{
+	tlsSystem = this;
+	tlsIndex = index;
+	COMMON_PROFILE_THREAD("worker");
+
+	while (!mStop.load(memory_order_acquire))
+	{
+		if (auto job = findJob(index))
+		{
+			execute(job);
+			continue;
+		}
+
+		unique_lock<mutex> lock{ mSleepMutex };
+		mWake.wait(lock, [this]
+		{
+			return mStop.load(memory_order_acquire) || mQueued.load(memory_order_acquire) > 0;
+		});
+	}
+}
+
+} // common
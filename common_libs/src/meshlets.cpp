@@ -0,0 +1,173 @@
+#include <meshlets.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+namespace common {
+
+using namespace std;
+
+namespace {
+
+	glm::vec3 positionAt(const void* positions, size_t stride, uint32_t index) noexcept
+	{
+		glm::vec3 p;
+		memcpy(&p, static_cast<const unsigned char*>(positions) + index * stride, sizeof(p));
+		return p;
+	}
+
+	void computeBounds(Meshlet& meshlet, const void* positions, size_t stride, const uint32_t* indices)
+	{
+		const auto first = indices + meshlet.firstIndex;
+		const auto count = meshlet.triangleCount * 3;
+
+		auto lo = glm::vec3{ numeric_limits<float>::max() };
+		auto hi = -lo;
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			const auto p = positionAt(positions, stride, first[i]);
+			lo = glm::min(lo, p);
+			hi = glm::max(hi, p);
+		}
+
+		meshlet.center = (lo + hi) * 0.5f;
+		meshlet.radius = 0.0f;
+		for (uint32_t i = 0; i < count; ++i)
+			meshlet.radius = max(meshlet.radius, glm::length(positionAt(positions, stride, first[i]) - meshlet.center));
+
+		vector<glm::vec3> normals;
+		normals.reserve(meshlet.triangleCount);
+		auto sum = glm::vec3{ 0.0f };
+		for (uint32_t t = 0; t < count; t += 3)
+		{
+			const auto a = positionAt(positions, stride, first[t]);
+			const auto b = positionAt(positions, stride, first[t + 1]);
+			const auto c = positionAt(positions, stride, first[t + 2]);
+			const auto n = glm::cross(b - a, c - a);
+			const auto length = glm::length(n);
+
+			// degenerate triangles have no facing
+			if (length > 0.0f)
+			{
+				normals.push_back(n / length);
+				sum += normals.back();
+			}
+		}
+
+		meshlet.coneAxis = glm::vec3{ 0.0f, 0.0f, 1.0f };
+		meshlet.coneCutoff = 1.0f;
+
+		const auto sumLength = glm::length(sum);
+		if (normals.empty() || sumLength <= 0.0f)
+			return;
+
+		const auto axis = sum / sumLength;
+		auto minDot = 1.0f;
+		for (const auto& n : normals)
+			minDot = min(minDot, glm::dot(n, axis));
+
+		// past ~84 degrees of spread the cone rejects nearly nothing
+		if (minDot <= 0.1f)
+			return;
+
+		meshlet.coneAxis = axis;
+		meshlet.coneCutoff = sqrt(1.0f - minDot * minDot);
+	}
+}
+
+MeshletMesh buildMeshlets(const void* positions, size_t stride, size_t vertexCount,
+	const uint32_t* indices, size_t indexCount, const MeshletLimits& limits)
+{
+	if (limits.maxVertices < 3 || limits.maxTriangles < 1)
+		throw invalid_argument{ "MeshletLimits must allow at least one triangle" };
+
+	if (indexCount % 3 != 0)
+		throw invalid_argument{ "buildMeshlets expects a triangle list" };
+
+	MeshletMesh mesh;
+	mesh.indices.reserve(indexCount);
+
+	// the meshlet each vertex was last added to, to count a meshlet's unique vertices
+	const auto none = ~uint32_t{ 0 };
+	vector<uint32_t> owner(vertexCount, none);
+
+	Meshlet current{};
+	auto finish = [&]
+	{
+		if (current.triangleCount == 0)
+			return;
+
+		computeBounds(current, positions, stride, mesh.indices.data());
+		mesh.meshlets.push_back(current);
+
+		current = Meshlet{};
+		current.firstIndex = static_cast<uint32_t>(mesh.indices.size());
+	};
+
+	for (size_t t = 0; t < indexCount; t += 3)
+	{
+		const uint32_t tri[3] = { indices[t], indices[t + 1], indices[t + 2] };
+		for (auto v : tri)
+		{
+			if (v >= vertexCount)
+				throw out_of_range{ "buildMeshlets index past the vertex count" };
+		}
+
+		const auto id = static_cast<uint32_t>(mesh.meshlets.size());
+		auto fresh = 0u;
+		for (int i = 0; i < 3; ++i)
+		{
+			const auto repeated = (i > 0 && tri[i] == tri[0]) || (i > 1 && tri[i] == tri[1]);
+			if (owner[tri[i]] != id && !repeated)
+				++fresh;
+		}
+
+		if (current.vertexCount + fresh > limits.maxVertices || current.triangleCount + 1 > limits.maxTriangles)
+		{
+			finish();
+			fresh = 0;
+			for (int i = 0; i < 3; ++i)
+			{
+				const auto repeated = (i > 0 && tri[i] == tri[0]) || (i > 1 && tri[i] == tri[1]);
+				if (!repeated)
+					++fresh;
+			}
+		}
+
+		const auto owned = static_cast<uint32_t>(mesh.meshlets.size());
+		for (auto v : tri)
+			owner[v] = owned;
+
+		mesh.indices.insert(mesh.indices.end(), begin(tri), end(tri));
+		current.vertexCount += fresh;
+		++current.triangleCount;
+	}
+
+	finish();
+	return mesh;
+}
+
+MeshletVisibility cullMeshlet(const Meshlet& meshlet, const glm::mat4& model, const glm::vec3& eye, const Frustum& frustum) noexcept
+{
+	const auto scale = max(glm::length(glm::vec3{ model[0] }), max(glm::length(glm::vec3{ model[1] }), glm::length(glm::vec3{ model[2] })));
+	const auto center = glm::vec3{ model * glm::vec4{ meshlet.center, 1.0f } };
+	const auto radius = meshlet.radius * scale;
+
+	if (!frustum.intersects(center, radius))
+		return MeshletVisibility::outside;
+
+	if (meshlet.coneCutoff < 1.0f)
+	{
+		const auto axis = glm::normalize(glm::mat3{ model } * meshlet.coneAxis);
+		const auto toCenter = center - eye;
+
+		if (glm::dot(toCenter, axis) >= meshlet.coneCutoff * glm::length(toCenter) + radius)
+			return MeshletVisibility::backfacing;
+	}
+
+	return MeshletVisibility::visible;
+}
+
+} // common
@@ -0,0 +1,341 @@
+#include <occlusion.hpp>
+#include <jobs.hpp>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define OCCLUSION_USE_SSE2
+#endif
+
+namespace common {
+
+using namespace std;
+
+namespace {
+
+	constexpr float min_w = 1e-5f;
+	constexpr size_t min_parallel_triangles = 128;
+
+	int roundUp(int value, int multiple) noexcept
+	{
+		return (value + multiple - 1) / multiple * multiple;
+	}
+
+	// Converting a float outside the range of int is undefined, so clamp
+	// first; NaN goes to lo.
+	int clampToInt(float value, int lo, int hi) noexcept
+	{
+		if (value >= static_cast<float>(hi))
+			return hi;
+
+		return value > static_cast<float>(lo) ? static_cast<int>(value) : lo;
+	}
+}
+
+OcclusionCuller::OcclusionCuller(int width, int height, JobSystem* jobs)
+	: mWidth{ roundUp(width, tile_width) }
+	, mHeight{ roundUp(height, tile_height) }
+	, mTilesX{ mWidth / tile_width }
+	, mTilesY{ mHeight / tile_height }
+	, mJobs{ jobs }
+	, mViewProjection{ 1.0f }
+	, mBins(static_cast<size_t>(mTilesX * mTilesY))
+{
+	if (width <= 0 || height <= 0)
+		throw invalid_argument{ "OcclusionCuller resolution must be positive" };
+
+	auto w = mWidth, h = mHeight;
+	for (;;)
+	{
+		mLevels.push_back({ w, h, vector<float>(static_cast<size_t>(w * h), 1.0f) });
+		if (w == 1 && h == 1)
+			break;
+
+		w = max(1, (w + 1) / 2);
+		h = max(1, (h + 1) / 2);
+	}
+}
+
+void OcclusionCuller::beginFrame(const glm::mat4& viewProjection)
+{
+	mViewProjection = viewProjection;
+	mTriangles.clear();
+
+	for (auto& bin : mBins)
+		bin.clear();
+
+	for (auto& level : mLevels)
+		fill(begin(level.depth), end(level.depth), 1.0f);
+}
+
+void OcclusionCuller::addOccluder(const glm::vec3* vertices, size_t vertexCount,
+	const uint32_t* indices, size_t indexCount,
+	const glm::mat4& model)
+{
+	const auto mvp = mViewProjection * model;
+
+	for (size_t i = 0; i + 2 < indexCount; i += 3)
+	{
+		Triangle tri;
+		auto keep = true;
+
+		for (int v = 0; v < 3 && keep; ++v)
+		{
+			const auto index = indices[i + v];
+			if (index >= vertexCount)
+				throw out_of_range{ "occluder index out of range" };
+
+			const auto clip = mvp * glm::vec4{ vertices[index], 1.0f };
+
+			// dropping an occluder triangle is always safe, clipping it is not worth it
+			if (!(clip.w >= min_w) || !(clip.z >= -clip.w))
+			{
+				keep = false;
+				break;
+			}
+
+			const auto invW = 1.0f / clip.w;
+			tri.x[v] = (clip.x * invW * 0.5f + 0.5f) * mWidth;
+			tri.y[v] = (clip.y * invW * 0.5f + 0.5f) * mHeight;
+			tri.z[v] = clip.z * invW * 0.5f + 0.5f;
+
+			// a w just above min_w can still push x or y past the float range
+			if (!isfinite(tri.x[v]) || !isfinite(tri.y[v]) || !isfinite(tri.z[v]))
+				keep = false;
+		}
+
+		if (keep)
+			mTriangles.push_back(tri);
+	}
+}
+
+void OcclusionCuller::rasterize()
+{
+	for (uint32_t i = 0; i < mTriangles.size(); ++i)
+	{
+		const auto& tri = mTriangles[i];
+		const auto minX = min({ tri.x[0], tri.x[1], tri.x[2] });
+		const auto maxX = max({ tri.x[0], tri.x[1], tri.x[2] });
+		const auto minY = min({ tri.y[0], tri.y[1], tri.y[2] });
+		const auto maxY = max({ tri.y[0], tri.y[1], tri.y[2] });
+
+		if (maxX < 0.0f || maxY < 0.0f || minX >= mWidth || minY >= mHeight)
+			continue;
+
+		const auto tx0 = clampToInt(minX, 0, mWidth - 1) / tile_width;
+		const auto tx1 = clampToInt(maxX, 0, mWidth - 1) / tile_width;
+		const auto ty0 = clampToInt(minY, 0, mHeight - 1) / tile_height;
+		const auto ty1 = clampToInt(maxY, 0, mHeight - 1) / tile_height;
+
+		for (auto ty = ty0; ty <= ty1; ++ty)
+			for (auto tx = tx0; tx <= tx1; ++tx)
+				mBins[ty * mTilesX + tx].push_back(i);
+	}
+
+	// tiles own disjoint pixels, so the jobs never touch the same memory
+	auto rasterizeTiles = [this](size_t first, size_t last)
+	{
+		for (auto tile = first; tile < last; ++tile)
+			rasterizeTile(tile);
+	};
+
+	if (mJobs && mTriangles.size() >= min_parallel_triangles)
+		mJobs->parallelFor(0, mBins.size(), 1, rasterizeTiles);
+	else
+		rasterizeTiles(0, mBins.size());
+
+	buildPyramid();
+}
+
+bool OcclusionCuller::isVisible(const Aabb& bounds) const
+{
+	auto lo = glm::vec3{ 1.0f };
+	auto hi = glm::vec3{ -1.0f };
+	auto behind = 0;
+
+	for (int i = 0; i < 8; ++i)
+	{
+		const glm::vec4 corner{
+			(i & 1) ? bounds.max.x : bounds.min.x,
+			(i & 2) ? bounds.max.y : bounds.min.y,
+			(i & 4) ? bounds.max.z : bounds.min.z,
+			1.0f
+		};
+
+		const auto clip = mViewProjection * corner;
+
+		if (clip.w < min_w)
+		{
+			++behind;
+			continue;
+		}
+
+		const auto ndc = glm::vec3{ clip } / clip.w;
+		if (i == behind)
+		{
+			lo = ndc;
+			hi = ndc;
+		}
+		else
+		{
+			lo = glm::min(lo, ndc);
+			hi = glm::max(hi, ndc);
+		}
+	}
+
+	// entirely behind the eye, or crossing the near plane where there is
+	// nothing sensible to compare against
+	if (behind == 8)
+		return false;
+
+	if (behind > 0)
+		return true;
+
+	if (hi.x < -1.0f || hi.y < -1.0f || lo.x > 1.0f || lo.y > 1.0f || lo.z > 1.0f)
+		return false;
+
+	if (lo.z < -1.0f)
+		return true;
+
+	const auto nearest = lo.z * 0.5f + 0.5f;
+
+	const auto x0 = clampToInt((lo.x * 0.5f + 0.5f) * mWidth, 0, mWidth - 1);
+	const auto x1 = clampToInt((hi.x * 0.5f + 0.5f) * mWidth, 0, mWidth - 1);
+	const auto y0 = clampToInt((lo.y * 0.5f + 0.5f) * mHeight, 0, mHeight - 1);
+	const auto y1 = clampToInt((hi.y * 0.5f + 0.5f) * mHeight, 0, mHeight - 1);
+
+	// coarsest level at which the rectangle spans at most 2x2 texels
+	size_t level = 0;
+	while (level + 1 < mLevels.size() && max((x1 >> level) - (x0 >> level), (y1 >> level) - (y0 >> level)) > 1)
+		++level;
+
+	const auto& l = mLevels[level];
+	for (auto y = y0 >> level; y <= (y1 >> level); ++y)
+		for (auto x = x0 >> level; x <= (x1 >> level); ++x)
+			if (l.depth[y * l.width + x] >= nearest)
+				return true;
+
+	return false;
+}
+
+void OcclusionCuller::rasterizeTile(size_t tile)
+{
+	const auto tileX = static_cast<int>(tile % mTilesX) * tile_width;
+	const auto tileY = static_cast<int>(tile / mTilesX) * tile_height;
+	auto depth = mLevels[0].depth.data();
+
+	for (auto index : mBins[tile])
+	{
+		auto tri = mTriangles[index];
+
+		auto area = (tri.x[1] - tri.x[0]) * (tri.y[2] - tri.y[0]) - (tri.x[2] - tri.x[0]) * (tri.y[1] - tri.y[0]);
+		if (area < 0.0f)
+		{
+			swap(tri.x[1], tri.x[2]);
+			swap(tri.y[1], tri.y[2]);
+			swap(tri.z[1], tri.z[2]);
+			area = -area;
+		}
+
+		if (area < 1e-6f)
+			continue;
+
+		// edge functions E(p) = a * x + b * y + c, non-negative inside
+		float ea[3], eb[3], ec[3];
+		for (int e = 0; e < 3; ++e)
+		{
+			const auto n = (e + 1) % 3;
+			ea[e] = tri.y[e] - tri.y[n];
+			eb[e] = tri.x[n] - tri.x[e];
+			ec[e] = -(ea[e] * tri.x[e] + eb[e] * tri.y[e]);
+		}
+
+		// NDC z is affine in screen space
+		const auto dzdx = ((tri.z[1] - tri.z[0]) * (tri.y[2] - tri.y[0]) - (tri.z[2] - tri.z[0]) * (tri.y[1] - tri.y[0])) / area;
+		const auto dzdy = ((tri.z[2] - tri.z[0]) * (tri.x[1] - tri.x[0]) - (tri.z[1] - tri.z[0]) * (tri.x[2] - tri.x[0])) / area;
+		const auto z0 = tri.z[0] - dzdx * tri.x[0] - dzdy * tri.y[0];
+
+		const auto minX = clampToInt(floor(min({ tri.x[0], tri.x[1], tri.x[2] })), tileX, tileX + tile_width) & ~3;
+		const auto maxX = clampToInt(ceil(max({ tri.x[0], tri.x[1], tri.x[2] })), tileX - 1, tileX + tile_width - 1);
+		const auto minY = clampToInt(floor(min({ tri.y[0], tri.y[1], tri.y[2] })), tileY, tileY + tile_height);
+		const auto maxY = clampToInt(ceil(max({ tri.y[0], tri.y[1], tri.y[2] })), tileY - 1, tileY + tile_height - 1);
+
+		for (auto y = minY; y <= maxY; ++y)
+		{
+			const auto py = y + 0.5f;
+			auto row = depth + y * mWidth;
+
+#if defined(OCCLUSION_USE_SSE2)
+			const auto offsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+			const auto zero = _mm_setzero_ps();
+			const auto rowE0 = _mm_set1_ps(eb[0] * py + ec[0]);
+			const auto rowE1 = _mm_set1_ps(eb[1] * py + ec[1]);
+			const auto rowE2 = _mm_set1_ps(eb[2] * py + ec[2]);
+			const auto rowZ = _mm_set1_ps(dzdy * py + z0);
+			const auto a0 = _mm_set1_ps(ea[0]);
+			const auto a1 = _mm_set1_ps(ea[1]);
+			const auto a2 = _mm_set1_ps(ea[2]);
+			const auto dz = _mm_set1_ps(dzdx);
+
+			for (auto x = minX; x <= maxX; x += 4)
+			{
+				const auto px = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), offsets);
+
+				const auto inside = _mm_and_ps(
+					_mm_and_ps(
+						_mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(a0, px), rowE0), zero),
+						_mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(a1, px), rowE1), zero)),
+					_mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(a2, px), rowE2), zero));
+
+				if (_mm_movemask_ps(inside) == 0)
+					continue;
+
+				const auto z = _mm_add_ps(_mm_mul_ps(dz, px), rowZ);
+				const auto old = _mm_loadu_ps(row + x);
+				const auto closer = _mm_min_ps(old, z);
+				_mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, closer), _mm_andnot_ps(inside, old)));
+			}
+#else
+			for (auto x = minX; x <= maxX; ++x)
+			{
+				const auto px = x + 0.5f;
+				if (ea[0] * px + eb[0] * py + ec[0] < 0.0f
+					|| ea[1] * px + eb[1] * py + ec[1] < 0.0f
+					|| ea[2] * px + eb[2] * py + ec[2] < 0.0f)
+					continue;
+
+				row[x] = min(row[x], dzdx * px + dzdy * py + z0);
+			}
+#endif
+		}
+	}
+}
+
+void OcclusionCuller::buildPyramid()
+{
+	for (size_t i = 1; i < mLevels.size(); ++i)
+	{
+		const auto& src = mLevels[i - 1];
+		auto& dst = mLevels[i];
+
+		for (auto y = 0; y < dst.height; ++y)
+		{
+			const auto sy0 = min(2 * y, src.height - 1);
+			const auto sy1 = min(2 * y + 1, src.height - 1);
+
+			for (auto x = 0; x < dst.width; ++x)
+			{
+				const auto sx0 = min(2 * x, src.width - 1);
+				const auto sx1 = min(2 * x + 1, src.width - 1);
+
+				dst.depth[y * dst.width + x] = max(
+					max(src.depth[sy0 * src.width + sx0], src.depth[sy0 * src.width + sx1]),
+					max(src.depth[sy1 * src.width + sx0], src.depth[sy1 * src.width + sx1]));
+			}
+		}
+	}
+}
+
+} // common
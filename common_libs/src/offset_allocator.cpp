@@ -0,0 +1,200 @@
+#include <offset_allocator.hpp>
+#include <algorithm>
+#include <stdexcept>
+
+namespace common {
+
+using namespace std;
+
+namespace {
+
+	uint32_t floorLog2(uint32_t v) noexcept
+	{
+		uint32_t r = 0;
+		while (v >>= 1)
+			++r;
+		return r;
+	}
+
+	uint32_t lowestBit(uint32_t v) noexcept
+	{
+		uint32_t r = 0;
+		while (!(v & 1u))
+		{
+			v >>= 1;
+			++r;
+		}
+		return r;
+	}
+}
+
+OffsetAllocator::OffsetAllocator(uint32_t capacity)
+	: mCapacity{ capacity }
+{
+	if (capacity == 0)
+		throw invalid_argument{ "OffsetAllocator capacity must be positive" };
+
+	fill(begin(mBuckets), end(mBuckets), invalid);
+	insertFree(newNode(0, capacity, invalid, invalid));
+}
+
+OffsetAllocator::Allocation OffsetAllocator::allocate(uint32_t size)
+{
+	if (size == 0)
+		return {};
+
+	// every block in a bucket above floor(log2(size)) is large enough; the
+	// bucket of size itself only may be, so it is scanned as a last resort
+	const auto exact = floorLog2(size);
+	const auto start = (size & (size - 1)) == 0 ? exact : exact + 1;
+
+	auto node = invalid;
+	const auto candidates = start < bucket_count ? mBucketMask & (~0u << start) : 0u;
+	if (candidates)
+	{
+		node = mBuckets[lowestBit(candidates)];
+	}
+	else if (start != exact)
+	{
+		for (auto n = mBuckets[exact]; n != invalid; n = mNodes[n].binNext)
+		{
+			if (mNodes[n].size >= size)
+			{
+				node = n;
+				break;
+			}
+		}
+	}
+
+	if (node == invalid)
+		return {};
+
+	removeFree(node);
+
+	const auto remainder = mNodes[node].size - size;
+	if (remainder > 0)
+	{
+		const auto next = mNodes[node].next;
+		const auto split = newNode(mNodes[node].offset + size, remainder, node, next);
+		if (next != invalid)
+			mNodes[next].prev = split;
+		mNodes[node].next = split;
+		mNodes[node].size = size;
+		insertFree(split);
+	}
+
+	mNodes[node].used = true;
+	mUsed += size;
+	++mAllocations;
+
+	return { mNodes[node].offset, node };
+}
+
+void OffsetAllocator::free(const Allocation& allocation)
+{
+	if (!allocation)
+		return;
+
+	auto node = allocation.node;
+	if (node >= mNodes.size() || !mNodes[node].used)
+		throw invalid_argument{ "OffsetAllocator::free of an unknown allocation" };
+
+	mNodes[node].used = false;
+	mUsed -= mNodes[node].size;
+	--mAllocations;
+
+	const auto prev = mNodes[node].prev;
+	if (prev != invalid && !mNodes[prev].used)
+	{
+		// fold this block into the free one before it
+		removeFree(prev);
+		mNodes[prev].size += mNodes[node].size;
+		mNodes[prev].next = mNodes[node].next;
+		if (mNodes[node].next != invalid)
+			mNodes[mNodes[node].next].prev = prev;
+		mFreeNodes.push_back(node);
+		node = prev;
+	}
+
+	const auto next = mNodes[node].next;
+	if (next != invalid && !mNodes[next].used)
+	{
+		removeFree(next);
+		mNodes[node].size += mNodes[next].size;
+		mNodes[node].next = mNodes[next].next;
+		if (mNodes[next].next != invalid)
+			mNodes[mNodes[next].next].prev = node;
+		mFreeNodes.push_back(next);
+	}
+
+	insertFree(node);
+}
+
+OffsetAllocator::Stats OffsetAllocator::stats() const
+{
+	Stats s;
+	s.capacity = mCapacity;
+	s.used = mUsed;
+	s.free = mCapacity - mUsed;
+	s.allocations = mAllocations;
+
+	for (auto head : mBuckets)
+	{
+		for (auto n = head; n != invalid; n = mNodes[n].binNext)
+		{
+			++s.freeBlocks;
+			s.largestFree = max(s.largestFree, mNodes[n].size);
+		}
+	}
+
+	return s;
+}
+
+uint32_t OffsetAllocator::newNode(uint32_t offset, uint32_t size, uint32_t prev, uint32_t next)
+{
+	const Node node{ offset, size, prev, next, invalid, invalid, false };
+
+	if (mFreeNodes.empty())
+	{
+		mNodes.push_back(node);
+		return static_cast<uint32_t>(mNodes.size() - 1);
+	}
+
+	const auto index = mFreeNodes.back();
+	mFreeNodes.pop_back();
+	mNodes[index] = node;
+	return index;
+}
+
+void OffsetAllocator::insertFree(uint32_t node)
+{
+	const auto bucket = floorLog2(mNodes[node].size);
+	auto& n = mNodes[node];
+
+	n.binPrev = invalid;
+	n.binNext = mBuckets[bucket];
+	if (n.binNext != invalid)
+		mNodes[n.binNext].binPrev = node;
+
+	mBuckets[bucket] = node;
+	mBucketMask |= 1u << bucket;
+}
+
+void OffsetAllocator::removeFree(uint32_t node)
+{
+	const auto bucket = floorLog2(mNodes[node].size);
+	const auto& n = mNodes[node];
+
+	if (n.binPrev != invalid)
+		mNodes[n.binPrev].binNext = n.binNext;
+	else
+		mBuckets[bucket] = n.binNext;
+
+	if (n.binNext != invalid)
+		mNodes[n.binNext].binPrev = n.binPrev;
+
+	if (mBuckets[bucket] == invalid)
+		mBucketMask &= ~(1u << bucket);
+}
+
+} // common
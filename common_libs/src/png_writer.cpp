@@ -0,0 +1,341 @@
+#include <png_writer.hpp>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+namespace common {
+
+using namespace std;
+
+namespace {
+
+	constexpr size_t min_match = 3;
+	constexpr size_t max_match = 258;
+	constexpr size_t window_size = 32768;
+	constexpr size_t hash_bits = 15;
+
+	constexpr uint16_t length_base[29] = {
+		3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+		35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+	};
+
+	constexpr uint8_t length_extra[29] = {
+		0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+		3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+	};
+
+	constexpr uint16_t distance_base[30] = {
+		1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+		257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+	};
+
+	constexpr uint8_t distance_extra[30] = {
+		0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+		7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+	};
+
+	// deflate packs bits from the least significant end
+	class BitWriter {
+	public:
+		explicit BitWriter(vector<unsigned char>& out) noexcept
+			: mOut{ out }
+		{
+		}
+
+		void write(uint32_t bits, unsigned count)
+		{
+			mBits |= uint64_t{ bits } << mCount;
+			mCount += count;
+			for (; mCount >= 8; mCount -= 8, mBits >>= 8)
+				mOut.push_back(static_cast<unsigned char>(mBits));
+		}
+
+		// Huffman codes go most significant bit first
+		void writeCode(uint32_t code, unsigned length)
+		{
+			uint32_t reversed = 0;
+			for (unsigned i = 0; i < length; ++i)
+				reversed |= ((code >> i) & 1u) << (length - 1 - i);
+			write(reversed, length);
+		}
+
+		void flush()
+		{
+			if (mCount)
+				mOut.push_back(static_cast<unsigned char>(mBits));
+			mBits = 0;
+			mCount = 0;
+		}
+
+	private:
+		vector<unsigned char>& mOut;
+		uint64_t mBits = 0;
+		unsigned mCount = 0;
+	};
+
+	void writeSymbol(BitWriter& bits, unsigned symbol)
+	{
+		if (symbol < 144)
+			bits.writeCode(0x30 + symbol, 8);
+		else if (symbol < 256)
+			bits.writeCode(0x190 + symbol - 144, 9);
+		else if (symbol < 280)
+			bits.writeCode(symbol - 256, 7);
+		else
+			bits.writeCode(0xc0 + symbol - 280, 8);
+	}
+
+	void writeMatch(BitWriter& bits, size_t length, size_t distance)
+	{
+		const auto lengthCode = upper_bound(begin(length_base), end(length_base), length) - begin(length_base) - 1;
+		writeSymbol(bits, static_cast<unsigned>(257 + lengthCode));
+		bits.write(static_cast<uint32_t>(length - length_base[lengthCode]), length_extra[lengthCode]);
+
+		const auto distanceCode = upper_bound(begin(distance_base), end(distance_base), distance) - begin(distance_base) - 1;
+		bits.writeCode(static_cast<uint32_t>(distanceCode), 5);
+		bits.write(static_cast<uint32_t>(distance - distance_base[distanceCode]), distance_extra[distanceCode]);
+	}
+
+	size_t hash(const unsigned char* p) noexcept
+	{
+		const auto value = uint32_t{ p[0] } | uint32_t{ p[1] } << 8 | uint32_t{ p[2] } << 16;
+		return (value * 2654435761u) >> (32 - hash_bits);
+	}
+
+	uint32_t adler32(const vector<unsigned char>& data) noexcept
+	{
+		// 5552 bytes is the most that can be summed before b passes 32 bits
+		uint32_t a = 1, b = 0;
+		for (size_t i = 0; i < data.size();)
+		{
+			const auto end = min(data.size(), i + 5552);
+			for (; i < end; ++i)
+			{
+				a += data[i];
+				b += a;
+			}
+			a %= 65521;
+			b %= 65521;
+		}
+		return b << 16 | a;
+	}
+
+	// one block with the fixed codes; greedy matching on the latest position
+	// of each 3 byte hash finds the runs that filtered frames are made of
+	vector<unsigned char> zlibCompress(const vector<unsigned char>& data)
+	{
+		vector<unsigned char> out{ 0x78, 0x01 };
+		out.reserve(data.size() / 4 + 64);
+
+		BitWriter bits{ out };
+		bits.write(1, 1);
+		bits.write(1, 2);
+
+		vector<int64_t> head(size_t{ 1 } << hash_bits, -1);
+		const auto size = data.size();
+
+		for (size_t i = 0; i < size;)
+		{
+			size_t length = 0;
+			size_t distance = 0;
+
+			if (i + min_match <= size)
+			{
+				auto& slot = head[hash(&data[i])];
+				const auto candidate = slot;
+				slot = static_cast<int64_t>(i);
+
+				if (candidate >= 0 && i - static_cast<size_t>(candidate) <= window_size)
+				{
+					const auto from = static_cast<size_t>(candidate);
+					const auto limit = min(max_match, size - i);
+					while (length < limit && data[from + length] == data[i + length])
+						++length;
+
+					distance = i - from;
+				}
+			}
+
+			if (length >= min_match)
+			{
+				writeMatch(bits, length, distance);
+
+				for (size_t j = i + 1; j < i + length && j + min_match <= size; ++j)
+					head[hash(&data[j])] = static_cast<int64_t>(j);
+
+				i += length;
+			}
+			else
+			{
+				writeSymbol(bits, data[i]);
+				++i;
+			}
+		}
+
+		writeSymbol(bits, 256);
+		bits.flush();
+
+		const auto check = adler32(data);
+		for (int shift = 24; shift >= 0; shift -= 8)
+			out.push_back(static_cast<unsigned char>(check >> shift));
+
+		return out;
+	}
+
+	uint32_t crc32(uint32_t crc, const unsigned char* data, size_t size) noexcept
+	{
+		static const auto table = []
+		{
+			array<uint32_t, 256> entries{};
+			for (uint32_t n = 0; n < 256; ++n)
+			{
+				auto c = n;
+				for (int k = 0; k < 8; ++k)
+					c = c & 1 ? 0xedb88320u ^ (c >> 1) : c >> 1;
+				entries[n] = c;
+			}
+			return entries;
+		}();
+
+		crc = ~crc;
+		for (size_t i = 0; i < size; ++i)
+			crc = table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+		return ~crc;
+	}
+
+	void writeU32(ostream& out, uint32_t value)
+	{
+		const unsigned char bytes[4] = {
+			static_cast<unsigned char>(value >> 24), static_cast<unsigned char>(value >> 16),
+			static_cast<unsigned char>(value >> 8), static_cast<unsigned char>(value)
+		};
+		out.write(reinterpret_cast<const char*>(bytes), 4);
+	}
+
+	void writeChunk(ostream& out, const char* type, const vector<unsigned char>& data)
+	{
+		writeU32(out, static_cast<uint32_t>(data.size()));
+		out.write(type, 4);
+		out.write(reinterpret_cast<const char*>(data.data()), static_cast<streamsize>(data.size()));
+
+		auto crc = crc32(0, reinterpret_cast<const unsigned char*>(type), 4);
+		crc = crc32(crc, data.data(), data.size());
+		writeU32(out, crc);
+	}
+
+	unsigned char predict(int filter, int left, int up, int upLeft) noexcept
+	{
+		switch (filter)
+		{
+		case 1:
+			return static_cast<unsigned char>(left);
+
+		case 2:
+			return static_cast<unsigned char>(up);
+
+		case 3:
+			return static_cast<unsigned char>((left + up) / 2);
+
+		case 4:
+		{
+			const auto p = left + up - upLeft;
+			const auto pa = abs(p - left), pb = abs(p - up), pc = abs(p - upLeft);
+			return static_cast<unsigned char>(pa <= pb && pa <= pc ? left : pb <= pc ? up : upLeft);
+		}
+
+		default:
+			return 0;
+		}
+	}
+
+	// each row gets the filter whose output has the smallest sum of
+	// magnitudes, the usual heuristic
+	vector<unsigned char> filterRows(int width, int height, const unsigned char* rgba, bool bottomUp)
+	{
+		const auto stride = static_cast<size_t>(width) * 4;
+		vector<unsigned char> filtered;
+		filtered.reserve((stride + 1) * static_cast<size_t>(height));
+
+		vector<unsigned char> best(stride), candidate(stride);
+		const unsigned char* previous = nullptr;
+
+		for (int y = 0; y < height; ++y)
+		{
+			const auto row = rgba + stride * static_cast<size_t>(bottomUp ? height - 1 - y : y);
+
+			uint64_t bestCost = UINT64_MAX;
+			int bestFilter = 0;
+
+			for (int filter = 0; filter < 5; ++filter)
+			{
+				uint64_t cost = 0;
+				for (size_t x = 0; x < stride; ++x)
+				{
+					const int left = x >= 4 ? row[x - 4] : 0;
+					const int up = previous ? previous[x] : 0;
+					const int upLeft = previous && x >= 4 ? previous[x - 4] : 0;
+
+					candidate[x] = static_cast<unsigned char>(row[x] - predict(filter, left, up, upLeft));
+					cost += static_cast<uint64_t>(abs(static_cast<int>(static_cast<signed char>(candidate[x]))));
+				}
+
+				if (cost < bestCost)
+				{
+					bestCost = cost;
+					bestFilter = filter;
+					best.swap(candidate);
+				}
+			}
+
+			filtered.push_back(static_cast<unsigned char>(bestFilter));
+			filtered.insert(filtered.end(), best.begin(), best.end());
+			previous = row;
+		}
+
+		return filtered;
+	}
+}
+
+void writePng(ostream& out, int width, int height, const unsigned char* rgba, bool bottomUp)
+{
+	if (width <= 0 || height <= 0)
+		throw invalid_argument{ "PNG size must be positive" };
+
+	static const unsigned char signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+	out.write(reinterpret_cast<const char*>(signature), sizeof(signature));
+
+	vector<unsigned char> header(13);
+	for (int i = 0; i < 4; ++i)
+	{
+		header[i] = static_cast<unsigned char>(static_cast<uint32_t>(width) >> (24 - 8 * i));
+		header[4 + i] = static_cast<unsigned char>(static_cast<uint32_t>(height) >> (24 - 8 * i));
+	}
+	header[8] = 8;                      // bits per channel
+	header[9] = 6;                      // RGBA
+
+	writeChunk(out, "IHDR", header);
+	writeChunk(out, "IDAT", zlibCompress(filterRows(width, height, rgba, bottomUp)));
+	writeChunk(out, "IEND", {});
+
+	if (!out)
+		throw runtime_error{ "failed to write PNG" };
+}
+
+void writePng(const string& path, int width, int height, const unsigned char* rgba, bool bottomUp)
+{
+	ofstream out{ path, ios::binary };
+	if (!out)
+		throw runtime_error{ "cannot write " + path };
+
+	writePng(out, width, height, rgba, bottomUp);
+
+	out.close();
+	if (!out)
+		throw runtime_error{ "failed to write " + path };
+}
+
+} // common
\ No newline at end of file
@@ -0,0 +1,97 @@
+#include <radix_sort.hpp>
+#include <jobs.hpp>
+#include <array>
+
+namespace common {
+
+using namespace std;
+
+namespace {
+
+	constexpr size_t min_parallel_items = 1 << 14;
+	constexpr size_t max_chunks = 64;
+
+	using Histogram = array<uint32_t, 256>;
+}
+
+void radixSort(vector<SortItem>& items, vector<SortItem>& scratch, JobSystem* jobs)
+{
+	const auto count = items.size();
+	if (count < 2)
+		return;
+
+	scratch.resize(count);
+
+	const auto chunks = jobs && count >= min_parallel_items
+		? min<size_t>(jobs->threadCount() * 2, max_chunks)
+		: size_t{ 1 };
+	const auto chunkSize = (count + chunks - 1) / chunks;
+
+	auto forEachChunk = [&](auto&& fn)
+	{
+		if (chunks == 1)
+		{
+			fn(size_t{ 0 }, size_t{ 0 }, count);
+			return;
+		}
+
+		jobs->parallelFor(0, chunks, 1, [&](size_t first, size_t last)
+		{
+			for (auto c = first; c < last; ++c)
+				fn(c, min(count, c * chunkSize), min(count, (c + 1) * chunkSize));
+		});
+	};
+
+	// bits that differ from the first key anywhere in the input
+	array<uint64_t, max_chunks> partialMask{};
+	forEachChunk([&](size_t c, size_t first, size_t last)
+	{
+		uint64_t mask = 0;
+		for (auto i = first; i < last; ++i)
+			mask |= items[i].key ^ items[0].key;
+		partialMask[c] = mask;
+	});
+
+	uint64_t varying = 0;
+	for (size_t c = 0; c < chunks; ++c)
+		varying |= partialMask[c];
+
+	array<Histogram, max_chunks> histograms;
+
+	for (unsigned shift = 0; shift < 64; shift += 8)
+	{
+		if (((varying >> shift) & 0xff) == 0)
+			continue;
+
+		forEachChunk([&](size_t c, size_t first, size_t last)
+		{
+			auto& h = histograms[c];
+			h.fill(0);
+			for (auto i = first; i < last; ++i)
+				++h[(items[i].key >> shift) & 0xff];
+		});
+
+		// bucket-major prefix sum keeps equal keys in input order
+		uint32_t offset = 0;
+		for (size_t bucket = 0; bucket < 256; ++bucket)
+		{
+			for (size_t c = 0; c < chunks; ++c)
+			{
+				const auto n = histograms[c][bucket];
+				histograms[c][bucket] = offset;
+				offset += n;
+			}
+		}
+
+		forEachChunk([&](size_t c, size_t first, size_t last)
+		{
+			auto& h = histograms[c];
+			for (auto i = first; i < last; ++i)
+				scratch[h[(items[i].key >> shift) & 0xff]++] = items[i];
+		});
+
+		items.swap(scratch);
+	}
+}
+
+} // common
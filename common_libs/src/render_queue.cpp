@@ -0,0 +1,130 @@
+#include <render_queue.hpp>
+#include <gl_state.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <cstdint>
+#include <cstring>
+
+namespace glsl {
+
+using namespace std;
+
+namespace {
+
+	uint64_t depthBits(float depth) noexcept
+	{
+		// the bit pattern of a non-negative float grows with its value
+		depth = depth > 0.0f ? depth : 0.0f;
+
+		uint32_t bits;
+		memcpy(&bits, &depth, sizeof(bits));
+		return bits >> 8;
+	}
+
+	uint64_t nameBits(GLuint name) noexcept
+	{
+		return name & 0x3ffu;
+	}
+}
+
+RenderQueue::RenderQueue(common::JobSystem* jobs)
+	: mJobs{ jobs }
+{
+}
+
+void RenderQueue::clear() noexcept
+{
+	mPackets.clear();
+	mOrder.clear();
+	mSorted = true;
+}
+
+void RenderQueue::push(const DrawPacket& packet)
+{
+	mOrder.push_back({ makeKey(packet), static_cast<uint32_t>(mPackets.size()) });
+	mPackets.push_back(packet);
+	mSorted = false;
+}
+
+uint64_t RenderQueue::makeKey(const DrawPacket& packet) noexcept
+{
+	const auto state = nameBits(packet.program) << 20 | nameBits(packet.textures[0]) << 10 | nameBits(packet.vao);
+	const auto depth = depthBits(packet.depth);
+
+	if (packet.translucent)
+		return uint64_t{ 1 } << 63 | (~depth & 0xffffff) << 39 | state << 9;
+
+	return state << 33 | depth << 9;
+}
+
+void RenderQueue::sort()
+{
+	if (!mSorted)
+		common::radixSort(mOrder, mScratch, mJobs);
+
+	mSorted = true;
+}
+
+RenderQueueStats RenderQueue::submit() const
+{
+	RenderQueueStats stats;
+	auto& state = GLState::current();
+
+	GLuint program = 0, vao = 0;
+	array<GLuint, tuple_size<decltype(DrawPacket::textures)>::value> textures{};
+	auto first = true;
+
+	for (const auto& item : mOrder)
+	{
+		const auto& p = mPackets[item.index];
+
+		if (first || p.program != program)
+		{
+			state.useProgram(p.program);
+			program = p.program;
+			++stats.programBinds;
+		}
+		else
+		{
+			++stats.programBindsSkipped;
+		}
+
+		if (first || p.vao != vao)
+		{
+			state.bindVertexArray(p.vao);
+			vao = p.vao;
+			++stats.vaoBinds;
+		}
+		else
+		{
+			++stats.vaoBindsSkipped;
+		}
+
+		for (size_t unit = 0; unit < textures.size(); ++unit)
+		{
+			if (!first && p.textures[unit] == textures[unit])
+			{
+				++stats.textureBindsSkipped;
+				continue;
+			}
+
+			state.bindTexture(static_cast<GLuint>(unit), GL_TEXTURE_2D, p.textures[unit]);
+			textures[unit] = p.textures[unit];
+			++stats.textureBinds;
+		}
+
+		if (p.modelLocation >= 0)
+			glUniformMatrix4fv(p.modelLocation, 1, GL_FALSE, glm::value_ptr(p.model));
+
+		if (p.indexType == GL_NONE)
+			glDrawArrays(p.mode, p.first, p.count);
+		else
+			glDrawElementsBaseVertex(p.mode, p.count, p.indexType, reinterpret_cast<const void*>(static_cast<intptr_t>(p.first)), p.baseVertex);
+
+		++stats.draws;
+		first = false;
+	}
+
+	return stats;
+}
+
+} // glsl
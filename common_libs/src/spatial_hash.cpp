@@ -0,0 +1,305 @@
+#include <spatial_hash.hpp>
+#include <jobs.hpp>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace common {
+
+using namespace std;
+
+namespace {
+
+	uint32_t hashCell(int32_t x, int32_t y, int32_t z) noexcept
+	{
+		return (static_cast<uint32_t>(x) * 73856093u)
+			^ (static_cast<uint32_t>(y) * 19349663u)
+			^ (static_cast<uint32_t>(z) * 83492791u);
+	}
+
+	// far enough out for any real scene, and small enough that the spans
+	// between two coordinates still fit an int32_t
+	constexpr int32_t max_cell = 1 << 30;
+
+	int32_t cellCoord(float v, float invCellSize) noexcept
+	{
+		const auto cell = floor(v * invCellSize);
+		if (cell >= static_cast<float>(max_cell))
+			return max_cell;
+
+		// NaN ends up at the bottom too
+		return cell > static_cast<float>(-max_cell) ? static_cast<int32_t>(cell) : -max_cell;
+	}
+
+	size_t nextPowerOfTwo(size_t v) noexcept
+	{
+		size_t res = 1;
+		while (res < v)
+			res <<= 1;
+		return res;
+	}
+
+	constexpr uint32_t free_bucket = ~uint32_t{ 0 };
+
+	// objects per findPairs chunk
+	constexpr size_t pair_grain = 256;
+}
+
+SpatialHash::SpatialHash(float cellSize, size_t bucketCount, JobSystem* jobs)
+	: mJobs{ jobs }
+	, mInvCellSize{ 1.0f / cellSize }
+	, mBucketMask{ static_cast<uint32_t>(nextPowerOfTwo(max<size_t>(bucketCount, 1)) - 1) }
+	, mMaxHalfExtent{ 0.0f }
+	, mBuckets(mBucketMask + 1)
+	, mScratch(jobs ? jobs->threadCount() + 1 : 1)
+{
+	if (!(cellSize > 0.0f))
+		throw invalid_argument{ "SpatialHash cell size must be positive" };
+}
+
+SpatialHash::Handle SpatialHash::insert(const Aabb& bounds, uint32_t userData)
+{
+	Handle handle;
+
+	if (mFreeHandles.empty())
+	{
+		handle = static_cast<Handle>(mObjects.size());
+		mObjects.push_back({});
+	}
+	else
+	{
+		handle = mFreeHandles.back();
+		mFreeHandles.pop_back();
+	}
+
+	auto& obj = mObjects[handle];
+	obj.bounds = bounds;
+	obj.userData = userData;
+	mMaxHalfExtent = glm::max(mMaxHalfExtent, bounds.halfExtent());
+
+	link(handle, bucketOf(bounds.center()));
+	return handle;
+}
+
+void SpatialHash::remove(Handle handle)
+{
+	if (handle >= mObjects.size() || mObjects[handle].bucket == free_bucket)
+		return;
+
+	unlink(handle);
+	shrink(mObjects[handle].bounds, glm::vec3{ 0.0f });
+	mObjects[handle].bucket = free_bucket;
+	mFreeHandles.push_back(handle);
+
+	// a queued move for a removed handle must not resurrect it
+	mPending.erase(remove_if(begin(mPending), end(mPending), [handle](const auto& p)
+	{
+		return p.handle == handle;
+	}), end(mPending));
+}
+
+void SpatialHash::update(Handle handle, const Aabb& bounds)
+{
+	checkHandle(handle);
+	move(handle, bucketOf(bounds.center()), bounds);
+}
+
+void SpatialHash::queueUpdate(Handle handle, const Aabb& bounds)
+{
+	checkHandle(handle);
+	mPending.push_back({ handle, bucketOf(bounds.center()), bounds });
+}
+
+void SpatialHash::flushUpdates()
+{
+	stable_sort(begin(mPending), end(mPending), [](const auto& lhs, const auto& rhs)
+	{
+		return lhs.bucket < rhs.bucket;
+	});
+
+	for (const auto& p : mPending)
+		move(p.handle, p.bucket, p.bounds);
+
+	mPending.clear();
+
+	if (mExtentStale)
+		refit();
+}
+
+void SpatialHash::query(const Aabb& box, vector<Handle>& handles) const
+{
+	handles.clear();
+
+	auto gather = [&](uint32_t bucket)
+	{
+		for (auto handle : mBuckets[bucket])
+		{
+			if (mObjects[handle].bounds.overlaps(box))
+				handles.push_back(handle);
+		}
+	};
+
+	// objects are filed by center, so anything reaching into the box has its
+	// center within the box grown by the largest half extent
+	const auto lo = box.min - mMaxHalfExtent;
+	const auto hi = box.max + mMaxHalfExtent;
+
+	const auto x0 = cellCoord(lo.x, mInvCellSize), x1 = cellCoord(hi.x, mInvCellSize);
+	const auto y0 = cellCoord(lo.y, mInvCellSize), y1 = cellCoord(hi.y, mInvCellSize);
+	const auto z0 = cellCoord(lo.z, mInvCellSize), z1 = cellCoord(hi.z, mInvCellSize);
+
+	if (x1 < x0 || y1 < y0 || z1 < z0)
+		return;
+
+	const auto cells = (double(x1) - x0 + 1.0) * (double(y1) - y0 + 1.0) * (double(z1) - z0 + 1.0);
+	if (cells >= static_cast<double>(mBuckets.size()))
+	{
+		for (uint32_t bucket = 0; bucket < mBuckets.size(); ++bucket)
+			gather(bucket);
+		return;
+	}
+
+	for (auto z = z0; z <= z1; ++z)
+		for (auto y = y0; y <= y1; ++y)
+			for (auto x = x0; x <= x1; ++x)
+				gather(hashCell(x, y, z) & mBucketMask);
+
+	// distinct cells may share a bucket, whose objects then came up twice
+	sort(begin(handles), end(handles));
+	handles.erase(unique(begin(handles), end(handles)), end(handles));
+}
+
+void SpatialHash::findPairs(vector<Pair>& pairs) const
+{
+	pairs.clear();
+
+	const auto count = mObjects.size();
+	if (!mJobs || count <= pair_grain)
+	{
+		lock_guard<mutex> lock{ mScratchMutex };
+		findPairsRange(0, count, mScratch.back());
+	}
+	else
+	{
+		mJobs->parallelFor(0, count, pair_grain, [this](size_t first, size_t last)
+		{
+			// a thread outside the JobSystem may steal a chunk while it waits
+			const auto worker = mJobs->workerIndex();
+			if (worker + 1 < mScratch.size())
+			{
+				findPairsRange(first, last, mScratch[worker]);
+				return;
+			}
+
+			lock_guard<mutex> lock{ mScratchMutex };
+			findPairsRange(first, last, mScratch.back());
+		});
+	}
+
+	size_t total = 0;
+	for (const auto& scratch : mScratch)
+		total += scratch.pairs.size();
+
+	pairs.reserve(total);
+	for (auto& scratch : mScratch)
+	{
+		pairs.insert(end(pairs), begin(scratch.pairs), end(scratch.pairs));
+		scratch.pairs.clear();
+	}
+
+	sort(begin(pairs), end(pairs));
+}
+
+uint32_t SpatialHash::bucketOf(const glm::vec3& point) const noexcept
+{
+	return hashCell(
+		cellCoord(point.x, mInvCellSize),
+		cellCoord(point.y, mInvCellSize),
+		cellCoord(point.z, mInvCellSize)) & mBucketMask;
+}
+
+void SpatialHash::link(Handle handle, uint32_t bucket)
+{
+	auto& obj = mObjects[handle];
+	auto& list = mBuckets[bucket];
+
+	obj.bucket = bucket;
+	obj.slot = static_cast<uint32_t>(list.size());
+	list.push_back(handle);
+}
+
+void SpatialHash::unlink(Handle handle)
+{
+	const auto& obj = mObjects[handle];
+	auto& list = mBuckets[obj.bucket];
+
+	const auto last = list.back();
+	list[obj.slot] = last;
+	mObjects[last].slot = obj.slot;
+	list.pop_back();
+}
+
+void SpatialHash::move(Handle handle, uint32_t bucket, const Aabb& bounds)
+{
+	auto& obj = mObjects[handle];
+	shrink(obj.bounds, bounds.halfExtent());
+	obj.bounds = bounds;
+	mMaxHalfExtent = glm::max(mMaxHalfExtent, bounds.halfExtent());
+
+	if (obj.bucket == bucket)
+		return;
+
+	unlink(handle);
+	link(handle, bucket);
+}
+
+void SpatialHash::checkHandle(Handle handle) const
+{
+	if (handle >= mObjects.size() || mObjects[handle].bucket == free_bucket)
+		throw invalid_argument{ "SpatialHash handle has been removed" };
+}
+
+void SpatialHash::shrink(const Aabb& before, const glm::vec3& after) noexcept
+{
+	const auto extent = before.halfExtent();
+	for (int i = 0; i < 3; ++i)
+	{
+		if (extent[i] >= mMaxHalfExtent[i] && after[i] < extent[i])
+			mExtentStale = true;
+	}
+}
+
+void SpatialHash::refit()
+{
+	mMaxHalfExtent = glm::vec3{ 0.0f };
+	for (const auto& obj : mObjects)
+	{
+		if (obj.bucket != free_bucket)
+			mMaxHalfExtent = glm::max(mMaxHalfExtent, obj.bounds.halfExtent());
+	}
+
+	mExtentStale = false;
+}
+
+void SpatialHash::findPairsRange(size_t first, size_t last, Scratch& scratch) const
+{
+	auto& handles = scratch.handles;
+	auto& pairs = scratch.pairs;
+
+	for (auto a = first; a < last; ++a)
+	{
+		const auto& obj = mObjects[a];
+		if (obj.bucket == free_bucket)
+			continue;
+
+		query(obj.bounds, handles);
+
+		for (auto b : handles)
+		{
+			if (b > a)
+				pairs.emplace_back(static_cast<Handle>(a), b);
+		}
+	}
+}
+
+} // common
@@ -0,0 +1,172 @@
+#include <sprite_batch.hpp>
+#include <gl_state.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+
+namespace glsl {
+
+using namespace std;
+
+namespace {
+
+	uint32_t packColor(const glm::vec4& color) noexcept
+	{
+		auto channel = [](float c)
+		{
+			return static_cast<uint32_t>(min(max(c, 0.0f), 1.0f) * 255.0f + 0.5f);
+		};
+
+		return channel(color.x) | channel(color.y) << 8 | channel(color.z) << 16 | channel(color.w) << 24;
+	}
+
+	constexpr GLbitfield stream_flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+}
+
+SpriteBatch::SpriteBatch(uint32_t capacity, const string& vertexShader, const string& fragmentShader)
+	: mCapacity{ capacity }
+	, mProgram{
+		{ vertex_shader  , vertexShader },
+		{ fragment_shader, fragmentShader }
+	}
+	, mProjectionLocation{ glGetUniformLocation(mProgram, "projection") }
+	, mStream{ static_cast<GLsizeiptr>(sizeof(Instance)) * capacity * region_count, nullptr, stream_flags }
+	, mMapped{ nullptr }
+{
+	if (capacity == 0)
+		throw invalid_argument{ "SpriteBatch capacity must be positive" };
+
+	mMapped = static_cast<Instance*>(mStream.mapRange(0, mStream.size(), stream_flags));
+	if (!mMapped)
+		throw runtime_error{ "SpriteBatch could not map its stream buffer" };
+
+	mVao.vertexBuffer(0, mStream, 0, sizeof(Instance));
+	mVao.bindingDivisor(0, 1);
+	mVao.attribute(0, 0, 4, GL_FLOAT, offsetof(Instance, rect));
+	mVao.attribute(1, 0, 4, GL_FLOAT, offsetof(Instance, uvRect));
+	mVao.attribute(2, 0, 4, GL_UNSIGNED_BYTE, offsetof(Instance, color), true);
+	mVao.attribute(3, 0, 2, GL_FLOAT, offsetof(Instance, rotation));
+
+	mInstances.reserve(capacity);
+	mBuckets.reserve(capacity);
+
+	glProgramUniform1i(mProgram, glGetUniformLocation(mProgram, "atlas"), 0);
+	setProjection(glm::mat4{ 1.0f });
+}
+
+SpriteBatch::~SpriteBatch()
+{
+	for (auto fence : mFences)
+	{
+		if (fence)
+			glDeleteSync(fence);
+	}
+}
+
+void SpriteBatch::setProjection(const glm::mat4& projection)
+{
+	glProgramUniformMatrix4fv(mProgram, mProjectionLocation, 1, GL_FALSE, glm::value_ptr(projection));
+}
+
+void SpriteBatch::draw(const Sprite& sprite)
+{
+	if (mInstances.size() == mCapacity)
+		flush();
+
+	mInstances.push_back({
+		glm::vec4{ sprite.position.x, sprite.position.y, sprite.size.x, sprite.size.y },
+		sprite.uvRect,
+		packColor(sprite.color),
+		sprite.rotation,
+		static_cast<float>(sprite.layer),
+		0.0f
+	});
+	mBuckets.push_back(bucketOf(sprite.texture));
+}
+
+uint16_t SpriteBatch::bucketOf(GLuint texture)
+{
+	// sprites tend to come in runs of one atlas, so try the last one first
+	if (mLastBucket < mTextures.size() && mTextures[mLastBucket] == texture)
+		return static_cast<uint16_t>(mLastBucket);
+
+	auto it = find(mTextures.begin(), mTextures.end(), texture);
+	if (it == mTextures.end())
+	{
+		if (mTextures.size() > numeric_limits<uint16_t>::max())
+			throw length_error{ "SpriteBatch has too many atlases in one flush" };
+
+		mTextures.push_back(texture);
+		it = mTextures.end() - 1;
+	}
+
+	mLastBucket = static_cast<size_t>(it - mTextures.begin());
+	return static_cast<uint16_t>(mLastBucket);
+}
+
+void SpriteBatch::flush()
+{
+	if (mInstances.empty())
+		return;
+
+	auto& fence = mFences[mRegion];
+	if (fence)
+	{
+		if (glClientWaitSync(fence, 0, 0) != GL_ALREADY_SIGNALED)
+		{
+			++mStats.fenceWaits;
+			while (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000) == GL_TIMEOUT_EXPIRED)
+			{
+			}
+		}
+
+		glDeleteSync(fence);
+		fence = nullptr;
+	}
+
+	// counting sort by atlas, scattered straight into the mapped region
+	const auto regionBase = mRegion * mCapacity;
+
+	mOffsets.assign(mTextures.size() + 1, 0);
+	for (auto bucket : mBuckets)
+		++mOffsets[bucket + 1];
+
+	for (size_t b = 1; b < mOffsets.size(); ++b)
+		mOffsets[b] += mOffsets[b - 1];
+
+	// afterwards mOffsets[b] is where atlas b ends and b + 1 starts
+	auto region = mMapped + regionBase;
+	for (size_t i = 0; i < mInstances.size(); ++i)
+		region[mOffsets[mBuckets[i]]++] = mInstances[i];
+
+	auto& state = GLState::current();
+	mProgram.use();
+	mVao.bind();
+
+	for (size_t b = 0; b < mTextures.size(); ++b)
+	{
+		const auto first = b ? mOffsets[b - 1] : 0;
+		const auto count = mOffsets[b] - first;
+		if (count == 0)
+			continue;
+
+		state.bindTexture(0, GL_TEXTURE_2D_ARRAY, mTextures[b]);
+		glDrawArraysInstancedBaseInstance(GL_TRIANGLE_STRIP, 0, 4, static_cast<GLsizei>(count), regionBase + first);
+		++mStats.draws;
+	}
+
+	fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	mRegion = (mRegion + 1) % region_count;
+
+	mStats.sprites += mInstances.size();
+	++mStats.flushes;
+
+	mInstances.clear();
+	mBuckets.clear();
+	mTextures.clear();
+	mLastBucket = 0;
+}
+
+} // glsl
@@ -0,0 +1,208 @@
+#include <static_batch.hpp>
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+namespace glsl {
+
+using namespace std;
+
+namespace {
+
+	const VertexAttribute* findFloatAttribute(const VertexLayout& layout, GLuint location)
+	{
+		for (const auto& a : layout.attributes)
+		{
+			if (a.location == location)
+				return a.type == GL_FLOAT && a.components >= 3 ? &a : nullptr;
+		}
+		return nullptr;
+	}
+
+	// Spreads the low 10 bits of v three bits apart.
+	uint64_t spreadBits(uint64_t v) noexcept
+	{
+		v &= 0x3ff;
+		v = (v | v << 16) & 0x30000ff;
+		v = (v | v << 8) & 0x300f00f;
+		v = (v | v << 4) & 0x30c30c3;
+		v = (v | v << 2) & 0x9249249;
+		return v;
+	}
+
+	glm::vec3 readVec3(const unsigned char* p) noexcept
+	{
+		glm::vec3 v;
+		memcpy(&v, p, sizeof(v));
+		return v;
+	}
+
+	void writeVec3(unsigned char* p, const glm::vec3& v) noexcept
+	{
+		memcpy(p, &v, sizeof(v));
+	}
+}
+
+StaticBatch::StaticBatch(GeometryArena& arena, uint32_t maxChunkVertices, GLint normalLocation)
+	: mArena{ arena }
+	, mMaxChunkVertices{ maxChunkVertices }
+{
+	const auto position = findFloatAttribute(arena.layout(), 0);
+	if (!position)
+		throw invalid_argument{ "StaticBatch needs float positions at location 0" };
+
+	mPositionOffset = position->offset;
+	mPositionComponents = position->components;
+
+	if (normalLocation >= 0)
+	{
+		const auto normal = findFloatAttribute(arena.layout(), static_cast<GLuint>(normalLocation));
+		if (!normal)
+			throw invalid_argument{ "StaticBatch normal attribute must be three floats" };
+
+		mNormalOffset = static_cast<GLint>(normal->offset);
+	}
+
+	if (maxChunkVertices == 0)
+		throw invalid_argument{ "StaticBatch chunks need room for vertices" };
+}
+
+StaticBatch::~StaticBatch()
+{
+	for (const auto& chunk : mChunks)
+		mArena.remove(chunk.mesh);
+}
+
+void StaticBatch::add(uint32_t material, const void* vertices, GLsizei vertexCount,
+	const GLuint* indices, GLsizei indexCount, const glm::mat4& model)
+{
+	if (vertexCount <= 0 || indexCount <= 0)
+		throw invalid_argument{ "StaticBatch::add of an empty mesh" };
+
+	const auto stride = static_cast<size_t>(mArena.layout().stride);
+	const auto bytes = static_cast<const unsigned char*>(vertices);
+
+	Pending object;
+	object.material = material;
+	object.morton = 0;
+	object.vertices.assign(bytes, bytes + stride * vertexCount);
+	object.indices.assign(indices, indices + indexCount);
+
+	for (auto index : object.indices)
+	{
+		if (index >= static_cast<GLuint>(vertexCount))
+			throw out_of_range{ "StaticBatch::add index past the vertex count" };
+	}
+
+	// a mirroring matrix turns every triangle inside out, swap two corners
+	// so the front faces still wind counterclockwise
+	if (glm::determinant(glm::mat3{ model }) < 0.0f)
+	{
+		for (size_t i = 0; i + 2 < object.indices.size(); i += 3)
+			swap(object.indices[i + 1], object.indices[i + 2]);
+	}
+
+	const auto normalMatrix = glm::transpose(glm::inverse(glm::mat3{ model }));
+
+	auto lo = glm::vec3{ numeric_limits<float>::max() };
+	auto hi = -lo;
+	for (GLsizei v = 0; v < vertexCount; ++v)
+	{
+		const auto vertex = object.vertices.data() + v * stride;
+
+		// a fourth position component is left as it was
+		const auto position = glm::vec3{ model * glm::vec4{ readVec3(vertex + mPositionOffset), 1.0f } };
+		writeVec3(vertex + mPositionOffset, position);
+		lo = glm::min(lo, position);
+		hi = glm::max(hi, position);
+
+		if (mNormalOffset >= 0)
+		{
+			const auto normal = normalMatrix * readVec3(vertex + mNormalOffset);
+			const auto length = glm::length(normal);
+			writeVec3(vertex + mNormalOffset, length > 0.0f ? normal / length : normal);
+		}
+	}
+
+	object.bounds = { lo, hi };
+	mPending.push_back(move(object));
+}
+
+void StaticBatch::build()
+{
+	if (mPending.empty())
+		return;
+
+	auto lo = glm::vec3{ numeric_limits<float>::max() };
+	auto hi = -lo;
+	for (const auto& object : mPending)
+	{
+		lo = glm::min(lo, object.bounds.min);
+		hi = glm::max(hi, object.bounds.max);
+	}
+
+	const auto extent = glm::max(hi - lo, glm::vec3{ 1e-6f });
+	for (auto& object : mPending)
+	{
+		const auto cell = (object.bounds.center() - lo) / extent * 1023.0f;
+		object.morton = spreadBits(static_cast<uint64_t>(cell.x))
+			| spreadBits(static_cast<uint64_t>(cell.y)) << 1
+			| spreadBits(static_cast<uint64_t>(cell.z)) << 2;
+	}
+
+	sort(mPending.begin(), mPending.end(), [](const Pending& a, const Pending& b)
+	{
+		return a.material != b.material ? a.material < b.material : a.morton < b.morton;
+	});
+
+	const auto stride = static_cast<size_t>(mArena.layout().stride);
+
+	vector<unsigned char> vertices;
+	vector<GLuint> indices;
+	common::Aabb bounds{};
+	uint32_t material = 0;
+
+	auto flush = [&]
+	{
+		if (vertices.empty())
+			return;
+
+		const auto vertexCount = static_cast<GLsizei>(vertices.size() / stride);
+		mChunks.push_back({ material, mArena.add(vertices.data(), vertexCount, indices.data(), static_cast<GLsizei>(indices.size())), bounds });
+
+		vertices.clear();
+		indices.clear();
+	};
+
+	for (const auto& object : mPending)
+	{
+		const auto base = static_cast<uint32_t>(vertices.size() / stride);
+		const auto count = static_cast<uint32_t>(object.vertices.size() / stride);
+
+		if (!vertices.empty() && (object.material != material || base + count > mMaxChunkVertices))
+			flush();
+
+		if (vertices.empty())
+		{
+			material = object.material;
+			bounds = object.bounds;
+		}
+
+		const auto first = static_cast<GLuint>(vertices.size() / stride);
+		vertices.insert(vertices.end(), object.vertices.begin(), object.vertices.end());
+		for (auto index : object.indices)
+			indices.push_back(index + first);
+
+		bounds.min = glm::min(bounds.min, object.bounds.min);
+		bounds.max = glm::max(bounds.max, object.bounds.max);
+	}
+
+	flush();
+
+	mObjectCount += mPending.size();
+	mPending.clear();
+}
+
+} // glsl
@@ -0,0 +1,235 @@
+#include <vertex_pulling.hpp>
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+
+namespace glsl {
+
+using namespace std;
+
+namespace {
+
+	GLuint typeSize(GLenum type) noexcept
+	{
+		switch (type)
+		{
+		case GL_FLOAT:
+		case GL_INT:
+		case GL_UNSIGNED_INT:
+			return 4;
+
+		case GL_HALF_FLOAT:
+		case GL_SHORT:
+		case GL_UNSIGNED_SHORT:
+			return 2;
+
+		case GL_BYTE:
+		case GL_UNSIGNED_BYTE:
+			return 1;
+
+		default:
+			return 0;
+		}
+	}
+
+	void validate(const VertexLayout& layout)
+	{
+		if (layout.stride <= 0 || layout.stride % 4 != 0)
+			throw invalid_argument{ "vertex pulling needs a stride that is a multiple of 4" };
+
+		for (const auto& a : layout.attributes)
+		{
+			const auto size = typeSize(a.type);
+			if (size == 0 || a.components < 1 || a.components > 4)
+				throw invalid_argument{ "vertex pulling does not support this attribute format" };
+
+			if (a.offset % size != 0 || a.offset + size * a.components > static_cast<GLuint>(layout.stride))
+				throw invalid_argument{ "vertex pulling attribute is misaligned or past the stride" };
+
+			if (size == 4 && a.type != GL_FLOAT && a.normalized)
+				throw invalid_argument{ "vertex pulling cannot normalize 32-bit integers" };
+		}
+	}
+
+	// GLSL expression for component k of a, relative to the vertex's first word.
+	string component(const VertexAttribute& a, GLint k)
+	{
+		const auto bytes = typeSize(a.type);
+		const auto position = a.offset + k * bytes;
+		const auto word = "pulledWords[base + " + to_string(position / 4) + "u]";
+		const auto shift = to_string(position % 4 * 8);
+		const auto bits = to_string(bytes * 8);
+
+		switch (a.type)
+		{
+		case GL_FLOAT:
+			return "uintBitsToFloat(" + word + ")";
+
+		case GL_INT:
+			return "float(int(" + word + "))";
+
+		case GL_UNSIGNED_INT:
+			return "float(" + word + ")";
+
+		case GL_HALF_FLOAT:
+			return "unpackHalf2x16(bitfieldExtract(" + word + ", " + shift + ", 16)).x";
+
+		case GL_UNSIGNED_BYTE:
+		case GL_UNSIGNED_SHORT:
+		{
+			const auto value = "float(bitfieldExtract(" + word + ", " + shift + ", " + bits + "))";
+			return a.normalized ? value + " / " + to_string((1u << (bytes * 8)) - 1) + ".0" : value;
+		}
+
+		default:
+		{
+			const auto value = "float(bitfieldExtract(int(" + word + "), " + shift + ", " + bits + "))";
+			return a.normalized ? "max(" + value + " / " + to_string((1u << (bytes * 8 - 1)) - 1) + ".0, -1.0)" : value;
+		}
+		}
+	}
+}
+
+string vertexPullingSource(const vector<VertexLayout>& formats, GLuint vertexBinding, GLuint drawBinding)
+{
+	GLuint locations = 0;
+	for (const auto& layout : formats)
+	{
+		validate(layout);
+		for (const auto& a : layout.attributes)
+			locations = max(locations, a.location + 1);
+	}
+
+	ostringstream src;
+	src << "layout (std430, binding = " << vertexBinding << ") readonly buffer PulledVertices {\n"
+		<< "    uint pulledWords[];\n"
+		<< "};\n\n"
+		<< "struct PulledDraw {\n"
+		<< "    mat4 model;\n"
+		<< "    uvec4 params;\n"
+		<< "};\n\n"
+		<< "layout (std430, binding = " << drawBinding << ") readonly buffer PulledDraws {\n"
+		<< "    PulledDraw pulledDraws[];\n"
+		<< "};\n\n"
+		<< "layout (location = " << IndirectDrawBatch::draw_index_location << ") in uint pulledDrawIndex;\n\n"
+		<< "struct PulledVertex {\n";
+
+	for (GLuint l = 0; l < locations; ++l)
+		src << "    vec4 location" << l << ";\n";
+
+	if (locations == 0)
+		src << "    vec4 unused;\n";
+
+	src << "};\n\n"
+		<< "mat4 pulledModel()\n"
+		<< "{\n"
+		<< "    return pulledDraws[pulledDrawIndex].model;\n"
+		<< "}\n\n"
+		<< "PulledVertex pullVertex()\n"
+		<< "{\n"
+		<< "    uvec4 params = pulledDraws[pulledDrawIndex].params;\n"
+		<< "    PulledVertex v;\n";
+
+	for (GLuint l = 0; l < locations; ++l)
+		src << "    v.location" << l << " = vec4(0.0, 0.0, 0.0, 1.0);\n";
+
+	src << "    uint base;\n"
+		<< "    switch (params.x)\n"
+		<< "    {\n";
+
+	for (size_t f = 0; f < formats.size(); ++f)
+	{
+		src << "    case " << f << "u:\n"
+			<< "        base = params.y + uint(gl_VertexID) * " << formats[f].stride / 4 << "u;\n";
+
+		for (const auto& a : formats[f].attributes)
+		{
+			static const char* const defaults[] = { "0.0", "0.0", "0.0", "1.0" };
+
+			src << "        v.location" << a.location << " = vec4(";
+			for (GLint k = 0; k < 4; ++k)
+				src << (k ? ", " : "") << (k < a.components ? component(a, k) : defaults[k]);
+			src << ");\n";
+		}
+
+		src << "        break;\n";
+	}
+
+	src << "    }\n"
+		<< "    return v;\n"
+		<< "}\n";
+
+	return src.str();
+}
+
+PulledGeometry::PulledGeometry(vector<VertexLayout> formats, uint32_t words, uint32_t indices)
+	: mFormats{ move(formats) }
+	, mWords{ static_cast<GLsizeiptr>(words * sizeof(GLuint)), nullptr, GL_DYNAMIC_STORAGE_BIT }
+	, mIndices{ static_cast<GLsizeiptr>(indices * sizeof(GLuint)), nullptr, GL_DYNAMIC_STORAGE_BIT }
+	, mWordSpace{ words }
+	, mIndexSpace{ indices }
+{
+	if (mFormats.empty())
+		throw invalid_argument{ "PulledGeometry needs at least one vertex format" };
+
+	for (const auto& layout : mFormats)
+		validate(layout);
+
+	mVao.elementBuffer(mIndices);
+}
+
+PulledMesh PulledGeometry::add(uint32_t format, const void* vertices, GLsizei vertexCount, const GLuint* indices, GLsizei indexCount)
+{
+	if (format >= mFormats.size())
+		throw out_of_range{ "PulledGeometry::add with an unknown format" };
+
+	if (vertexCount <= 0 || indexCount <= 0)
+		throw invalid_argument{ "PulledGeometry::add of an empty mesh" };
+
+	const auto strideWords = static_cast<uint32_t>(mFormats[format].stride / 4);
+
+	PulledMesh mesh;
+	mesh.format = format;
+	mesh.vertexCount = vertexCount;
+	mesh.indexCount = indexCount;
+
+	mesh.words = mWordSpace.allocate(static_cast<uint32_t>(vertexCount) * strideWords);
+	if (!mesh.words)
+		throw length_error{ "PulledGeometry vertex storage is full" };
+
+	mesh.indices = mIndexSpace.allocate(static_cast<uint32_t>(indexCount));
+	if (!mesh.indices)
+	{
+		mWordSpace.free(mesh.words);
+		throw length_error{ "PulledGeometry index storage is full" };
+	}
+
+	mesh.firstWord = mesh.words.offset;
+	mesh.firstIndex = mesh.indices.offset;
+
+	mWords.subData(static_cast<GLintptr>(mesh.firstWord) * sizeof(GLuint),
+		static_cast<GLsizeiptr>(vertexCount) * mFormats[format].stride, vertices);
+	mIndices.subData(static_cast<GLintptr>(mesh.firstIndex) * sizeof(GLuint),
+		static_cast<GLsizeiptr>(indexCount * sizeof(GLuint)), indices);
+
+	return mesh;
+}
+
+void PulledGeometry::remove(const PulledMesh& mesh)
+{
+	mWordSpace.free(mesh.words);
+	mIndexSpace.free(mesh.indices);
+}
+
+uint32_t PulledGeometry::addDraw(IndirectDrawBatch& batch, const PulledMesh& mesh, const glm::mat4& model) const
+{
+	const DrawElementsIndirectCommand command{ static_cast<GLuint>(mesh.indexCount), 1, mesh.firstIndex, 0, 0 };
+	return batch.add(command, DrawData{ model, glm::uvec4{ mesh.format, mesh.firstWord, 0u, 0u } });
+}
+
+void PulledGeometry::bind(GLuint vertexBinding) const
+{
+	mWords.bindBase(GL_SHADER_STORAGE_BUFFER, vertexBinding);
+}
+
+} // glsl
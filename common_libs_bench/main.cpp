@@ -0,0 +1,890 @@
+#include <allocation_tracker.hpp>
+#include <app_context.hpp>
+#include <jobs.hpp>
+#include <frame_arena.hpp>
+#include <geometry_arena.hpp>
+#include <gpu_culling.hpp>
+#include <glsl.hpp>
+#include <indirect_draw.hpp>
+#include <meshlets.hpp>
+#include <png_writer.hpp>
+#include <sprite_batch.hpp>
+#include <static_batch.hpp>
+#include <vertex_pulling.hpp>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include "stb_image.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+using namespace std;
+
+// Runs fn repeatedly and returns the best wall time of one run in milliseconds.
+template <typename Fn>
+double bestOf(int runs, Fn&& fn)
+{
+	auto best = 1e30;
+	for (int i = 0; i < runs; ++i)
+	{
+		const auto start = chrono::steady_clock::now();
+		fn();
+		const auto stop = chrono::steady_clock::now();
+		best = min(best, chrono::duration<double, milli>(stop - start).count());
+	}
+	return best;
+}
+
+// The per-object update of the 2.8.3/2.9.1 cube loops, over many more cubes.
+void updateTransforms(const vector<glm::vec3>& positions, vector<glm::mat4>& models, float t, size_t first, size_t last)
+{
+	for (auto i = first; i < last; ++i)
+	{
+		auto model = glm::mat4{ 1.0f };
+		model = glm::translate(model, positions[i]);
+		model = glm::rotate(model, sin(t + i * 0.001f) * 4.0f, glm::vec3{ 1.0f, 0.3f, 1.5f });
+		models[i] = model;
+	}
+}
+
+void benchJobScaling()
+{
+	const size_t count = 1 << 20;
+
+	mt19937 rng{ 42 };
+	uniform_real_distribution<float> dist{ -100.0f, 100.0f };
+
+	vector<glm::vec3> positions(count);
+	for (auto& p : positions)
+		p = glm::vec3{ dist(rng), dist(rng), dist(rng) };
+
+	vector<glm::mat4> models(count);
+
+	printf("job system: %zu transform updates\n", count);
+	printf("%8s %12s %10s\n", "threads", "ms", "speedup");
+
+	const auto maxThreads = max(1u, thread::hardware_concurrency());
+	auto baseline = 0.0;
+
+	for (unsigned threads = 1; threads <= maxThreads; threads = threads < maxThreads ? min(threads * 2, maxThreads) : threads + 1)
+	{
+		common::JobSystem jobs{ threads };
+
+		const auto ms = bestOf(5, [&]
+		{
+			jobs.parallelFor(0, count, 4096, [&](size_t first, size_t last)
+			{
+				updateTransforms(positions, models, 1.0f, first, last);
+			});
+		});
+
+		if (threads == 1)
+			baseline = ms;
+
+		printf("%8u %12.3f %9.2fx\n", threads, ms, baseline / ms);
+	}
+}
+
+// A hidden window, or a headless context with --headless, with GL 4.6 core,
+// or 4.5 where that is the newest (e.g. Mesa llvmpipe), or nullptr if there
+// is neither. The common_libs GL wrappers need 4.5 direct state access.
+unique_ptr<glsl::AppContext> createBenchContext(int argc, char** argv)
+{
+	for (int minor = 6; minor >= 5; --minor)
+	{
+		auto options = glsl::ContextOptions::fromCommandLine(argc, argv, { 64, 64, "common_libs_bench", 4, minor });
+		options.vsync = false;
+		options.visible = false;
+
+		try
+		{
+			return make_unique<glsl::AppContext>(options);
+		}
+		catch (const runtime_error&)
+		{
+		}
+	}
+
+	return nullptr;
+}
+
+const array<glm::vec4, 8> g_cubeCorners{
+	glm::vec4{ -0.5f, -0.5f, -0.5f, 1.0f }, glm::vec4{ 0.5f, -0.5f, -0.5f, 1.0f },
+	glm::vec4{ 0.5f, 0.5f, -0.5f, 1.0f }, glm::vec4{ -0.5f, 0.5f, -0.5f, 1.0f },
+	glm::vec4{ -0.5f, -0.5f, 0.5f, 1.0f }, glm::vec4{ 0.5f, -0.5f, 0.5f, 1.0f },
+	glm::vec4{ 0.5f, 0.5f, 0.5f, 1.0f }, glm::vec4{ -0.5f, 0.5f, 0.5f, 1.0f }
+};
+
+const array<GLuint, 36> g_cubeIndices{
+	0, 1, 2, 2, 3, 0, 4, 5, 6, 6, 7, 4, 0, 4, 7, 7, 3, 0,
+	1, 5, 6, 6, 2, 1, 3, 2, 6, 6, 7, 3, 0, 1, 5, 5, 4, 0
+};
+
+// Adds count copies of the cube to an arena of position-only vertices.
+vector<glsl::MeshRange> addCubes(glsl::GeometryArena& arena, uint32_t count)
+{
+	vector<glsl::MeshRange> meshes;
+	for (uint32_t i = 0; i < count; ++i)
+		meshes.push_back(arena.add(g_cubeCorners, g_cubeIndices));
+	return meshes;
+}
+
+glsl::VertexLayout positionLayout()
+{
+	return { static_cast<GLsizei>(sizeof(glm::vec4)), { { 0, 4, GL_FLOAT, 0 } } };
+}
+
+// A table row of a batch timing: the best run and the cost per item.
+void printPerItem(const char* name, double ms, size_t count)
+{
+	printf("%-28s %12.3f %10.1f\n", name, ms, ms * 1e6 / static_cast<double>(count));
+}
+
+// The matrix work of the transform and camera sample loops over a large
+// batch: building model matrices, concatenating them with the camera,
+// deriving normal matrices and transforming vertices.
+void benchMatrixMath()
+{
+	const size_t count = 1 << 16;
+
+	mt19937 rng{ 5 };
+	uniform_real_distribution<float> dist{ -100.0f, 100.0f };
+
+	vector<glm::vec3> positions(count);
+	for (auto& p : positions)
+		p = glm::vec3{ dist(rng), dist(rng), dist(rng) };
+
+	vector<glm::mat4> models(count), mvps(count);
+	vector<glm::mat3> normals(count);
+	vector<glm::vec4> points(count);
+
+	const auto viewProjection = glm::perspective(glm::radians(45.0f), 4.0f / 3.0f, 0.1f, 500.0f)
+		* glm::lookAt(glm::vec3{ 0.0f, 0.0f, 3.0f }, glm::vec3{ 0.0f }, glm::vec3{ 0.0f, 1.0f, 0.0f });
+
+	const auto modelMs = bestOf(10, [&]
+	{
+		updateTransforms(positions, models, 1.0f, 0, count);
+	});
+
+	const auto mvpMs = bestOf(10, [&]
+	{
+		for (size_t i = 0; i < count; ++i)
+			mvps[i] = viewProjection * models[i];
+	});
+
+	const auto normalMs = bestOf(10, [&]
+	{
+		for (size_t i = 0; i < count; ++i)
+			normals[i] = glm::transpose(glm::inverse(glm::mat3{ models[i] }));
+	});
+
+	const auto pointMs = bestOf(10, [&]
+	{
+		for (size_t i = 0; i < count; ++i)
+			points[i] = mvps[i] * g_cubeCorners[i & 7];
+	});
+
+	printf("\nmatrix math: %zu matrices\n", count);
+	printf("%-28s %12s %10s\n", "operation", "ms", "ns each");
+	printPerItem("translate * rotate", modelMs, count);
+	printPerItem("viewProjection * model", mvpMs, count);
+	printPerItem("normal matrix", normalMs, count);
+	printPerItem("mvp * vertex", pointMs, count);
+}
+
+vector<unsigned char> readFile(const char* path)
+{
+	ifstream file{ path, ios::binary };
+	return { istreambuf_iterator<char>{ file }, istreambuf_iterator<char>{} };
+}
+
+// stbi_load_from_memory on the sample textures, and on PNGs of growing size
+// whose smooth gradients and noise look more like real textures than flat
+// color does. Files are read up front so only decoding is timed.
+void benchImageDecode()
+{
+	struct Image {
+		string name;
+		vector<unsigned char> file;
+	};
+
+	vector<Image> images;
+	for (const auto path : { "resources/textures/wall.jpeg", "resources/textures/awesomeface.png" })
+	{
+		auto file = readFile(path);
+		if (!file.empty())
+			images.push_back({ strrchr(path, '/') + 1, move(file) });
+	}
+
+	mt19937 rng{ 13 };
+	for (const int size : { 256, 1024, 2048 })
+	{
+		vector<unsigned char> rgba(static_cast<size_t>(size) * size * 4);
+		for (int y = 0; y < size; ++y)
+		{
+			for (int x = 0; x < size; ++x)
+			{
+				auto pixel = &rgba[(static_cast<size_t>(y) * size + x) * 4];
+				pixel[0] = static_cast<unsigned char>(x * 255 / size + rng() % 8);
+				pixel[1] = static_cast<unsigned char>(y * 255 / size + rng() % 8);
+				pixel[2] = static_cast<unsigned char>((x ^ y) & 0xff);
+				pixel[3] = 255;
+			}
+		}
+
+		ostringstream out;
+		common::writePng(out, size, size, rgba.data());
+		const auto text = out.str();
+		images.push_back({ "png " + to_string(size) + "x" + to_string(size), { text.begin(), text.end() } });
+	}
+
+	printf("\nimage decode: stbi_load_from_memory\n");
+	printf("%-28s %12s %10s %10s\n", "image", "KiB", "ms", "MPix/s");
+
+	for (const auto& image : images)
+	{
+		int width = 0, height = 0, channels = 0;
+		const auto ms = bestOf(5, [&]
+		{
+			auto data = stbi_load_from_memory(image.file.data(), static_cast<int>(image.file.size()), &width, &height, &channels, 0);
+			if (!data)
+				throw runtime_error{ "cannot decode " + image.name + ": " + stbi_failure_reason() };
+			stbi_image_free(data);
+		});
+
+		printf("%-28s %12.1f %10.3f %10.1f\n", (image.name + ", " + to_string(channels) + " channels").c_str(),
+			static_cast<double>(image.file.size()) / 1024.0, ms, static_cast<double>(width) * height / (ms * 1e3));
+	}
+}
+
+// Meshlet building and culling on a finely tessellated sphere: the load time
+// and the per-frame CPU work of ClusteredMesh.
+void benchMeshProcessing()
+{
+	const uint32_t rings = 512;
+	const uint32_t segments = 1024;
+	const auto pi = 3.14159265358979f;
+
+	vector<glm::vec3> positions;
+	positions.reserve(static_cast<size_t>(rings + 1) * (segments + 1));
+	for (uint32_t r = 0; r <= rings; ++r)
+	{
+		const auto theta = pi * static_cast<float>(r) / rings;
+		for (uint32_t s = 0; s <= segments; ++s)
+		{
+			const auto phi = 2.0f * pi * static_cast<float>(s) / segments;
+			positions.push_back({ sin(theta) * cos(phi), cos(theta), sin(theta) * sin(phi) });
+		}
+	}
+
+	vector<uint32_t> indices;
+	indices.reserve(static_cast<size_t>(rings) * segments * 6);
+	for (uint32_t r = 0; r < rings; ++r)
+	{
+		for (uint32_t s = 0; s < segments; ++s)
+		{
+			const auto a = r * (segments + 1) + s;
+			const auto b = a + segments + 1;
+			indices.insert(indices.end(), { a, b, a + 1, a + 1, b, b + 1 });
+		}
+	}
+
+	common::MeshletMesh mesh;
+	const auto buildMs = bestOf(3, [&]
+	{
+		mesh = common::buildMeshlets(positions.data(), sizeof(glm::vec3), positions.size(), indices.data(), indices.size());
+	});
+
+	const glm::vec3 eye{ 0.0f, 0.0f, 3.0f };
+	const auto frustum = common::Frustum::fromMatrix(glm::perspective(glm::radians(30.0f), 4.0f / 3.0f, 0.1f, 100.0f)
+		* glm::lookAt(eye, glm::vec3{ 0.5f, 0.0f, 0.0f }, glm::vec3{ 0.0f, 1.0f, 0.0f }));
+	const auto model = glm::mat4{ 1.0f };
+
+	size_t visible = 0;
+	const auto cullMs = bestOf(10, [&]
+	{
+		visible = 0;
+		for (const auto& meshlet : mesh.meshlets)
+			visible += common::cullMeshlet(meshlet, model, eye, frustum) == common::MeshletVisibility::visible ? 1 : 0;
+	});
+
+	const auto triangles = indices.size() / 3;
+	printf("\nmesh processing: %zu triangles, %zu meshlets, %zu visible\n", triangles, mesh.meshlets.size(), visible);
+	printf("%-28s %12s %10s\n", "operation", "ms", "ns each");
+	printPerItem("build meshlets (triangle)", buildMs, triangles);
+	printPerItem("cull meshlets (meshlet)", cullMs, mesh.meshlets.size());
+}
+
+// One chunk of a culling pass: the visible objects' indices and model
+// matrices, collected into whatever vectors the caller hands it.
+template <typename Indices, typename Models>
+void collectVisible(const vector<glm::vec3>& positions, const common::Frustum& frustum, size_t first, size_t last, Indices& visible, Models& models)
+{
+	visible.reserve(last - first);
+	models.reserve(last - first);
+
+	for (auto i = first; i < last; ++i)
+	{
+		if (!frustum.intersects(positions[i], 0.87f))
+			continue;
+
+		visible.push_back(static_cast<uint32_t>(i));
+		models.push_back(glm::translate(glm::mat4{ 1.0f }, positions[i]));
+	}
+}
+
+// Per-frame scratch filled by jobs, each chunk with its own visible list and
+// instance matrices, taken from the heap and from a FrameArena. The heap
+// allocations per frame are counted when common_libs tracks them.
+void benchFrameScratch()
+{
+	const size_t count = 1 << 16;
+	const size_t grain = 1024;
+	const int frames = 20;
+
+	mt19937 rng{ 9 };
+	uniform_real_distribution<float> dist{ -100.0f, 100.0f };
+
+	vector<glm::vec3> positions(count);
+	for (auto& p : positions)
+		p = glm::vec3{ dist(rng), dist(rng), dist(rng) };
+
+	const auto frustum = common::Frustum::fromMatrix(glm::perspective(glm::radians(45.0f), 4.0f / 3.0f, 0.1f, 200.0f)
+		* glm::lookAt(glm::vec3{ 0.0f, 0.0f, 100.0f }, glm::vec3{ 0.0f }, glm::vec3{ 0.0f, 1.0f, 0.0f }));
+
+	common::JobSystem jobs;
+	common::FrameArena arenas;
+	atomic<size_t> visibleCount{ 0 };
+	uint64_t frame = 0;
+
+	auto heapFrame = [&]
+	{
+		jobs.parallelFor(0, count, grain, [&](size_t first, size_t last)
+		{
+			vector<uint32_t> visible;
+			vector<glm::mat4> models;
+			collectVisible(positions, frustum, first, last, visible, models);
+			visibleCount.fetch_add(visible.size(), memory_order_relaxed);
+		});
+	};
+
+	auto arenaFrame = [&]
+	{
+		auto& scratch = arenas.begin(frame++);
+		jobs.parallelFor(0, count, grain, [&](size_t first, size_t last)
+		{
+			common::ArenaVector<uint32_t> visible{ scratch };
+			common::ArenaVector<glm::mat4> models{ scratch };
+			collectVisible(positions, frustum, first, last, visible, models);
+			visibleCount.fetch_add(visible.size(), memory_order_relaxed);
+		});
+	};
+
+	auto& allocations = common::AllocationTracker::instance();
+	auto allocationsPerFrame = [&](auto&& runFrame)
+	{
+		if (!common::AllocationTracker::available())
+			return -1.0;
+
+		allocations.enable();
+		for (int i = 0; i < frames; ++i)
+			runFrame();
+		const auto total = allocations.total();
+		allocations.disable();
+		allocations.reset();
+
+		return static_cast<double>(total.count) / frames;
+	};
+
+	// the first frames grow the arena and the job system's queues
+	arenaFrame();
+	heapFrame();
+	visibleCount = 0;
+
+	const auto heapMs = bestOf(frames, heapFrame);
+	const auto visiblePerFrame = visibleCount.load() / frames;
+	const auto arenaMs = bestOf(frames, arenaFrame);
+	const auto heapAllocations = allocationsPerFrame(heapFrame);
+	const auto arenaAllocations = allocationsPerFrame(arenaFrame);
+
+	printf("\nframe scratch: %zu objects, %zu visible, %zu chunks on %u threads\n", count,
+		visiblePerFrame, (count + grain - 1) / grain, jobs.threadCount());
+	printf("%-28s %12s %14s\n", "scratch from", "ms", "allocs/frame");
+	printf("%-28s %12.3f %14.1f\n", "heap", heapMs, heapAllocations);
+	printf("%-28s %12.3f %14.1f\n", "frame arena", arenaMs, arenaAllocations);
+	printf("arena: high water %zu bytes of %zu in %zu frames in flight\n",
+		arenas.highWater(), arenas.capacity(), arenas.framesInFlight());
+}
+
+// CPU time to hand the driver N cubes from one arena page: one uniform update
+// and glDrawElementsBaseVertex per cube against one glMultiDrawElementsIndirect,
+// and against vertex pulling with the cubes split over two vertex formats.
+// glFinish runs outside the timed region, so only submission cost is measured.
+void benchIndirectSubmission()
+{
+	const uint32_t meshCount = 256;
+	const uint32_t drawCount = 16384;
+
+	glsl::GeometryArena arena{ positionLayout() };
+	const auto meshes = addCubes(arena, meshCount);
+
+	mt19937 rng{ 7 };
+	uniform_real_distribution<float> dist{ -50.0f, 50.0f };
+	vector<glm::mat4> models(drawCount);
+	for (auto& m : models)
+		m = glm::translate(glm::mat4{ 1.0f }, glm::vec3{ dist(rng), dist(rng), dist(rng) - 100.0f });
+
+	const auto viewProjection = glm::perspective(glm::radians(45.0f), 1.0f, 0.1f, 500.0f);
+
+	glsl::Program perDraw{
+		{ glsl::vertex_shader  , "resources/shaders/bench_per_draw.vs"s },
+		{ glsl::fragment_shader, "resources/shaders/bench.fs"s }
+	};
+	glsl::Program indirect{
+		{ glsl::vertex_shader  , "resources/shaders/bench_indirect.vs"s },
+		{ glsl::fragment_shader, "resources/shaders/bench.fs"s }
+	};
+
+	perDraw.use();
+	perDraw.uniform("viewProjection", viewProjection);
+	const auto modelLocation = glGetUniformLocation(perDraw, "model");
+	indirect.use();
+	indirect.uniform("viewProjection", viewProjection);
+
+	glsl::IndirectDrawBatch batch{ drawCount };
+
+	const auto loopMs = bestOf(10, [&]
+	{
+		perDraw.use();
+		for (uint32_t i = 0; i < drawCount; ++i)
+		{
+			const auto& mesh = meshes[i % meshCount];
+			arena.vertexArray(mesh.page).bind();
+			glUniformMatrix4fv(modelLocation, 1, GL_FALSE, &models[i][0][0]);
+			glDrawElementsBaseVertex(GL_TRIANGLES, mesh.indexCount, GL_UNSIGNED_INT,
+				reinterpret_cast<const void*>(static_cast<uintptr_t>(mesh.firstIndex) * sizeof(GLuint)), mesh.baseVertex);
+		}
+	});
+	glFinish();
+
+	// the same cubes baked into world space chunks, one draw per visible chunk
+	glsl::StaticBatch statics{ arena, 8192 };
+	for (uint32_t i = 0; i < drawCount; ++i)
+		statics.add(0, g_cubeCorners, g_cubeIndices, models[i]);
+	statics.build();
+
+	const auto frustum = common::Frustum::fromMatrix(viewProjection);
+	const auto identity = glm::mat4{ 1.0f };
+	const auto staticMs = bestOf(10, [&]
+	{
+		perDraw.use();
+		glUniformMatrix4fv(modelLocation, 1, GL_FALSE, &identity[0][0]);
+		for (const auto& chunk : statics.chunks())
+		{
+			if (!frustum.intersects(chunk.bounds))
+				continue;
+
+			arena.vertexArray(chunk.mesh.page).bind();
+			glDrawElementsBaseVertex(GL_TRIANGLES, chunk.mesh.indexCount, GL_UNSIGNED_INT,
+				reinterpret_cast<const void*>(static_cast<uintptr_t>(chunk.mesh.firstIndex) * sizeof(GLuint)), chunk.mesh.baseVertex);
+		}
+	});
+	glFinish();
+
+	auto submitIndirect = [&](bool useCount)
+	{
+		batch.useIndirectCount(useCount);
+		const auto ms = bestOf(10, [&]
+		{
+			batch.clear();
+			for (uint32_t i = 0; i < drawCount; ++i)
+				batch.add(meshes[i % meshCount], models[i]);
+
+			batch.upload();
+			indirect.use();
+			batch.submit(arena);
+		});
+		glFinish();
+		return ms;
+	};
+
+	const auto indirectMs = submitIndirect(false);
+
+	// every other cube stores its corners as 16-bit snorm instead of floats
+	glsl::PulledGeometry pulled{ { positionLayout(), { 8, { { 0, 3, GL_SHORT, 0, true } } } } };
+	array<array<int16_t, 4>, 8> snormCorners;
+	for (size_t i = 0; i < g_cubeCorners.size(); ++i)
+	{
+		for (int k = 0; k < 3; ++k)
+			snormCorners[i][k] = static_cast<int16_t>(g_cubeCorners[i][k] * 32767.0f);
+		snormCorners[i][3] = 0;
+	}
+
+	vector<glsl::PulledMesh> pulledMeshes;
+	for (uint32_t i = 0; i < meshCount; ++i)
+	{
+		pulledMeshes.push_back(i % 2
+			? pulled.add(1, snormCorners, g_cubeIndices)
+			: pulled.add(0, g_cubeCorners, g_cubeIndices));
+	}
+
+	glsl::Program pulling{
+		{ glsl::vertex_shader  , "resources/shaders/bench_pulled.vs"s, pulled.shaderSource() },
+		{ glsl::fragment_shader, "resources/shaders/bench.fs"s }
+	};
+	pulling.use();
+	pulling.uniform("viewProjection", viewProjection);
+
+	batch.useIndirectCount(false);
+	const auto pulledMs = bestOf(10, [&]
+	{
+		batch.clear();
+		for (uint32_t i = 0; i < drawCount; ++i)
+			pulled.addDraw(batch, pulledMeshes[i % meshCount], models[i]);
+
+		batch.upload();
+		pulling.use();
+		pulled.bind();
+		batch.submit(pulled.vertexArray());
+	});
+	glFinish();
+
+	printf("\nsubmission: %u draws of %u meshes\n", drawCount, meshCount);
+	printf("%-28s %12s %10s\n", "path", "ms", "speedup");
+	printf("%-28s %12.3f %9.2fx\n", "per-draw loop", loopMs, 1.0);
+	printf("%-28s %12.3f %9.2fx\n", "multi-draw indirect", indirectMs, loopMs / indirectMs);
+	printf("%-28s %12.3f %9.2fx\n", "vertex pulling, 2 formats", pulledMs, loopMs / pulledMs);
+	printf("static batch, %3zu chunks    %12.3f %9.2fx\n", statics.chunks().size(), staticMs, loopMs / staticMs);
+
+	if (glsl::IndirectDrawBatch::indirectCountSupported())
+	{
+		const auto countMs = submitIndirect(true);
+		printf("%-28s %12.3f %9.2fx\n", "multi-draw indirect count", countMs, loopMs / countMs);
+	}
+}
+
+// Culls many boxes with GpuCuller and checks the visible count against
+// Frustum::intersects on the CPU, then draws the survivors and checks that
+// exactly their triangles went down the pipeline. Returns false on a
+// mismatch, so running the bench with LIBGL_ALWAYS_SOFTWARE=1 doubles as a
+// check under llvmpipe.
+bool benchGpuCulling()
+{
+	const uint32_t drawCount = 1 << 16;
+
+	glsl::GeometryArena arena{ positionLayout() };
+	const auto mesh = addCubes(arena, 1).front();
+
+	const auto viewProjection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 300.0f)
+		* glm::lookAt(glm::vec3{ 0.0f }, glm::vec3{ 1.0f, 0.2f, -1.0f }, glm::vec3{ 0.0f, 1.0f, 0.0f });
+	const auto frustum = common::Frustum::fromMatrix(viewProjection);
+
+	// A box that just touches a plane may land on either side depending on
+	// how the GPU rounds, so the boxes keep clear of them and the two counts
+	// can be compared exactly.
+	auto touchesPlane = [&](const glm::vec3& center, const glm::vec3& extent)
+	{
+		for (const auto& p : frustum.planes)
+		{
+			const auto r = extent.x * abs(p.x) + extent.y * abs(p.y) + extent.z * abs(p.z);
+			if (abs(p.x * center.x + p.y * center.y + p.z * center.z + p.w + r) < 0.01f)
+				return true;
+		}
+		return false;
+	};
+
+	mt19937 rng{ 11 };
+	uniform_real_distribution<float> dist{ -200.0f, 200.0f };
+	uniform_real_distribution<float> size{ 0.5f, 4.0f };
+
+	vector<common::Aabb> bounds(drawCount);
+	glsl::IndirectDrawBatch batch{ drawCount };
+	for (auto& box : bounds)
+	{
+		glm::vec3 center, extent;
+		do
+		{
+			center = glm::vec3{ dist(rng), dist(rng), dist(rng) };
+			extent = glm::vec3{ size(rng) };
+		} while (touchesPlane(center, extent));
+
+		box = { center - extent, center + extent };
+		batch.add(mesh, glm::translate(glm::mat4{ 1.0f }, center));
+	}
+	batch.upload();
+
+	glsl::GpuCuller culler{ drawCount };
+	culler.setBounds(bounds);
+
+	uint32_t cpuVisible = 0;
+	const auto cpuMs = bestOf(10, [&]
+	{
+		cpuVisible = 0;
+		for (const auto& box : bounds)
+			cpuVisible += frustum.intersects(box) ? 1 : 0;
+	});
+
+	const auto gpuMs = bestOf(10, [&]
+	{
+		culler.cull(batch, frustum);
+		glFinish();
+	});
+	const auto gpuVisible = culler.readVisibleCount();
+
+	printf("\ngpu culling: %u boxes, %s\n", drawCount, culler.compacting() ? "compacted with indirect count" : "in place, instanceCount 0");
+	printf("%-28s %12s %10s\n", "path", "ms", "visible");
+	printf("%-28s %12.3f %10u\n", "cpu frustum loop", cpuMs, cpuVisible);
+	printf("%-28s %12.3f %10u\n", "compute shader + finish", gpuMs, gpuVisible);
+
+	if (gpuVisible != cpuVisible)
+	{
+		printf("gpu culling: MISMATCH\n");
+		return false;
+	}
+
+	// culled commands must draw nothing, the survivors a whole cube each
+	glsl::Program program{
+		{ glsl::vertex_shader  , "resources/shaders/bench_indirect.vs"s },
+		{ glsl::fragment_shader, "resources/shaders/bench.fs"s }
+	};
+	program.use();
+	program.uniform("viewProjection", viewProjection);
+
+	GLuint query = 0;
+	glCreateQueries(GL_PRIMITIVES_GENERATED, 1, &query);
+	glBeginQuery(GL_PRIMITIVES_GENERATED, query);
+	culler.submit(arena, batch);
+	glEndQuery(GL_PRIMITIVES_GENERATED);
+
+	GLuint primitives = 0;
+	glGetQueryObjectuiv(query, GL_QUERY_RESULT, &primitives);
+	glDeleteQueries(1, &query);
+
+	const auto expected = gpuVisible * static_cast<GLuint>(g_cubeIndices.size() / 3);
+	printf("%-28s %12s %10u triangles\n", "draw survivors", "", primitives);
+
+	if (primitives != expected)
+	{
+		printf("gpu culling: drew %u triangles, expected %u\n", primitives, expected);
+		return false;
+	}
+
+	return true;
+}
+
+// One million rotated, tinted sprites per frame spread over four atlases,
+// interleaved every 16 sprites so the batch has to regroup them.
+void benchSprites()
+{
+	const uint32_t spriteCount = 1 << 20;
+
+	array<glsl::Texture, 4> atlases{
+		glsl::Texture{ GL_TEXTURE_2D_ARRAY }, glsl::Texture{ GL_TEXTURE_2D_ARRAY },
+		glsl::Texture{ GL_TEXTURE_2D_ARRAY }, glsl::Texture{ GL_TEXTURE_2D_ARRAY }
+	};
+	for (auto& atlas : atlases)
+		atlas.storage3D(1, GL_RGBA8, 16, 16, 4);
+
+	glsl::SpriteBatch batch{ spriteCount };
+	batch.setProjection(glm::ortho(0.0f, 64.0f, 0.0f, 64.0f));
+
+	auto submit = [&]
+	{
+		glsl::Sprite sprite;
+		sprite.size = glm::vec2{ 0.5f };
+		for (uint32_t i = 0; i < spriteCount; ++i)
+		{
+			sprite.position = glm::vec2{ static_cast<float>(i & 1023) * 0.0625f, static_cast<float>(i >> 10) * 0.0625f };
+			sprite.rotation = static_cast<float>(i) * 0.001f;
+			sprite.layer = i & 3;
+			sprite.texture = atlases[(i >> 4) & 3];
+			batch.draw(sprite);
+		}
+		batch.flush();
+	};
+
+	// the first frames warm up the driver and the three stream regions
+	for (uint32_t i = 0; i < glsl::SpriteBatch::region_count; ++i)
+		submit();
+	glFinish();
+	batch.resetStats();
+
+	const auto submitMs = bestOf(10, submit);
+	const auto frameMs = bestOf(5, [&]
+	{
+		submit();
+		glFinish();
+	});
+
+	const auto& stats = batch.stats();
+	printf("\nsprites: %u per frame, %llu draws per flush, %llu fence waits\n", spriteCount,
+		static_cast<unsigned long long>(stats.draws / max<uint64_t>(stats.flushes, 1)),
+		static_cast<unsigned long long>(stats.fenceWaits));
+	printf("%-28s %12.3f\n", "cpu submit ms", submitMs);
+	printf("%-28s %12.3f\n", "submit + finish ms", frameMs);
+}
+
+// The ways a sample can set a per-object matrix: Program::uniform, which
+// finds the location it cached by name, a glGetUniformLocation per call, a
+// location looked up once, and glProgramUniformMatrix4fv, which needs no
+// bound program.
+void benchUniforms()
+{
+	const uint32_t updateCount = 16384;
+
+	mt19937 rng{ 17 };
+	uniform_real_distribution<float> dist{ -50.0f, 50.0f };
+	vector<glm::mat4> models(updateCount);
+	for (auto& m : models)
+		m = glm::translate(glm::mat4{ 1.0f }, glm::vec3{ dist(rng), dist(rng), dist(rng) });
+
+	glsl::Program program{
+		{ glsl::vertex_shader  , "resources/shaders/bench_per_draw.vs"s },
+		{ glsl::fragment_shader, "resources/shaders/bench.fs"s }
+	};
+	program.use();
+
+	const auto byNameMs = bestOf(10, [&]
+	{
+		for (const auto& model : models)
+			program.uniform("model", model);
+	});
+	glFinish();
+
+	const auto lookupMs = bestOf(10, [&]
+	{
+		for (const auto& model : models)
+			glUniformMatrix4fv(glGetUniformLocation(program, "model"), 1, GL_FALSE, &model[0][0]);
+	});
+	glFinish();
+
+	const auto location = glGetUniformLocation(program, "model");
+	const auto cachedMs = bestOf(10, [&]
+	{
+		for (const auto& model : models)
+			glUniformMatrix4fv(location, 1, GL_FALSE, &model[0][0]);
+	});
+	glFinish();
+
+	const auto dsaMs = bestOf(10, [&]
+	{
+		for (const auto& model : models)
+			glProgramUniformMatrix4fv(program, location, 1, GL_FALSE, &model[0][0]);
+	});
+	glFinish();
+
+	printf("\nuniform upload: %u mat4 updates\n", updateCount);
+	printf("%-28s %12s %10s %10s\n", "path", "ms", "ns each", "speedup");
+
+	auto print = [&](const char* name, double ms)
+	{
+		printf("%-28s %12.3f %10.1f %9.2fx\n", name, ms, ms * 1e6 / updateCount, byNameMs / ms);
+	};
+	print("Program::uniform", byNameMs);
+	print("location lookup per call", lookupMs);
+	print("cached location", cachedMs);
+	print("glProgramUniform", dsaMs);
+}
+
+// Reading, compiling and linking the sample programs. A driver with a
+// shader cache builds repeats faster, so the first build is shown next to
+// the best of the rest.
+void benchShaderLoading()
+{
+	const char* const samples[] = { "2.4.1_hello_triangle", "2.6.3_texture", "2.8.3_transform", "2.9.1_camera" };
+
+	printf("\nshader loading: glsl::Program from the sample shaders\n");
+	printf("%-28s %12s %10s\n", "program", "first ms", "best ms");
+
+	for (const auto name : samples)
+	{
+		const auto path = "resources/shaders/"s + name;
+		auto build = [&]
+		{
+			glsl::Program program{
+				{ glsl::vertex_shader  , path + ".vs" },
+				{ glsl::fragment_shader, path + ".fs" }
+			};
+		};
+
+		const auto firstMs = bestOf(1, build);
+		const auto bestMs = bestOf(5, build);
+		printf("%-28s %12.3f %10.3f\n", name, firstMs, bestMs);
+	}
+}
+
+// The CPU benchmarks need no GL context and run first; --cpu-only stops
+// after them, --gpu-only skips them and fails without a GL 4.5 context.
+// Every other argument is the context's, checked up front so a mistyped
+// option fails before the CPU benchmarks have run.
+int main(int argc, char** argv)
+try
+{
+	vector<char*> contextArgs;
+	auto cpuOnly = false;
+	auto gpuOnly = false;
+	for (int i = 0; i < argc; ++i)
+	{
+		if (i > 0 && !strcmp(argv[i], "--cpu-only"))
+			cpuOnly = true;
+		else if (i > 0 && !strcmp(argv[i], "--gpu-only"))
+			gpuOnly = true;
+		else
+			contextArgs.push_back(argv[i]);
+	}
+
+	argc = static_cast<int>(contextArgs.size());
+	argv = contextArgs.data();
+	glsl::ContextOptions::fromCommandLine(argc, argv, {});
+
+	if (!gpuOnly)
+	{
+		benchJobScaling();
+		benchMatrixMath();
+		benchImageDecode();
+		benchMeshProcessing();
+		benchFrameScratch();
+	}
+
+	if (cpuOnly)
+	{
+		printf("\nGL benchmarks: skipped, --cpu-only\n");
+		return 0;
+	}
+
+	auto ok = true;
+	if (auto context = createBenchContext(argc, argv))
+	{
+		benchUniforms();
+		benchShaderLoading();
+
+		benchIndirectSubmission();
+		ok = benchGpuCulling();
+		benchSprites();
+	}
+	else
+	{
+		printf("\nGL benchmarks: skipped, no GL 4.5 context\n");
+
+		// asked for the GL part alone, e.g. by ctest: nothing checked is a failure
+		ok = !gpuOnly;
+	}
+
+	return ok ? 0 : 1;
+}
+catch (const exception& e)
+{
+	fprintf(stderr, "%s\n", e.what());
+	return 1;
+}
@@ -0,0 +1,206 @@
+#include <frame_arena.hpp>
+#include <jobs.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+using namespace std;
+
+// Checks LinearArena and FrameArena on their own: alignment, overflow
+// blocks and how reset() grows the buffer, sizes too large to allocate,
+// and allocating from many threads at once. Exits with 1 if any check
+// failed.
+
+namespace {
+
+	int failures = 0;
+
+	void check(bool condition, const char* what)
+	{
+		if (!condition)
+		{
+			cerr << "FAILED: " << what << endl;
+			++failures;
+		}
+	}
+
+	bool aligned(const void* p, size_t alignment)
+	{
+		return reinterpret_cast<uintptr_t>(p) % alignment == 0;
+	}
+
+	void testAllocation()
+	{
+		common::LinearArena arena{ 1024 };
+
+		const auto a = arena.allocate(3, 1);
+		const auto b = arena.allocate(8, 8);
+		const auto c = arena.allocate(100, 64);
+		check(aligned(b, 8) && aligned(c, 64), "allocations honor their alignment");
+		check(static_cast<char*>(b) >= static_cast<char*>(a) + 3 && static_cast<char*>(c) >= static_cast<char*>(b) + 8,
+			"allocations do not overlap");
+		check(arena.used() >= 111 && arena.used() <= 111 + 7 + 63, "used counts the bytes and the padding");
+		check(arena.overflows() == 0, "allocations within the capacity need no overflow block");
+
+		const auto ints = arena.allocate<uint32_t>(16);
+		check(aligned(ints, alignof(uint32_t)), "typed allocations are aligned for their type");
+
+		arena.reset();
+		check(arena.used() == 0, "reset drops everything");
+		check(arena.allocate(3, 1) == a, "after a reset allocation starts over at the front");
+	}
+
+	void testOverflow()
+	{
+		common::LinearArena arena{ 256 };
+
+		// one frame that needs four times the capacity
+		vector<void*> blocks;
+		for (int i = 0; i < 16; ++i)
+		{
+			const auto p = arena.allocate(64, 16);
+			memset(p, i, 64);
+			blocks.push_back(p);
+		}
+
+		check(arena.overflows() > 0, "allocations past the capacity come from overflow blocks");
+		check(all_of(blocks.begin(), blocks.end(), [](void* p) { return aligned(p, 16); }), "overflow blocks honor the alignment");
+
+		auto intact = true;
+		for (int i = 0; i < 16; ++i)
+		{
+			const auto bytes = static_cast<const unsigned char*>(blocks[i]);
+			intact = intact && all_of(bytes, bytes + 64, [i](unsigned char b) { return b == i; });
+		}
+		check(intact, "overflow blocks do not overlap the buffer or each other");
+
+		const auto used = arena.used();
+		check(used >= 16 * 64, "used includes the overflow bytes");
+
+		arena.reset();
+		check(arena.capacity() >= used, "reset grows the buffer to what the frame used");
+		check(arena.highWater() == used, "the high water mark survives the reset");
+		check(arena.used() == 0 && arena.overflows() == 0, "reset frees the overflow blocks");
+
+		for (int i = 0; i < 16; ++i)
+			arena.allocate(64, 16);
+		check(arena.overflows() == 0, "the same frame fits after the reset");
+
+		// a small overflow still at least doubles the buffer
+		common::LinearArena small{ 1000 };
+		small.allocate(1000, 1);
+		small.allocate(1, 1);
+		small.reset();
+		check(small.capacity() == 2000, "reset at least doubles the capacity");
+
+		// without an overflow reset keeps the buffer
+		small.allocate(10, 1);
+		small.reset();
+		check(small.capacity() == 2000, "reset without an overflow keeps the capacity");
+	}
+
+	void testTooLarge()
+	{
+		common::LinearArena arena{ 1024 };
+		arena.allocate(16, 16);
+
+		auto throws = [](auto&& fn)
+		{
+			try
+			{
+				fn();
+			}
+			catch (const exception&)
+			{
+				// length_error from the arena, bad_alloc from new[]
+				return true;
+			}
+			return false;
+		};
+
+		const auto max = numeric_limits<size_t>::max();
+		check(throws([&] { arena.allocate(max - 8, 16); }), "a byte count that wraps the offset is rejected");
+		check(throws([&] { arena.allocate(max, 1); }), "the largest byte count is rejected");
+		check(throws([&] { arena.allocate<uint64_t>(max / 4); }), "a count whose size wraps is rejected");
+		check(arena.used() == 16, "rejected allocations leave the arena as it was");
+	}
+
+	void testThreads()
+	{
+		common::JobSystem jobs{ 4 };
+		common::LinearArena arena{ 16 * 1024 };
+
+		// enough to overflow, so both paths race
+		constexpr size_t count = 4096;
+		vector<uint32_t*> blocks(count);
+		jobs.parallelFor(0, count, 16, [&](size_t first, size_t last)
+		{
+			for (auto i = first; i < last; ++i)
+			{
+				auto p = arena.allocate<uint32_t>(4);
+				fill(p, p + 4, static_cast<uint32_t>(i));
+				blocks[i] = p;
+			}
+		});
+
+		auto intact = true;
+		for (size_t i = 0; i < count; ++i)
+			intact = intact && all_of(blocks[i], blocks[i] + 4, [i](uint32_t v) { return v == i; });
+
+		check(intact, "allocations from many threads do not overlap");
+		check(arena.overflows() > 0, "threads overflowing the buffer share the overflow blocks");
+	}
+
+	void testFrameArena()
+	{
+		common::FrameArena frames{ 3, 128 };
+		check(frames.framesInFlight() == 3 && frames.capacity() == 3 * 128, "every slot gets the capacity");
+
+		auto& first = frames.begin(0);
+		first.allocate(64, 1);
+		auto& second = frames.begin(1);
+		check(&first != &second, "frames in flight get their own arena");
+		check(&frames[3] == &first, "frame n reuses the slot of frame n - framesInFlight");
+
+		frames.begin(3);
+		check(first.used() == 0, "beginning a frame resets its slot");
+
+		common::ArenaVector<int> values{ common::ArenaAllocator<int>{ second } };
+		values.reserve(10);
+		for (int i = 0; i < 10; ++i)
+			values.push_back(i);
+		check(second.used() >= 10 * sizeof(int), "ArenaVector takes its storage from the arena");
+
+		auto threw = false;
+		try
+		{
+			common::FrameArena none{ 0 };
+		}
+		catch (const invalid_argument&)
+		{
+			threw = true;
+		}
+		check(threw, "zero frames in flight is rejected");
+	}
+}
+
+int main()
+{
+	testAllocation();
+	testOverflow();
+	testTooLarge();
+	testThreads();
+	testFrameArena();
+
+	if (failures)
+	{
+		cerr << failures << " checks failed" << endl;
+		return 1;
+	}
+
+	cout << "all checks passed" << endl;
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,79 @@
+#include <app_context.hpp>
+#include <gl_capture.hpp>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+using namespace std;
+
+// Plays a capture made with --capture FILE back headless, as fast as the
+// context goes:
+//   glreplay FILE [--headless=egl|osmesa] [--bench] [--warmup M]
+//                 [--bench-out FILE] [--gl-trace[=timing]] [--trace FILE]
+// With --bench the replayed frames after warmup are timed and reported the
+// way the samples report theirs, so two builds can be compared on the same
+// call stream.
+
+// A headless context of the capture's size with GL 4.6, 4.5 or 3.3 core,
+// the newest there is.
+unique_ptr<glsl::AppContext> createReplayContext(int argc, char** argv, const glsl::GlReplay& replay)
+{
+	const int versions[][2] = { { 4, 6 }, { 4, 5 }, { 3, 3 } };
+	string error;
+
+	for (const auto& version : versions)
+	{
+		glsl::ContextOptions defaults{ replay.width(), replay.height(), "glreplay", version[0], version[1] };
+		defaults.backend = glsl::AppContext::backendAvailable(glsl::ContextBackend::egl)
+			? glsl::ContextBackend::egl
+			: glsl::ContextBackend::osmesa;
+		defaults.frames = replay.frames();
+		defaults.vsync = false;
+
+		auto options = glsl::ContextOptions::fromCommandLine(argc, argv, defaults);
+		if (options.bench)
+			options.frames = replay.frames() > options.warmup ? replay.frames() - options.warmup : 1;
+
+		try
+		{
+			return make_unique<glsl::AppContext>(options);
+		}
+		catch (const runtime_error& e)
+		{
+			error = e.what();
+		}
+	}
+
+	throw runtime_error{ error };
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 2 || argv[1][0] == '-')
+	{
+		cerr << "usage: glreplay FILE [--headless=egl|osmesa] [--bench] [--warmup M] [--bench-out FILE] [--gl-trace[=timing]] [--trace FILE]" << endl;
+		return 2;
+	}
+
+	try
+	{
+		glsl::GlReplay replay{ argv[1] };
+		auto context = createReplayContext(argc, argv, replay);
+		replay.setDefaultFramebuffer(context->framebuffer());
+
+		while (context->running() && replay.playFrame())
+			context->swapBuffers();
+
+		if (!context->options().bench)
+			printf("replayed %llu calls in %llu frames\n",
+				static_cast<unsigned long long>(replay.played()),
+				static_cast<unsigned long long>(context->frame()));
+	}
+	catch (const exception& e)
+	{
+		cerr << e.what() << endl;
+		return 1;
+	}
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,231 @@
+#include <image_diff.hpp>
+#include "stb_image.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+using namespace std;
+
+// Renders every sample headless and compares its last frame with a stored
+// golden image, so a change to the render path can be checked for changed
+// output:
+//   golden_images [--update] [--frames N] [--tolerance T] [--min-psnr DB]
+//                 [--max-differing PERCENT] [--headless=egl|osmesa]
+//                 [--bin DIR] [--golden DIR] [--out DIR] [sample ..]
+// Run it from the install directory, where the samples find their
+// resources. A sample is either a name, looked up in --bin, or the path to
+// its executable, which is how ctest runs it from the source tree. Each
+// sample runs with --frames N --screenshot, and headless time advances a
+// fixed step per frame, so frame N shows the same moment every run. A
+// sample passes when at most PERCENT of its pixels have a channel more than
+// T away from the golden one and the PSNR is at least DB. --update stores
+// the rendered frames as the new golden images; they are only comparable on
+// the driver they were made with. The exit code is 1 if any sample failed.
+
+namespace fs = std::filesystem;
+
+const char* const all_samples[] = {
+	"2.3.1_hello-window",
+	"2.4.1_hello-triangle",
+	"2.4.2_hello-triangle",
+	"2.6.1_texture",
+	"2.6.2_texture",
+	"2.6.3_texture",
+	"2.8.1_transform",
+	"2.8.2_transform",
+	"2.8.3_transform",
+	"2.9.1_camera"
+};
+
+struct Settings {
+	bool update = false;
+	unsigned long long frames = 30;
+	unsigned tolerance = 2;
+	double minPsnr = 40.0;
+	double maxDiffering = 0.1;          // percent of the pixels
+	string headless = "--headless";
+	fs::path bin = ".";
+	fs::path golden = "resources/golden";
+	fs::path out = "golden_out";
+	vector<string> samples;
+};
+
+struct Image {
+	int width = 0;
+	int height = 0;
+	vector<unsigned char> rgba;
+};
+
+Settings parseSettings(int argc, char** argv)
+{
+	Settings settings;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		const auto arg = argv[i];
+		const auto hasValue = i + 1 < argc;
+
+		if (!strcmp(arg, "--update"))
+			settings.update = true;
+		else if (!strcmp(arg, "--frames") && hasValue)
+			settings.frames = strtoull(argv[++i], nullptr, 10);
+		else if (!strcmp(arg, "--tolerance") && hasValue)
+			settings.tolerance = static_cast<unsigned>(strtoul(argv[++i], nullptr, 10));
+		else if (!strcmp(arg, "--min-psnr") && hasValue)
+			settings.minPsnr = strtod(argv[++i], nullptr);
+		else if (!strcmp(arg, "--max-differing") && hasValue)
+			settings.maxDiffering = strtod(argv[++i], nullptr);
+		else if (!strncmp(arg, "--headless", 10))
+			settings.headless = arg;
+		else if (!strcmp(arg, "--bin") && hasValue)
+			settings.bin = argv[++i];
+		else if (!strcmp(arg, "--golden") && hasValue)
+			settings.golden = argv[++i];
+		else if (!strcmp(arg, "--out") && hasValue)
+			settings.out = argv[++i];
+		else if (arg[0] == '-')
+			throw invalid_argument{ string{ "unknown option " } + arg };
+		else
+			settings.samples.push_back(arg);
+	}
+
+	if (settings.samples.empty())
+		settings.samples.assign(begin(all_samples), end(all_samples));
+
+	if (!settings.frames)
+		throw invalid_argument{ "--frames must be positive" };
+
+	return settings;
+}
+
+bool loadImage(const fs::path& path, Image& image)
+{
+	int channels;
+	auto data = stbi_load(path.string().c_str(), &image.width, &image.height, &channels, 4);
+	if (!data)
+		return false;
+
+	image.rgba.assign(data, data + static_cast<size_t>(image.width) * image.height * 4);
+	stbi_image_free(data);
+	return true;
+}
+
+// The executable's file name without .exe; fs::path::stem() would cut
+// "2.6.1_texture" at the first dot.
+string sampleName(const string& sample)
+{
+	auto name = fs::path{ sample }.filename().string();
+	const string suffix = ".exe";
+	if (name.size() > suffix.size() && name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0)
+		name.resize(name.size() - suffix.size());
+
+	return name;
+}
+
+bool render(const string& sample, const Settings& settings, const fs::path& screenshot)
+{
+	error_code error;
+	fs::remove(screenshot, error);
+
+	fs::path executable = sample;
+	if (!executable.has_parent_path())
+	{
+#if defined(_WIN32)
+		executable = settings.bin / (sample + ".exe");
+#else
+		executable = settings.bin / sample;
+#endif
+	}
+
+#if defined(_WIN32)
+	// the samples are GUI programs, which cmd does not wait for by itself
+	auto command = "start \"\" /wait \"" + executable.string() + "\"";
+#else
+	auto command = "\"" + executable.string() + "\"";
+#endif
+
+	command += " " + settings.headless + " --frames " + to_string(settings.frames) + " --screenshot \"" + screenshot.string() + "\"";
+
+	return system(command.c_str()) == 0 && fs::exists(screenshot);
+}
+
+// Prints the sample's line of the report; true if it passed.
+bool check(const string& sample, const Settings& settings)
+{
+	const auto title = sampleName(sample);
+	const auto name = title + ".png";
+	const auto screenshot = settings.out / name;
+	const auto golden = settings.golden / name;
+
+	if (!render(sample, settings, screenshot))
+	{
+		printf("%-22s FAIL   did not render\n", title.c_str());
+		return false;
+	}
+
+	if (settings.update)
+	{
+		fs::create_directories(settings.golden);
+		fs::copy_file(screenshot, golden, fs::copy_options::overwrite_existing);
+		printf("%-22s UPDATE %s\n", title.c_str(), golden.string().c_str());
+		return true;
+	}
+
+	Image expected, actual;
+	if (!loadImage(golden, expected))
+	{
+		printf("%-22s FAIL   no golden image %s\n", title.c_str(), golden.string().c_str());
+		return false;
+	}
+
+	if (!loadImage(screenshot, actual))
+	{
+		printf("%-22s FAIL   cannot read %s\n", title.c_str(), screenshot.string().c_str());
+		return false;
+	}
+
+	if (expected.width != actual.width || expected.height != actual.height)
+	{
+		printf("%-22s FAIL   %dx%d, golden image is %dx%d\n", title.c_str(),
+			actual.width, actual.height, expected.width, expected.height);
+		return false;
+	}
+
+	const auto diff = common::diffRgba(expected.rgba.data(), actual.rgba.data(), expected.rgba.size() / 4, settings.tolerance);
+	const auto differing = 100.0 * static_cast<double>(diff.differing) / static_cast<double>(diff.pixels);
+	const auto passed = differing <= settings.maxDiffering && diff.psnr >= settings.minPsnr;
+
+	printf("%-22s %-6s psnr %7.2f dB  max delta %3u  differing %8zu (%.3f%%)\n", title.c_str(),
+		passed ? "ok" : "FAIL", diff.psnr, diff.maxDelta, diff.differing, differing);
+
+	return passed;
+}
+
+int main(int argc, char** argv)
+{
+	try
+	{
+		const auto settings = parseSettings(argc, argv);
+		fs::create_directories(settings.out);
+
+		size_t failed = 0;
+		for (const auto& sample : settings.samples)
+		{
+			if (!check(sample, settings))
+				++failed;
+		}
+
+		printf("%zu of %zu samples %s\n", settings.samples.size() - failed, settings.samples.size(),
+			settings.update ? "updated" : "match their golden images");
+
+		return failed ? 1 : 0;
+	}
+	catch (const exception& e)
+	{
+		cerr << e.what() << endl;
+		return 2;
+	}
+}
\ No newline at end of file
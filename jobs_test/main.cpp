@@ -0,0 +1,218 @@
+#include <jobs.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+using namespace std;
+
+// Checks JobSystem on its own: the workers' deques, counters with their
+// continuations, parallelFor's chunking and what the destructor drops.
+// Exits with 1 if any check failed.
+
+namespace {
+
+	int failures = 0;
+
+	void check(bool condition, const char* what)
+	{
+		if (!condition)
+		{
+			cerr << "FAILED: " << what << endl;
+			++failures;
+		}
+	}
+
+	// One thread, so every job stays in worker 0's deque until wait pops it
+	// from the bottom; past the deque's capacity run executes inline.
+	void testDeque()
+	{
+		common::JobSystem jobs{ 1 };
+
+		constexpr size_t count = 10000;
+		vector<int> runs(count);
+		vector<size_t> order;
+		order.reserve(count);
+
+		common::JobCounter counter;
+		for (size_t i = 0; i < count; ++i)
+		{
+			jobs.run([&runs, &order, i]
+			{
+				++runs[i];
+				order.push_back(i);
+			}, &counter);
+		}
+
+		jobs.wait(counter);
+
+		check(counter.done(), "the counter is done after wait");
+		check(all_of(begin(runs), end(runs), [](int n) { return n == 1; }), "every job ran exactly once");
+		check(order.size() == count && order.back() == 0, "the owner pops its deque last in, first out");
+	}
+
+	// Jobs submitted from worker 0 are stolen by the others.
+	void testStealing()
+	{
+		common::JobSystem jobs{ 4 };
+
+		mutex workersMutex;
+		vector<unsigned> workers;
+
+		common::JobCounter counter;
+		for (int i = 0; i < 200; ++i)
+		{
+			jobs.run([&]
+			{
+				this_thread::sleep_for(chrono::microseconds(200));
+				lock_guard<mutex> lock{ workersMutex };
+				workers.push_back(jobs.workerIndex());
+			}, &counter);
+		}
+
+		jobs.wait(counter);
+
+		check(workers.size() == 200, "every stolen job ran");
+		check(all_of(begin(workers), end(workers), [&](unsigned w) { return w < jobs.threadCount(); }), "jobs only run on workers or the waiting thread");
+
+		sort(begin(workers), end(workers));
+		check(unique(begin(workers), end(workers)) - begin(workers) > 1, "idle workers steal from worker 0");
+	}
+
+	void testCounters()
+	{
+		common::JobSystem jobs{ 4 };
+
+		// a chain of continuations runs in dependency order
+		vector<int> order;
+		common::JobCounter first, second, third;
+		jobs.run([&]
+		{
+			this_thread::sleep_for(chrono::milliseconds(5));
+			order.push_back(1);
+		}, &first);
+		jobs.runAfter(first, [&] { order.push_back(2); }, &second);
+		jobs.runAfter(second, [&] { order.push_back(3); }, &third);
+
+		jobs.wait(third);
+		check(order == vector<int>{ 1, 2, 3 }, "continuations run after their dependency, in order");
+
+		// a continuation on a counter that is already done runs right away
+		common::JobCounter done, after;
+		auto ran = false;
+		jobs.runAfter(done, [&] { ran = true; }, &after);
+		jobs.wait(after);
+		check(ran, "runAfter on a done counter runs the job");
+
+		// many continuations on one counter are all released
+		atomic<int> released{ 0 };
+		common::JobCounter gate, all;
+		jobs.run([] { this_thread::sleep_for(chrono::milliseconds(2)); }, &gate);
+		for (int i = 0; i < 100; ++i)
+			jobs.runAfter(gate, [&] { ++released; }, &all);
+
+		jobs.wait(all);
+		check(released == 100, "every continuation on a counter is released");
+
+		// a thread that is not a worker submits through the shared queue
+		atomic<int> fromOutside{ 0 };
+		thread outside{ [&]
+		{
+			check(jobs.workerIndex() == jobs.threadCount(), "workerIndex off the workers is threadCount");
+
+			common::JobCounter counter;
+			for (int i = 0; i < 100; ++i)
+				jobs.run([&] { ++fromOutside; }, &counter);
+
+			jobs.wait(counter);
+		} };
+		outside.join();
+		check(fromOutside == 100, "jobs submitted off the workers run");
+	}
+
+	void testParallelFor()
+	{
+		common::JobSystem jobs{ 4 };
+
+		struct Case {
+			size_t first, last, grain;
+		};
+
+		const Case cases[] = {
+			{ 0, 0, 0 },
+			{ 5, 6, 0 },
+			{ 3, 10003, 0 },
+			{ 7, 1000, 64 },
+			{ 0, 100, 100 },
+			{ 0, 100, 1000 },
+			{ 10, 300, 1 },
+		};
+
+		for (const auto& c : cases)
+		{
+			vector<atomic<int>> hits(c.last);
+			atomic<bool> chunksOk{ true };
+
+			jobs.parallelFor(c.first, c.last, c.grain, [&](size_t begin, size_t end)
+			{
+				if (begin >= end || (c.grain && (end - begin > c.grain || (begin - c.first) % c.grain)))
+					chunksOk = false;
+
+				for (auto i = begin; i < end; ++i)
+					++hits[i];
+			});
+
+			auto coverage = true;
+			for (size_t i = 0; i < c.last; ++i)
+				coverage = coverage && hits[i] == (i >= c.first ? 1 : 0);
+
+			check(coverage, "parallelFor visits every index in the range exactly once");
+			check(chunksOk, "parallelFor chunks start on the grain and stay within it");
+		}
+	}
+
+	// Whatever never ran is destroyed with the JobSystem: queued jobs and
+	// continuations parked on counters, pooled and heap ones alike.
+	void testDestructor()
+	{
+		auto token = make_shared<int>();
+		auto ran = false;
+
+		{
+			common::JobSystem jobs{ 1 };
+
+			common::JobCounter never;
+			jobs.run([token, &ran] { ran = true; }, &never);
+
+			for (size_t i = 0; i < common::JobSystem::job_pool_size + 100; ++i)
+				jobs.runAfter(never, [token, &ran] { ran = true; });
+
+			check(token.use_count() > 1, "jobs hold their captures while queued");
+		}
+
+		check(!ran, "dropped jobs do not run");
+		check(token.use_count() == 1, "the destructor destroys queued jobs and parked continuations");
+	}
+}
+
+int main()
+{
+	testDeque();
+	testStealing();
+	testCounters();
+	testParallelFor();
+	testDestructor();
+
+	if (failures)
+	{
+		cerr << failures << " checks failed" << endl;
+		return 1;
+	}
+
+	cout << "all checks passed" << endl;
+	return 0;
+}
\ No newline at end of file
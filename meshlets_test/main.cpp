@@ -0,0 +1,223 @@
+#include <meshlets.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+using namespace std;
+
+// Checks buildMeshlets and cullMeshlet on the CPU alone, no GL context
+// needed. The test mesh is a grid of quads in the z = 0 plane whose
+// triangles face +z. Exits with 1 if any check failed.
+
+namespace {
+
+	int failures = 0;
+
+	void check(bool condition, const char* what)
+	{
+		if (!condition)
+		{
+			cerr << "FAILED: " << what << endl;
+			++failures;
+		}
+	}
+
+	struct Grid {
+		vector<glm::vec3> positions;
+		vector<uint32_t> indices;
+	};
+
+	// size x size quads of 0.25 units, centered on the origin
+	Grid makeGrid(uint32_t size)
+	{
+		Grid grid;
+		for (uint32_t y = 0; y <= size; ++y)
+		{
+			for (uint32_t x = 0; x <= size; ++x)
+				grid.positions.emplace_back((x - size * 0.5f) * 0.25f, (y - size * 0.5f) * 0.25f, 0.0f);
+		}
+
+		for (uint32_t y = 0; y < size; ++y)
+		{
+			for (uint32_t x = 0; x < size; ++x)
+			{
+				const auto i = y * (size + 1) + x;
+				const auto j = i + size + 1;
+				grid.indices.insert(grid.indices.end(), { i, i + 1, j + 1, i, j + 1, j });
+			}
+		}
+		return grid;
+	}
+
+	common::MeshletMesh build(const Grid& grid, const common::MeshletLimits& limits)
+	{
+		return common::buildMeshlets(grid.positions.data(), sizeof(glm::vec3), grid.positions.size(),
+			grid.indices.data(), grid.indices.size(), limits);
+	}
+
+	common::Frustum frustumAt(const glm::vec3& eye, const glm::vec3& target)
+	{
+		const auto projection = glm::perspective(glm::radians(60.0f), 1.0f, 0.1f, 100.0f);
+		return common::Frustum::fromMatrix(projection * glm::lookAt(eye, target, glm::vec3{ 0.0f, 1.0f, 0.0f }));
+	}
+
+	void testLimits()
+	{
+		const auto grid = makeGrid(16);
+
+		const common::MeshletLimits limits[] = { { 3, 1 }, { 4, 2 }, { 16, 124 }, { 64, 8 }, { 64, 124 }, { 255, 512 } };
+		for (const auto& limit : limits)
+		{
+			const auto mesh = build(grid, limit);
+
+			check(mesh.indices == grid.indices, "meshlets keep the input triangles in input order");
+
+			auto withinLimits = true;
+			auto contiguous = true;
+			auto countsMatch = true;
+			auto boundsHold = true;
+			uint32_t next = 0;
+			for (const auto& m : mesh.meshlets)
+			{
+				vector<uint32_t> unique(mesh.indices.begin() + m.firstIndex, mesh.indices.begin() + m.firstIndex + m.triangleCount * 3);
+				sort(unique.begin(), unique.end());
+				unique.erase(std::unique(unique.begin(), unique.end()), unique.end());
+
+				withinLimits = withinLimits && m.triangleCount >= 1 && m.triangleCount <= limit.maxTriangles && unique.size() <= limit.maxVertices;
+				contiguous = contiguous && m.firstIndex == next;
+				countsMatch = countsMatch && m.vertexCount == unique.size();
+				for (auto v : unique)
+					boundsHold = boundsHold && glm::length(grid.positions[v] - m.center) <= m.radius * 1.0001f;
+
+				next = m.firstIndex + m.triangleCount * 3;
+			}
+
+			check(withinLimits, "every meshlet stays within its vertex and triangle limits");
+			check(contiguous && next == grid.indices.size(), "meshlets cover the indices back to back");
+			check(countsMatch, "vertexCount is the number of distinct vertices");
+			check(boundsHold, "the bounding sphere holds every vertex");
+		}
+
+		// the loosest limits put the whole grid in a few meshlets, the tightest one triangle each
+		check(build(grid, { 3, 1 }).meshlets.size() == grid.indices.size() / 3, "a one triangle limit gives one meshlet per triangle");
+		check(build(grid, { 255, 512 }).meshlets.size() == 2, "a 289 vertex grid needs two 255 vertex meshlets");
+
+		// a triangle repeating a vertex counts it once
+		const uint32_t degenerate[] = { 0, 0, 1 };
+		const auto single = common::buildMeshlets(grid.positions.data(), sizeof(glm::vec3), grid.positions.size(), degenerate, 3);
+		check(single.meshlets.size() == 1 && single.meshlets[0].vertexCount == 2, "a repeated vertex counts once");
+	}
+
+	void testInvalidInput()
+	{
+		const auto grid = makeGrid(2);
+
+		auto throws = [&](auto&& fn)
+		{
+			try
+			{
+				fn();
+			}
+			catch (const exception&)
+			{
+				return true;
+			}
+			return false;
+		};
+
+		check(throws([&] { build(grid, { 2, 124 }); }), "fewer than three vertices per meshlet is rejected");
+		check(throws([&] { build(grid, { 64, 0 }); }), "zero triangles per meshlet is rejected");
+		check(throws([&]
+		{
+			common::buildMeshlets(grid.positions.data(), sizeof(glm::vec3), grid.positions.size(), grid.indices.data(), 4);
+		}), "an index count that is no triangle list is rejected");
+
+		const uint32_t past[] = { 0, 1, 9 };
+		check(throws([&]
+		{
+			common::buildMeshlets(grid.positions.data(), sizeof(glm::vec3), grid.positions.size(), past, 3);
+		}), "an index past the vertex count is rejected");
+	}
+
+	void testConeCulling()
+	{
+		const auto mesh = build(makeGrid(16), {});
+		const glm::mat4 identity{ 1.0f };
+
+		check(all_of(mesh.meshlets.begin(), mesh.meshlets.end(), [](const common::Meshlet& m) { return m.coneCutoff < 0.01f; }),
+			"a flat grid gets a tight normal cone");
+
+		const glm::vec3 front{ 0.0f, 0.0f, 10.0f };
+		const glm::vec3 back{ 0.0f, 0.0f, -10.0f };
+		const glm::vec3 center{ 0.0f };
+
+		auto all = [&](const glm::mat4& model, const glm::vec3& eye, common::MeshletVisibility expected)
+		{
+			const auto frustum = frustumAt(eye, center);
+			return all_of(mesh.meshlets.begin(), mesh.meshlets.end(), [&](const common::Meshlet& m)
+			{
+				return common::cullMeshlet(m, model, eye, frustum) == expected;
+			});
+		};
+
+		check(all(identity, front, common::MeshletVisibility::visible), "meshlets facing the viewer are visible");
+		check(all(identity, back, common::MeshletVisibility::backfacing), "meshlets facing away are backface culled");
+
+		// turned around, the back is the front
+		const auto turned = glm::rotate(identity, glm::radians(180.0f), glm::vec3{ 0.0f, 1.0f, 0.0f });
+		check(all(turned, back, common::MeshletVisibility::visible), "the cone turns with the model");
+		check(all(turned, front, common::MeshletVisibility::backfacing), "a turned model is culled from its old front");
+
+		// scaled and moved, the bounds move along
+		const auto placed = glm::scale(glm::translate(identity, glm::vec3{ 0.0f, 0.0f, -20.0f }), glm::vec3{ 2.0f });
+		check(all(placed, front, common::MeshletVisibility::visible), "a placed model is visible in front of the viewer");
+		check(all(placed, glm::vec3{ 0.0f, 0.0f, -40.0f }, common::MeshletVisibility::backfacing), "a placed model is culled from behind");
+
+		const auto away = glm::translate(identity, glm::vec3{ 500.0f, 0.0f, 0.0f });
+		check(all(away, front, common::MeshletVisibility::outside), "meshlets outside the frustum are outside");
+
+		// viewed edge on, the cone cannot rule the triangles out
+		check(all(identity, glm::vec3{ 10.0f, 0.0f, 0.0f }, common::MeshletVisibility::visible), "meshlets seen edge on are visible");
+	}
+
+	// The faces of a cube point every way, so no cone holds them.
+	void testWideCone()
+	{
+		const glm::vec3 positions[] = {
+			{ -1, -1, -1 }, { 1, -1, -1 }, { 1, 1, -1 }, { -1, 1, -1 },
+			{ -1, -1, 1 }, { 1, -1, 1 }, { 1, 1, 1 }, { -1, 1, 1 },
+		};
+		const uint32_t indices[] = {
+			4, 5, 6, 4, 6, 7,   1, 0, 3, 1, 3, 2,
+			5, 1, 2, 5, 2, 6,   0, 4, 7, 0, 7, 3,
+			7, 6, 2, 7, 2, 3,   0, 1, 5, 0, 5, 4,
+		};
+
+		const auto mesh = common::buildMeshlets(positions, sizeof(glm::vec3), 8, indices, 36);
+		check(mesh.meshlets.size() == 1, "the cube fits one meshlet");
+		check(mesh.meshlets[0].coneCutoff == 1.0f, "normals spread all around get no cone");
+
+		const glm::vec3 eye{ 0.0f, 0.0f, -10.0f };
+		check(common::cullMeshlet(mesh.meshlets[0], glm::mat4{ 1.0f }, eye, frustumAt(eye, glm::vec3{ 0.0f })) == common::MeshletVisibility::visible,
+			"a meshlet without a cone is never backface culled");
+	}
+}
+
+int main()
+{
+	testLimits();
+	testInvalidInput();
+	testConeCulling();
+	testWideCone();
+
+	if (failures)
+	{
+		cerr << failures << " checks failed" << endl;
+		return 1;
+	}
+
+	cout << "all checks passed" << endl;
+	return 0;
+}
\ No newline at end of file
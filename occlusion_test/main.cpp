@@ -0,0 +1,183 @@
+#include <occlusion.hpp>
+#include <jobs.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <vector>
+using namespace std;
+
+// Checks OcclusionCuller on the CPU alone, no GL context needed. The camera
+// sits at the origin looking down -z; the occluder is a quad at z = -5 that
+// covers the middle 80% of the screen, the occludees sit around z = -20.
+// Exits with 1 if any check failed.
+
+namespace {
+
+	int failures = 0;
+
+	void check(bool condition, const char* what)
+	{
+		if (!condition)
+		{
+			cerr << "FAILED: " << what << endl;
+			++failures;
+		}
+	}
+
+	const glm::mat4 projection = glm::perspective(glm::radians(60.0f), 2.0f, 0.1f, 100.0f);
+
+	const uint32_t quad_indices[] = { 0, 1, 2, 0, 2, 3 };
+
+	void addQuad(common::OcclusionCuller& culler, float x0, float y0, float x1, float y1, float z)
+	{
+		const glm::vec3 vertices[] = { { x0, y0, z }, { x1, y0, z }, { x1, y1, z }, { x0, y1, z } };
+		culler.addOccluder(vertices, 4, quad_indices, 6, glm::mat4{ 1.0f });
+	}
+
+	common::Aabb box(glm::vec3 center, glm::vec3 halfExtent)
+	{
+		return { center - halfExtent, center + halfExtent };
+	}
+
+	void testOccludees()
+	{
+		common::OcclusionCuller culler{ 256, 128 };
+		culler.beginFrame(projection);
+		addQuad(culler, -4.6f, -2.3f, 4.6f, 2.3f, -5.0f);
+		culler.rasterize();
+
+		check(culler.triangleCount() == 2, "both occluder triangles are kept");
+		check(!culler.isVisible(box({ 0.0f, 0.0f, -20.0f }, glm::vec3{ 1.0f })), "box behind the occluder is hidden");
+		check(culler.isVisible(box({ 19.0f, 0.0f, -20.0f }, glm::vec3{ 3.0f, 1.0f, 1.0f })), "box reaching past the occluder's edge is visible");
+		check(culler.isVisible(box({ 0.0f, 0.0f, -3.0f }, glm::vec3{ 0.5f })), "box in front of the occluder is visible");
+		check(culler.isVisible(box({ 0.0f, 0.0f, 0.0f }, glm::vec3{ 1.0f })), "box around the eye is visible");
+		check(culler.isVisible(box({ 0.0f, 0.0f, -0.1f }, glm::vec3{ 0.5f, 0.5f, 0.08f })), "box crossing the near plane is visible");
+		check(!culler.isVisible(box({ 0.0f, 0.0f, 5.0f }, glm::vec3{ 1.0f })), "box behind the eye is hidden");
+		check(!culler.isVisible(box({ 100.0f, 0.0f, -20.0f }, glm::vec3{ 1.0f })), "box outside the viewport is hidden");
+	}
+
+	void testLevelSelection()
+	{
+		common::OcclusionCuller culler{ 256, 128 };
+		culler.beginFrame(projection);
+		addQuad(culler, -4.6f, -2.3f, 4.6f, 2.3f, -5.0f);
+		culler.rasterize();
+
+		check(culler.levelCount() == 9, "a 256x128 buffer has 9 levels");
+
+		// every texel holds the farthest depth of the four below it
+		auto pyramidOk = true;
+		for (size_t level = 1; level < culler.levelCount(); ++level)
+		{
+			const auto& fine = culler.depth(level - 1);
+			const auto& coarse = culler.depth(level);
+			const auto fineWidth = max(1, culler.width() >> (level - 1));
+			const auto width = max(1, culler.width() >> level);
+			const auto height = max(1, culler.height() >> level);
+			const auto fineHeight = max(1, culler.height() >> (level - 1));
+
+			for (auto y = 0; y < height; ++y)
+				for (auto x = 0; x < width; ++x)
+				{
+					auto farthest = 0.0f;
+					for (auto dy = 0; dy < 2; ++dy)
+						for (auto dx = 0; dx < 2; ++dx)
+							farthest = max(farthest, fine[min(2 * y + dy, fineHeight - 1) * fineWidth + min(2 * x + dx, fineWidth - 1)]);
+
+					pyramidOk = pyramidOk && coarse[y * width + x] == farthest;
+				}
+		}
+		check(pyramidOk, "each Hi-Z level is the max of the one below");
+
+		// From a few pixels to a fifth of the screen wide: a level too coarse
+		// would reach the uncovered border and keep these.
+		for (auto halfExtent : { 0.1f, 0.5f, 1.0f, 2.0f, 4.0f })
+			check(!culler.isVisible(box({ 0.0f, 0.0f, -20.0f }, glm::vec3{ halfExtent })), "hidden box of any size is hidden");
+
+		// Texels of the chosen level must cover the whole rectangle: one
+		// column of pixels past the occluder keeps a box at any size.
+		const auto edgeX = 0.8f * 20.0f * 2.0f * tan(glm::radians(30.0f));
+		const auto edgeY = 0.8f * 20.0f * tan(glm::radians(30.0f));
+		for (auto width : { 0.5f, 1.0f, 3.0f, 8.0f })
+		{
+			check(culler.isVisible(common::Aabb{ { edgeX - width, -0.5f, -20.5f }, { edgeX + 0.3f, 0.5f, -19.5f } }), "box a sliver past the right edge is visible");
+			check(culler.isVisible(common::Aabb{ { -edgeX - 0.3f, -0.5f, -20.5f }, { -edgeX + width, 0.5f, -19.5f } }), "box a sliver past the left edge is visible");
+			check(culler.isVisible(common::Aabb{ { -0.5f, edgeY - width, -20.5f }, { 0.5f, edgeY + 0.3f, -19.5f } }), "box a sliver past the top edge is visible");
+			check(culler.isVisible(common::Aabb{ { -0.5f, -edgeY - 0.3f, -20.5f }, { 0.5f, -edgeY + width, -19.5f } }), "box a sliver past the bottom edge is visible");
+		}
+	}
+
+	void testHugeCoordinates()
+	{
+		common::OcclusionCuller culler{ 256, 128 };
+
+		// x lands far outside the int range, which used to be converted as is
+		glm::mat4 stretch{ 1.0f };
+		stretch[0][0] = 1e30f;
+		culler.beginFrame(stretch);
+
+		const glm::vec3 vertices[] = { { -10.0f, -10.0f, 0.0f }, { 10.0f, -10.0f, 0.0f }, { 0.0f, 10.0f, 0.0f } };
+		const uint32_t indices[] = { 0, 1, 2 };
+		culler.addOccluder(vertices, 3, indices, 3, glm::mat4{ 1.0f });
+		culler.rasterize();
+
+		check(culler.triangleCount() == 1, "huge triangle is kept");
+		check(culler.depth()[64 * culler.width() + 128] == 0.5f, "huge triangle covers the middle of the screen");
+
+		const auto nan = numeric_limits<float>::quiet_NaN();
+		const glm::vec3 broken[] = { { nan, 0.0f, 0.0f }, { 1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f } };
+		culler.beginFrame(projection);
+		culler.addOccluder(broken, 3, indices, 3, glm::mat4{ 1.0f });
+		culler.rasterize();
+
+		check(culler.triangleCount() == 0, "triangle with a NaN vertex is dropped");
+
+		// only has to come back; either answer will do
+		culler.isVisible(common::Aabb{ { nan, nan, nan }, { 1.0f, 1.0f, -20.0f } });
+	}
+
+	void testJobs()
+	{
+		// enough triangles to be spread over jobs
+		auto fill = [](common::OcclusionCuller& culler)
+		{
+			culler.beginFrame(projection);
+			for (auto y = 0; y < 16; ++y)
+				for (auto x = 0; x < 16; ++x)
+				{
+					const auto x0 = -8.0f + x, y0 = -4.0f + y * 0.5f;
+					addQuad(culler, x0, y0, x0 + 0.9f, y0 + 0.45f, -6.0f - 0.25f * ((x + y) % 4));
+				}
+			culler.rasterize();
+		};
+
+		common::JobSystem jobs{ 4 };
+		common::OcclusionCuller serial{ 256, 128 };
+		common::OcclusionCuller parallel{ 256, 128, &jobs };
+		fill(serial);
+		fill(parallel);
+
+		check(parallel.triangleCount() == 512, "every grid triangle is kept");
+		for (size_t level = 0; level < serial.levelCount(); ++level)
+			check(serial.depth(level) == parallel.depth(level), "rasterizing on jobs matches the calling thread");
+	}
+}
+
+int main()
+{
+	testOccludees();
+	testLevelSelection();
+	testHugeCoordinates();
+	testJobs();
+
+	if (failures)
+	{
+		cerr << failures << " checks failed" << endl;
+		return 1;
+	}
+
+	cout << "all checks passed" << endl;
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,109 @@
+#include <radix_sort.hpp>
+#include <jobs.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+using namespace std;
+
+// Checks radixSort against std::stable_sort on random 64-bit keys, on the
+// calling thread and on jobs, with sizes on both sides of the point where
+// it starts splitting passes across threads. Exits with 1 if any check
+// failed.
+
+namespace {
+
+	int failures = 0;
+
+	void check(bool condition, const char* what)
+	{
+		if (!condition)
+		{
+			cerr << "FAILED: " << what << endl;
+			++failures;
+		}
+	}
+
+	// radixSort is stable, so the indices have to match too
+	bool sortsLikeStd(vector<common::SortItem> items, common::JobSystem* jobs)
+	{
+		auto expected = items;
+		stable_sort(begin(expected), end(expected), [](const common::SortItem& a, const common::SortItem& b)
+		{
+			return a.key < b.key;
+		});
+
+		vector<common::SortItem> scratch;
+		common::radixSort(items, scratch, jobs);
+
+		return equal(begin(items), end(items), begin(expected), end(expected), [](const common::SortItem& a, const common::SortItem& b)
+		{
+			return a.key == b.key && a.index == b.index;
+		});
+	}
+
+	vector<common::SortItem> makeItems(size_t count, mt19937_64& rng, uint64_t keyMask)
+	{
+		vector<common::SortItem> items(count);
+		for (size_t i = 0; i < count; ++i)
+			items[i] = { rng() & keyMask, static_cast<uint32_t>(i) };
+		return items;
+	}
+
+	void testSizes(common::JobSystem& jobs)
+	{
+		mt19937_64 rng{ 7 };
+
+		// the parallel passes start at 16384 items
+		const size_t sizes[] = { 0, 1, 2, 3, 100, 4096, 16383, 16384, 16385, 100000, 300001 };
+
+		for (const auto size : sizes)
+		{
+			const auto items = makeItems(size, rng, ~uint64_t{ 0 });
+			check(sortsLikeStd(items, nullptr), "random keys sort like std on the calling thread");
+			check(sortsLikeStd(items, &jobs), "random keys sort like std on jobs");
+		}
+	}
+
+	void testKeyShapes(common::JobSystem& jobs)
+	{
+		mt19937_64 rng{ 11 };
+
+		for (const size_t size : { size_t{ 1000 }, size_t{ 50000 } })
+		{
+			// few distinct keys, so stability matters
+			auto items = makeItems(size, rng, 0x0300'0000'0000'0007);
+			check(sortsLikeStd(items, nullptr), "duplicate keys keep their order on the calling thread");
+			check(sortsLikeStd(items, &jobs), "duplicate keys keep their order on jobs");
+
+			// only the top byte varies, the other passes are skipped
+			items = makeItems(size, rng, 0xff00'0000'0000'0000);
+			check(sortsLikeStd(items, &jobs), "keys varying in the top byte only sort like std");
+
+			// nothing varies, every pass is skipped
+			items = makeItems(size, rng, 0);
+			for (auto& item : items)
+				item.key = 0x1234'5678'9abc'def0;
+			check(sortsLikeStd(items, &jobs), "equal keys are left in input order");
+		}
+	}
+}
+
+int main()
+{
+	common::JobSystem jobs{ 4 };
+
+	testSizes(jobs);
+	testKeyShapes(jobs);
+
+	if (failures)
+	{
+		cerr << failures << " checks failed" << endl;
+		return 1;
+	}
+
+	cout << "all checks passed" << endl;
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,19 @@
+#version 430 core
+layout (location = 0) in vec4 pos;
+layout (location = 15) in uint drawIndex;
+
+struct DrawData {
+    mat4 model;
+    uvec4 params;
+};
+
+layout (std430, binding = 0) readonly buffer DrawBuffer {
+    DrawData draws[];
+};
+
+uniform mat4 viewProjection;
+
+void main()
+{
+    gl_Position = viewProjection * draws[drawIndex].model * pos;
+}
\ No newline at end of file
@@ -0,0 +1,10 @@
+#version 430 core
+layout (location = 0) in vec4 pos;
+
+uniform mat4 model;
+uniform mat4 viewProjection;
+
+void main()
+{
+    gl_Position = viewProjection * model * pos;
+}
\ No newline at end of file
@@ -0,0 +1,9 @@
+#version 430 core
+
+uniform mat4 viewProjection;
+
+void main()
+{
+    PulledVertex v = pullVertex();
+    gl_Position = viewProjection * pulledModel() * vec4(v.location0.xyz, 1.0);
+}
\ No newline at end of file
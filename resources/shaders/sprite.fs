@@ -0,0 +1,12 @@
+#version 430 core
+out vec4 color;
+
+in vec3 texCoord;
+in vec4 tint;
+
+uniform sampler2DArray atlas;
+
+void main()
+{
+    color = texture(atlas, texCoord) * tint;
+}
\ No newline at end of file
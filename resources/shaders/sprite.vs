@@ -0,0 +1,25 @@
+#version 430 core
+layout (location = 0) in vec4 rect;
+layout (location = 1) in vec4 uvRect;
+layout (location = 2) in vec4 color;
+layout (location = 3) in vec2 rotationLayer;
+
+uniform mat4 projection;
+
+out vec3 texCoord;
+out vec4 tint;
+
+void main()
+{
+    // triangle strip corners (0, 0), (1, 0), (0, 1), (1, 1)
+    vec2 corner = vec2(gl_VertexID & 1, gl_VertexID >> 1);
+    vec2 local = (corner - 0.5) * rect.zw;
+
+    float s = sin(rotationLayer.x);
+    float c = cos(rotationLayer.x);
+    vec2 position = rect.xy + vec2(c * local.x - s * local.y, s * local.x + c * local.y);
+
+    gl_Position = projection * vec4(position, 0.0, 1.0);
+    texCoord = vec3(mix(uvRect.xy, uvRect.zw, corner), rotationLayer.y);
+    tint = color;
+}
\ No newline at end of file
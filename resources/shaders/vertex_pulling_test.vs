@@ -0,0 +1,23 @@
+#version 430 core
+
+// Writes what pullVertex() decoded to results, five locations per vertex,
+// max_vertices vertices per draw.
+const uint max_vertices = 4u;
+
+layout (std430, binding = 2) writeonly buffer Results {
+    vec4 results[];
+};
+
+void main()
+{
+    PulledVertex v = pullVertex();
+    uint slot = (pulledDrawIndex * max_vertices + uint(gl_VertexID)) * 5u;
+
+    results[slot] = v.location0;
+    results[slot + 1u] = v.location1;
+    results[slot + 2u] = v.location2;
+    results[slot + 3u] = v.location3;
+    results[slot + 4u] = v.location4;
+
+    gl_Position = vec4(0.0, 0.0, 0.0, 1.0);
+}
\ No newline at end of file
@@ -0,0 +1,227 @@
+#include <spatial_hash.hpp>
+#include <jobs.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <vector>
+using namespace std;
+
+// Checks SpatialHash on its own: queries across cell borders, moves,
+// removal and the broad phase on jobs against a brute force search.
+// Exits with 1 if any check failed.
+
+namespace {
+
+	using Handle = common::SpatialHash::Handle;
+
+	int failures = 0;
+
+	void check(bool condition, const char* what)
+	{
+		if (!condition)
+		{
+			cerr << "FAILED: " << what << endl;
+			++failures;
+		}
+	}
+
+	common::Aabb box(glm::vec3 center, glm::vec3 halfExtent)
+	{
+		return { center - halfExtent, center + halfExtent };
+	}
+
+	bool found(const vector<Handle>& handles, Handle handle)
+	{
+		return find(begin(handles), end(handles), handle) != end(handles);
+	}
+
+	void testQueries()
+	{
+		common::SpatialHash hash{ 1.0f, 64 };
+		vector<Handle> handles;
+
+		// filed in the cell left of x = 1, reaching into the one right of it
+		const auto a = hash.insert(box({ 0.95f, 0.5f, 0.5f }, glm::vec3{ 0.1f }), 7);
+		const auto b = hash.insert(box({ 3.5f, 0.5f, 0.5f }, glm::vec3{ 0.1f }));
+
+		check(hash.size() == 2, "two objects inserted");
+		check(hash.userData(a) == 7, "user data is kept");
+
+		hash.query(box({ 1.08f, 0.5f, 0.5f }, glm::vec3{ 0.05f }), handles);
+		check(handles.size() == 1 && handles[0] == a, "query across a cell border finds the object");
+
+		hash.query(box({ 1.3f, 0.5f, 0.5f }, glm::vec3{ 0.05f }), handles);
+		check(handles.empty(), "query next to the object finds nothing");
+
+		hash.query(box({ 2.0f, 0.5f, 0.5f }, glm::vec3{ 2.0f }), handles);
+		check(handles.size() == 2 && found(handles, a) && found(handles, b), "query over many cells finds both");
+
+		hash.query(box({ -1000.0f, 0.5f, 0.5f }, glm::vec3{ 0.5f }), handles);
+		check(handles.empty(), "far query finds nothing");
+
+		// the same bucket is reached from many cells, each object still comes once
+		common::SpatialHash small{ 1.0f, 2 };
+		small.insert(box({ 0.5f, 0.5f, 0.5f }, glm::vec3{ 0.1f }));
+		small.query(box({ 0.5f, 0.5f, 0.5f }, glm::vec3{ 0.6f }), handles);
+		check(handles.size() == 1, "shared buckets do not repeat objects");
+	}
+
+	void testUpdates()
+	{
+		common::SpatialHash hash{ 1.0f, 64 };
+		vector<Handle> handles;
+
+		const auto a = hash.insert(box({ 0.5f, 0.5f, 0.5f }, glm::vec3{ 0.2f }));
+
+		hash.update(a, box({ 10.5f, 0.5f, 0.5f }, glm::vec3{ 0.2f }));
+		hash.query(box({ 0.5f, 0.5f, 0.5f }, glm::vec3{ 0.3f }), handles);
+		check(handles.empty(), "update leaves the old place");
+		hash.query(box({ 10.5f, 0.5f, 0.5f }, glm::vec3{ 0.3f }), handles);
+		check(found(handles, a), "update reaches the new place");
+
+		hash.queueUpdate(a, box({ -5.5f, 2.5f, 0.5f }, glm::vec3{ 0.2f }));
+		hash.query(box({ -5.5f, 2.5f, 0.5f }, glm::vec3{ 0.3f }), handles);
+		check(handles.empty(), "a queued move waits for the flush");
+		hash.flushUpdates();
+		hash.query(box({ -5.5f, 2.5f, 0.5f }, glm::vec3{ 0.3f }), handles);
+		check(found(handles, a), "flushUpdates applies the move");
+
+		// the widening has to shrink back once the big object has left
+		const auto big = hash.insert(box({ 50.0f, 0.0f, 0.0f }, glm::vec3{ 40.0f }));
+		hash.query(box({ 20.0f, 0.0f, 0.0f }, glm::vec3{ 0.1f }), handles);
+		check(found(handles, big), "a big object is found far from its cell");
+		hash.remove(big);
+		hash.flushUpdates();
+		hash.query(box({ 20.0f, 0.0f, 0.0f }, glm::vec3{ 0.1f }), handles);
+		check(handles.empty(), "a removed big object is gone");
+		hash.query(box({ -5.5f, 2.5f, 0.5f }, glm::vec3{ 0.3f }), handles);
+		check(found(handles, a), "objects are still found after the widening shrank");
+	}
+
+	void testRemoval()
+	{
+		common::SpatialHash hash{ 1.0f, 64 };
+		vector<Handle> handles;
+
+		const auto a = hash.insert(box({ 0.5f, 0.5f, 0.5f }, glm::vec3{ 0.2f }));
+		const auto b = hash.insert(box({ 0.6f, 0.5f, 0.5f }, glm::vec3{ 0.2f }));
+
+		hash.queueUpdate(a, box({ 5.5f, 0.5f, 0.5f }, glm::vec3{ 0.2f }));
+		hash.remove(a);
+		hash.flushUpdates();
+		check(hash.size() == 1, "remove takes the object out");
+
+		hash.query(box({ 0.5f, 0.5f, 0.5f }, glm::vec3{ 0.3f }), handles);
+		check(handles.size() == 1 && handles[0] == b, "a removed object is not found");
+		hash.query(box({ 5.5f, 0.5f, 0.5f }, glm::vec3{ 0.3f }), handles);
+		check(handles.empty(), "a queued move does not bring a removed object back");
+
+		hash.remove(a);
+		check(hash.size() == 1, "removing twice does nothing");
+
+		const auto c = hash.insert(box({ 2.5f, 0.5f, 0.5f }, glm::vec3{ 0.2f }));
+		const auto d = hash.insert(box({ 3.5f, 0.5f, 0.5f }, glm::vec3{ 0.2f }));
+		check(c != d && c != b && d != b, "a handle removed twice is handed out once");
+
+		auto threw = false;
+		try
+		{
+			const auto e = hash.insert(box({ 4.5f, 0.5f, 0.5f }, glm::vec3{ 0.2f }));
+			hash.remove(e);
+			hash.update(e, box({ 0.5f, 0.5f, 0.5f }, glm::vec3{ 0.2f }));
+		}
+		catch (const invalid_argument&)
+		{
+			threw = true;
+		}
+		check(threw, "updating a removed handle throws");
+	}
+
+	void testHugeCoordinates()
+	{
+		common::SpatialHash hash{ 1.0f, 64 };
+		vector<Handle> handles;
+
+		const auto far = hash.insert(box(glm::vec3{ 1e30f }, glm::vec3{ 1.0f }));
+		const auto near = hash.insert(box(glm::vec3{ 0.5f }, glm::vec3{ 0.2f }));
+
+		hash.query(box(glm::vec3{ 1e30f }, glm::vec3{ 1.0f }), handles);
+		check(found(handles, far) && !found(handles, near), "an object far out is found");
+
+		const auto inf = numeric_limits<float>::infinity();
+		hash.query({ glm::vec3{ -inf }, glm::vec3{ inf } }, handles);
+		check(handles.size() == 2, "an infinite query finds everything");
+
+		const auto nan = numeric_limits<float>::quiet_NaN();
+		hash.query({ glm::vec3{ nan }, glm::vec3{ nan } }, handles);
+		check(handles.empty(), "a NaN query finds nothing");
+	}
+
+	void testPairs()
+	{
+		mt19937 rng{ 5 };
+		uniform_real_distribution<float> position{ -40.0f, 40.0f };
+		uniform_real_distribution<float> extent{ 0.1f, 1.5f };
+
+		common::JobSystem jobs{ 4 };
+		common::SpatialHash serial{ 2.0f, 1024 };
+		common::SpatialHash parallel{ 2.0f, 1024, &jobs };
+
+		vector<common::Aabb> boxes;
+		for (int i = 0; i < 3000; ++i)
+		{
+			boxes.push_back(box({ position(rng), position(rng), position(rng) }, glm::vec3{ extent(rng) }));
+			serial.insert(boxes.back());
+			parallel.insert(boxes.back());
+		}
+
+		for (Handle h = 0; h < 3000; h += 7)
+		{
+			serial.remove(h);
+			parallel.remove(h);
+		}
+
+		vector<common::SpatialHash::Pair> expected;
+		for (Handle a = 0; a < boxes.size(); ++a)
+		{
+			for (Handle b = a + 1; b < boxes.size(); ++b)
+			{
+				if (a % 7 && b % 7 && boxes[a].overlaps(boxes[b]))
+					expected.emplace_back(a, b);
+			}
+		}
+
+		vector<common::SpatialHash::Pair> pairs;
+		serial.findPairs(pairs);
+		check(!expected.empty(), "the scene has overlapping pairs");
+		check(pairs == expected, "findPairs on the calling thread matches brute force");
+
+		parallel.findPairs(pairs);
+		check(pairs == expected, "findPairs on jobs matches brute force");
+
+		parallel.findPairs(pairs);
+		check(pairs == expected, "findPairs gives the same pairs a second time");
+	}
+}
+
+int main()
+{
+	testQueries();
+	testUpdates();
+	testRemoval();
+	testHugeCoordinates();
+	testPairs();
+
+	if (failures)
+	{
+		cerr << failures << " checks failed" << endl;
+		return 1;
+	}
+
+	cout << "all checks passed" << endl;
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,246 @@
+#include <glsl.hpp>
+#include <app_context.hpp>
+#include <vertex_pulling.hpp>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+using namespace std;
+
+// Checks the shader vertexPullingSource() generates: three formats that
+// between them use every supported attribute type are pulled by a vertex
+// shader that writes the decoded values to an SSBO, which is compared with
+// the values the vertices were made from. Needs a GL 4.5 context; ctest
+// runs it headless on llvmpipe. Exits with 1 if any check failed.
+
+namespace {
+
+	constexpr uint32_t vertex_count = 4;      // max_vertices in the shader
+	constexpr uint32_t location_count = 5;
+
+	int failures = 0;
+
+	void check(bool condition, const char* what)
+	{
+		if (!condition)
+		{
+			cerr << "FAILED: " << what << endl;
+			++failures;
+		}
+	}
+
+	using Expected = vector<glm::vec4>;        // location_count per vertex
+
+	struct Format {
+		glsl::VertexLayout layout;
+		vector<unsigned char> vertices;
+		Expected expected;
+	};
+
+	template <typename T>
+	void put(vector<unsigned char>& bytes, size_t offset, T value)
+	{
+		memcpy(bytes.data() + offset, &value, sizeof(value));
+	}
+
+	Expected defaults()
+	{
+		return Expected(vertex_count * location_count, glm::vec4{ 0.0f, 0.0f, 0.0f, 1.0f });
+	}
+
+	// Plain floats at location 0 only.
+	Format floats()
+	{
+		Format f{ { 12, { { 0, 3, GL_FLOAT, 0 } } }, vector<unsigned char>(12 * vertex_count), defaults() };
+		for (uint32_t v = 0; v < vertex_count; ++v)
+		{
+			const glm::vec3 position{ float(v), -0.5f * v, 3.25f };
+			memcpy(f.vertices.data() + v * 12, &position, sizeof(position));
+			f.expected[v * location_count] = glm::vec4{ position, 1.0f };
+		}
+		return f;
+	}
+
+	// Half floats and 8/16-bit integers, normalized or not, at byte offsets
+	// that are not word aligned.
+	Format packed()
+	{
+		Format f{ { 20, {
+			{ 0, 2, GL_HALF_FLOAT, 0 },
+			{ 1, 4, GL_UNSIGNED_BYTE, 4, true },
+			{ 2, 2, GL_SHORT, 8, true },
+			{ 3, 3, GL_BYTE, 12 },
+			{ 4, 1, GL_UNSIGNED_SHORT, 18 },
+		} }, vector<unsigned char>(20 * vertex_count), defaults() };
+
+		for (uint32_t v = 0; v < vertex_count; ++v)
+		{
+			const auto at = v * 20;
+			const auto e = f.expected.begin() + v * location_count;
+
+			put<uint16_t>(f.vertices, at, 0x3800);                              // 0.5
+			put<uint16_t>(f.vertices, at + 2, v % 2 ? 0xc000 : 0x4200);        // -2 or 3
+			e[0] = { 0.5f, v % 2 ? -2.0f : 3.0f, 0.0f, 1.0f };
+
+			const unsigned char bytes[] = { 0, 51, 255, static_cast<unsigned char>(v) };
+			memcpy(f.vertices.data() + at + 4, bytes, 4);
+			e[1] = { 0.0f, 51 / 255.0f, 1.0f, v / 255.0f };
+
+			put<int16_t>(f.vertices, at + 8, -32768);                           // clamps to -1
+			put<int16_t>(f.vertices, at + 10, 16384);
+			e[2] = { -1.0f, 16384 / 32767.0f, 0.0f, 1.0f };
+
+			const signed char chars[] = { static_cast<signed char>(-5 - int(v)), 7, -128 };
+			memcpy(f.vertices.data() + at + 12, chars, 3);
+			e[3] = { -5.0f - v, 7.0f, -128.0f, 1.0f };
+
+			put<uint16_t>(f.vertices, at + 18, static_cast<uint16_t>(65535 - v));
+			e[4] = { 65535.0f - v, 0.0f, 0.0f, 1.0f };
+		}
+		return f;
+	}
+
+	// 32-bit integers and a float past them, locations 0 and 1 left out.
+	Format wide()
+	{
+		Format f{ { 12, {
+			{ 2, 1, GL_INT, 0 },
+			{ 3, 1, GL_UNSIGNED_INT, 4 },
+			{ 4, 1, GL_FLOAT, 8 },
+		} }, vector<unsigned char>(12 * vertex_count), defaults() };
+
+		for (uint32_t v = 0; v < vertex_count; ++v)
+		{
+			const auto at = v * 12;
+			const auto e = f.expected.begin() + v * location_count;
+
+			put<int32_t>(f.vertices, at, -100000 - int32_t(v));
+			put<uint32_t>(f.vertices, at + 4, 3000000000u);
+			put<float>(f.vertices, at + 8, 1.5f * v);
+
+			e[2] = { -100000.0f - v, 0.0f, 0.0f, 1.0f };
+			e[3] = { 3000000000.0f, 0.0f, 0.0f, 1.0f };
+			e[4] = { 1.5f * v, 0.0f, 0.0f, 1.0f };
+		}
+		return f;
+	}
+
+	bool close(const glm::vec4& a, const glm::vec4& b)
+	{
+		for (int i = 0; i < 4; ++i)
+		{
+			if (abs(a[i] - b[i]) > 1e-6f * max(1.0f, abs(b[i])))
+				return false;
+		}
+		return true;
+	}
+
+	void testRejectedLayouts()
+	{
+		auto throws = [](glsl::VertexLayout layout)
+		{
+			try
+			{
+				glsl::vertexPullingSource({ layout });
+			}
+			catch (const invalid_argument&)
+			{
+				return true;
+			}
+			return false;
+		};
+
+		check(throws({ 10, { { 0, 2, GL_FLOAT, 0 } } }), "a stride that is no multiple of 4 is rejected");
+		check(throws({ 8, { { 0, 1, GL_FLOAT, 2 } } }), "a float off word alignment is rejected");
+		check(throws({ 8, { { 0, 3, GL_FLOAT, 0 } } }), "an attribute past the stride is rejected");
+		check(throws({ 8, { { 0, 1, GL_DOUBLE, 0 } } }), "doubles are rejected");
+		check(throws({ 4, { { 0, 1, GL_INT, 0, true } } }), "normalized 32-bit integers are rejected");
+		check(throws({ 20, { { 0, 5, GL_FLOAT, 0 } } }), "more than four components are rejected");
+	}
+
+	void testDecode()
+	{
+		const Format formats[] = { floats(), packed(), wide() };
+
+		vector<glsl::VertexLayout> layouts;
+		for (const auto& f : formats)
+			layouts.push_back(f.layout);
+
+		glsl::PulledGeometry geometry{ layouts, 1 << 10, 1 << 10 };
+
+		// format 0 goes first so the others start past word 0
+		const GLuint indices[vertex_count] = { 0, 1, 2, 3 };
+		vector<glsl::PulledMesh> meshes;
+		for (uint32_t f = 0; f < size(formats); ++f)
+			meshes.push_back(geometry.add(f, formats[f].vertices.data(), vertex_count, indices, vertex_count));
+
+		// fails here if the generated source does not compile on this driver
+		glsl::Program program{
+			{ glsl::vertex_shader, "resources/shaders/vertex_pulling_test.vs"s, geometry.shaderSource() }
+		};
+
+		glsl::IndirectDrawBatch batch{ 8 };
+		for (const auto& mesh : meshes)
+			geometry.addDraw(batch, mesh, glm::mat4{ 1.0f });
+		batch.upload();
+
+		const vector<glm::vec4> cleared(size(formats) * vertex_count * location_count, glm::vec4{ -7.0f });
+		glsl::Buffer results{ cleared, GL_DYNAMIC_STORAGE_BIT };
+		results.bindBase(GL_SHADER_STORAGE_BUFFER, 2);
+
+		auto& state = glsl::GLState::current();
+		state.enable(GL_RASTERIZER_DISCARD);
+		program.use();
+		geometry.bind();
+		batch.submit(geometry.vertexArray(), GL_POINTS);
+		state.disable(GL_RASTERIZER_DISCARD);
+
+		glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+		vector<glm::vec4> decoded(cleared.size());
+		glGetNamedBufferSubData(results, 0, static_cast<GLsizeiptr>(decoded.size() * sizeof(glm::vec4)), decoded.data());
+
+		const char* const what[] = {
+			"floats decode as written",
+			"half floats and 8/16-bit integers decode as written",
+			"32-bit integers decode as written, missing locations as (0, 0, 0, 1)",
+		};
+
+		for (size_t f = 0; f < size(formats); ++f)
+		{
+			auto matches = true;
+			for (size_t i = 0; i < formats[f].expected.size(); ++i)
+				matches = matches && close(decoded[f * vertex_count * location_count + i], formats[f].expected[i]);
+
+			check(matches, what[f]);
+		}
+	}
+}
+
+int main(int argc, char** argv)
+try
+{
+	testRejectedLayouts();
+
+	auto options = glsl::ContextOptions::fromCommandLine(argc, argv, { 64, 64, "vertex pulling test", 4, 5 });
+	options.visible = false;
+	glsl::AppContext context{ options };
+
+	testDecode();
+
+	if (failures)
+	{
+		cerr << failures << " checks failed" << endl;
+		return 1;
+	}
+
+	cout << "all checks passed" << endl;
+	return 0;
+}
+catch (const exception& e)
+{
+	cerr << e.what() << endl;
+	return 1;
+}
\ No newline at end of file